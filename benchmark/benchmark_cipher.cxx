@@ -44,11 +44,25 @@
 #include "benchpress.hpp"
 
 #include <functional>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilKeyPair.h>
 #include <virgil/crypto/VirgilCipher.h>
+#include <virgil/crypto/VirgilBatchCipher.h>
+#include <virgil/crypto/VirgilChunkCipher.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+#include <chrono>
+#include <thread>
+
+#include <virgil/crypto/VirgilStreamCipher.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#include <virgil/crypto/stream/VirgilBytesDataSink.h>
+#include <virgil/crypto/stream/VirgilPrefetchingDataSource.h>
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
 
 using std::placeholders::_1;
 
@@ -56,6 +70,9 @@ using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilKeyPair;
 using virgil::crypto::VirgilCipher;
+using virgil::crypto::VirgilBatchCipher;
+using virgil::crypto::VirgilChunkCipher;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 void benchmark_encrypt(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
     VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be encrypted");
@@ -117,3 +134,181 @@ BENCHMARK("Decrypt -> 512-bits Brainpool curve", std::bind(benchmark_decrypt, _1
 BENCHMARK("Decrypt -> 192-bits 'Koblitz' curve", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::EC_SECP192K1));
 BENCHMARK("Decrypt -> 224-bits 'Koblitz' curve", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::EC_SECP224K1));
 BENCHMARK("Decrypt -> 256-bits 'Koblitz' curve", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::EC_SECP256K1));
+
+void benchmark_encrypt_large(
+        benchpress::context* ctx, size_t dataSize, bool useCallerBuffer,
+        VirgilSymmetricCipher::Algorithm algorithm) {
+    VirgilByteArray testData(dataSize, 0xAB);
+    VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilByteArray encryptedData;
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.setContentEncryptionAlgorithm(algorithm);
+        if (useCallerBuffer) {
+            encryptedData.resize(cipher.defineEncryptedSize(testData.size()));
+            (void)cipher.encrypt(testData.data(), testData.size(), encryptedData.data(), encryptedData.size());
+        } else {
+            encryptedData = cipher.encrypt(testData, true);
+        }
+    }
+}
+
+BENCHMARK("Encrypt 5 MB -> returned buffer    ", std::bind(benchmark_encrypt_large, _1, 5 * 1024 * 1024, false,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM));
+BENCHMARK("Encrypt 5 MB -> caller buffer      ", std::bind(benchmark_encrypt_large, _1, 5 * 1024 * 1024, true,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM));
+BENCHMARK("Encrypt 50 MB -> returned buffer   ", std::bind(benchmark_encrypt_large, _1, 50 * 1024 * 1024, false,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM));
+BENCHMARK("Encrypt 50 MB -> caller buffer     ", std::bind(benchmark_encrypt_large, _1, 50 * 1024 * 1024, true,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM));
+BENCHMARK("Encrypt 5 MB -> ChaCha20-Poly1305  ", std::bind(benchmark_encrypt_large, _1, 5 * 1024 * 1024, true,
+        VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305));
+BENCHMARK("Encrypt 50 MB -> ChaCha20-Poly1305 ", std::bind(benchmark_encrypt_large, _1, 50 * 1024 * 1024, true,
+        VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305));
+
+void benchmark_encrypt_messages(benchpress::context* ctx, size_t threadsNum) {
+    const size_t kMessagesNum = 1000;
+    const std::vector<VirgilByteArray> messages(kMessagesNum, VirgilByteArray(64, 0xAB));
+    VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+
+    VirgilBatchCipher batchCipher;
+    batchCipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    batchCipher.setBatchThreadsNum(threadsNum);
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        if (threadsNum == 0) {
+            // One cipher per message
+            for (const auto& message : messages) {
+                VirgilCipher cipher;
+                cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+                (void)cipher.encrypt(message, true);
+            }
+        } else {
+            (void)batchCipher.encrypt(messages);
+        }
+    }
+}
+
+BENCHMARK("Encrypt 1000 messages -> per message", std::bind(benchmark_encrypt_messages, _1, 0));
+BENCHMARK("Encrypt 1000 messages -> batch      ", std::bind(benchmark_encrypt_messages, _1, 1));
+BENCHMARK("Encrypt 1000 messages -> batch x4   ", std::bind(benchmark_encrypt_messages, _1, 4));
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+using virgil::crypto::stream::VirgilBytesDataSource;
+using virgil::crypto::stream::VirgilBytesDataSink;
+using virgil::crypto::stream::VirgilPrefetchingDataSource;
+using virgil::crypto::VirgilStreamCipher;
+
+void benchmark_chunk_encrypt(benchpress::context* ctx, size_t threadsNum) {
+    const size_t kDataSize = 32 * 1024 * 1024;
+    VirgilByteArray testData(kDataSize, 0xAB);
+    VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilByteArray encryptedData;
+    encryptedData.reserve(2 * kDataSize);
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilBytesDataSource dataSource(testData, VirgilChunkCipher::kPreferredChunkSize);
+        VirgilBytesDataSink dataSink(encryptedData);
+        VirgilChunkCipher cipher;
+        cipher.setChunksThreadsNum(threadsNum);
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        encryptedData.clear();
+        cipher.encrypt(dataSource, dataSink);
+    }
+}
+
+BENCHMARK("Chunk encrypt 32 MB -> 1 thread    ", std::bind(benchmark_chunk_encrypt, _1, 1));
+BENCHMARK("Chunk encrypt 32 MB -> 2 threads   ", std::bind(benchmark_chunk_encrypt, _1, 2));
+BENCHMARK("Chunk encrypt 32 MB -> 4 threads   ", std::bind(benchmark_chunk_encrypt, _1, 4));
+BENCHMARK("Chunk encrypt 32 MB -> 8 threads   ", std::bind(benchmark_chunk_encrypt, _1, 8));
+
+void benchmark_chunk_decrypt(benchpress::context* ctx, size_t readSizeInChunks) {
+    const size_t kDataSize = 32 * 1024 * 1024;
+    const size_t kChunkSize = 4 * 1024;
+    VirgilByteArray testData(kDataSize, 0xAB);
+    VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+
+    VirgilByteArray encryptedData;
+    {
+        VirgilBytesDataSource dataSource(testData, kChunkSize);
+        VirgilBytesDataSink dataSink(encryptedData);
+        VirgilChunkCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(dataSource, dataSink, true, kChunkSize);
+    }
+    VirgilByteArray decryptedData;
+    decryptedData.reserve(kDataSize);
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilBytesDataSource dataSource(encryptedData, readSizeInChunks * kChunkSize);
+        VirgilBytesDataSink dataSink(decryptedData);
+        VirgilChunkCipher cipher;
+        decryptedData.clear();
+        cipher.decryptWithKey(dataSource, dataSink, recipientId, keyPair.privateKey());
+    }
+}
+
+BENCHMARK("Chunk decrypt 32 MB -> read 1 chunk", std::bind(benchmark_chunk_decrypt, _1, 1));
+BENCHMARK("Chunk decrypt 32 MB -> read 100 ch.", std::bind(benchmark_chunk_decrypt, _1, 100));
+
+/**
+ * @brief Emulates storage with the given latency of each read.
+ */
+class LatencyDataSource : public virgil::crypto::VirgilDataSource {
+public:
+    LatencyDataSource(const VirgilByteArray& data, size_t chunkSize, std::chrono::microseconds latency)
+            : source_(data, chunkSize), latency_(latency) {
+    }
+
+    bool hasData() override {
+        return source_.hasData();
+    }
+
+    VirgilByteArray read() override {
+        std::this_thread::sleep_for(latency_);
+        return source_.read();
+    }
+
+private:
+    VirgilBytesDataSource source_;
+    std::chrono::microseconds latency_;
+};
+
+void benchmark_stream_encrypt_with_latency(benchpress::context* ctx, bool prefetch) {
+    const size_t kDataSize = 16 * 1024 * 1024;
+    const size_t kReadSize = 64 * 1024;
+    VirgilByteArray testData(kDataSize, 0xAB);
+    VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilByteArray encryptedData;
+    encryptedData.reserve(2 * kDataSize);
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        LatencyDataSource dataSource(testData, kReadSize, std::chrono::microseconds(100));
+        VirgilBytesDataSink dataSink(encryptedData);
+        VirgilStreamCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        encryptedData.clear();
+        if (prefetch) {
+            VirgilPrefetchingDataSource prefetchingDataSource(dataSource);
+            cipher.encrypt(prefetchingDataSource, dataSink);
+        } else {
+            cipher.encrypt(dataSource, dataSink);
+        }
+    }
+}
+
+BENCHMARK("Stream encrypt 16 MB -> read latency", std::bind(benchmark_stream_encrypt_with_latency, _1, false));
+BENCHMARK("Stream encrypt 16 MB -> prefetching ", std::bind(benchmark_stream_encrypt_with_latency, _1, true));
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
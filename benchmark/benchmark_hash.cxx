@@ -44,6 +44,7 @@
 #include "benchpress.hpp"
 
 #include <functional>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
@@ -83,3 +84,51 @@ BENCHMARK("Hash -> SHA-512", [](benchpress::context* ctx){
     benchmark_hash(ctx, VirgilHash::Algorithm::SHA512);
 });
 
+
+constexpr size_t kBatchSize = 64;
+constexpr size_t kBatchMessageSize = 64;
+
+std::vector<VirgilByteArray> make_batch() {
+    VirgilRandom random(VirgilByteArrayUtils::stringToBytes("seed"));
+    std::vector<VirgilByteArray> messages;
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        messages.push_back(random.randomize(kBatchMessageSize));
+    }
+    return messages;
+}
+
+void benchmark_hash_each(benchpress::context* ctx, VirgilHash::Algorithm hashAlg) {
+    std::vector<VirgilByteArray> messages = make_batch();
+    VirgilHash hash(hashAlg);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        for (const auto& message : messages) {
+            (void)hash.hash(message);
+        }
+    }
+}
+
+void benchmark_hash_batch(benchpress::context* ctx, VirgilHash::Algorithm hashAlg) {
+    std::vector<VirgilByteArray> messages = make_batch();
+    VirgilHash hash(hashAlg);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)hash.hashBatch(messages);
+    }
+}
+
+BENCHMARK("Hash 64 x 64 bytes -> SHA-256 (one by one)", [](benchpress::context* ctx){
+    benchmark_hash_each(ctx, VirgilHash::Algorithm::SHA256);
+});
+
+BENCHMARK("Hash 64 x 64 bytes -> SHA-256 (batch)     ", [](benchpress::context* ctx){
+    benchmark_hash_batch(ctx, VirgilHash::Algorithm::SHA256);
+});
+
+BENCHMARK("Hash 64 x 64 bytes -> SHA-512 (one by one)", [](benchpress::context* ctx){
+    benchmark_hash_each(ctx, VirgilHash::Algorithm::SHA512);
+});
+
+BENCHMARK("Hash 64 x 64 bytes -> SHA-512 (batch)     ", [](benchpress::context* ctx){
+    benchmark_hash_batch(ctx, VirgilHash::Algorithm::SHA512);
+});
@@ -49,6 +49,7 @@
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilKeyPair.h>
 #include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
 
 using std::placeholders::_1;
 
@@ -56,6 +57,7 @@ using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilKeyPair;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
+using virgil::crypto::foundation::VirgilHash;
 
 void benchmark_keys_keygen(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
     VirgilAsymmetricCipher asymmetricCipher;
@@ -177,6 +179,41 @@ void benchmark_keys_private_export_pem2der_pwd(benchpress::context* ctx, const V
     }
 }
 
+void benchmark_keys_public_import_verify(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
+    auto keyPair = VirgilKeyPair::generate(keyType);
+    VirgilHash hash(VirgilHash::Algorithm::SHA384);
+    auto digest = hash.hash(VirgilByteArrayUtils::stringToBytes("data to be signed"));
+    VirgilAsymmetricCipher signer;
+    signer.setPrivateKey(keyPair.privateKey());
+    auto sign = signer.sign(digest, hash.type());
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilAsymmetricCipher verifier;
+        verifier.setPublicKey(keyPair.publicKey());
+        (void) verifier.verify(digest, sign, hash.type());
+    }
+}
+
+void benchmark_keys_private_import_sign(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
+    auto keyPair = VirgilKeyPair::generate(keyType);
+    VirgilHash hash(VirgilHash::Algorithm::SHA384);
+    auto digest = hash.hash(VirgilByteArrayUtils::stringToBytes("data to be signed"));
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilAsymmetricCipher signer;
+        signer.setPrivateKey(keyPair.privateKey());
+        (void) signer.sign(digest, hash.type());
+    }
+}
+
+void benchmark_keys_is_key_pair_match(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
+    auto keyPair = VirgilKeyPair::generate(keyType);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void) VirgilKeyPair::isKeyPairMatch(keyPair.publicKey(), keyPair.privateKey());
+    }
+}
+
 
 BENCHMARK("Generate key pair -> RSA 2048                ",
           std::bind(benchmark_keys_keygen, _1, VirgilKeyPair::Type::RSA_2048));
@@ -249,3 +286,30 @@ BENCHMARK("Export Private Key DER to PEM (with password)",
 
 BENCHMARK("Export Private Key PEM to DER (with password)",
           std::bind(benchmark_keys_private_export_pem2der_pwd, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
+
+BENCHMARK("Import Public Key and verify -> ed25519      ",
+          std::bind(benchmark_keys_public_import_verify, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
+
+BENCHMARK("Import Public Key and verify -> RSA 2048     ",
+          std::bind(benchmark_keys_public_import_verify, _1, VirgilKeyPair::Type::RSA_2048));
+
+BENCHMARK("Import Public Key and verify -> 256-bits NIST",
+          std::bind(benchmark_keys_public_import_verify, _1, VirgilKeyPair::Type::EC_SECP256R1));
+
+BENCHMARK("Import Public Key and verify -> 512-bits Brainpool",
+          std::bind(benchmark_keys_public_import_verify, _1, VirgilKeyPair::Type::EC_BP512R1));
+
+BENCHMARK("Import Private Key and sign -> ed25519       ",
+          std::bind(benchmark_keys_private_import_sign, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
+
+BENCHMARK("Import Private Key and sign -> 256-bits NIST ",
+          std::bind(benchmark_keys_private_import_sign, _1, VirgilKeyPair::Type::EC_SECP256R1));
+
+BENCHMARK("Import Private Key and sign -> 512-bits Brainpool",
+          std::bind(benchmark_keys_private_import_sign, _1, VirgilKeyPair::Type::EC_BP512R1));
+
+BENCHMARK("Import Private Key and sign -> 256-bits 'Koblitz'",
+          std::bind(benchmark_keys_private_import_sign, _1, VirgilKeyPair::Type::EC_SECP256K1));
+
+BENCHMARK("Check key pair match -> ed25519              ",
+          std::bind(benchmark_keys_is_key_pair_match, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
@@ -43,19 +43,37 @@
 #define BENCHPRESS_CONFIG_MAIN
 #include "benchpress.hpp"
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+#include <virgil/crypto/VirgilPublicKeyCache.h>
 #include <virgil/crypto/VirgilSigner.h>
+#include <virgil/crypto/VirgilStreamSigner.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
 
 using std::placeholders::_1;
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilPublicKeyCache;
 using virgil::crypto::VirgilSigner;
+using virgil::crypto::VirgilStreamSigner;
+using virgil::crypto::stream::VirgilBytesDataSource;
+
+static constexpr size_t kStreamData_Size = 16 * 1024 * 1024;
+static constexpr size_t kStreamData_ChunkSize = 1024 * 1024;
 
 void benchmark_sign(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
     VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be signed");
@@ -67,6 +85,18 @@ void benchmark_sign(benchpress::context* ctx, const VirgilKeyPair::Type& keyType
     }
 }
 
+void benchmark_sign_preloaded(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
+    VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be signed");
+    VirgilByteArray password = VirgilByteArrayUtils::stringToBytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType, password);
+    const VirgilPrivateKeyHandle privateKey(keyPair.privateKey(), password);
+    const VirgilSigner signer;
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)signer.sign(testData, privateKey);
+    }
+}
+
 void benchmark_verify(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
     VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be verified");
     VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
@@ -78,6 +108,97 @@ void benchmark_verify(benchpress::context* ctx, const VirgilKeyPair::Type& keyTy
     }
 }
 
+/**
+ * Sign with the given number of keys in turn, so every sign parses the key and loads the curve again,
+ *     while the precomputed table of the curve generator is shared by all keys.
+ */
+void benchmark_sign_with_many_keys(benchpress::context* ctx, const VirgilKeyPair::Type& keyType, size_t keysNum) {
+    VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be signed");
+    std::vector<VirgilKeyPair> keyPairs;
+    for (size_t i = 0; i < keysNum; ++i) {
+        keyPairs.push_back(VirgilKeyPair::generate(keyType));
+    }
+    VirgilSigner signer;
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)signer.sign(testData, keyPairs[i % keysNum].privateKey());
+    }
+}
+
+static std::vector<VirgilSigner::BatchItem> make_batch_items(size_t itemsNum, size_t keysNum) {
+    std::vector<VirgilKeyPair> keyPairs;
+    for (size_t i = 0; i < keysNum; ++i) {
+        keyPairs.push_back(VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519));
+    }
+    VirgilSigner signer;
+    std::vector<VirgilSigner::BatchItem> items;
+    for (size_t i = 0; i < itemsNum; ++i) {
+        const auto& keyPair = keyPairs[i % keysNum];
+        VirgilByteArray data = VirgilByteArrayUtils::stringToBytes("this string will be verified #" + std::to_string(i));
+        VirgilByteArray sign = signer.sign(data, keyPair.privateKey());
+        items.push_back({ data, sign, keyPair.publicKey() });
+    }
+    return items;
+}
+
+void benchmark_verify_one_by_one(benchpress::context* ctx, size_t itemsNum, size_t keysNum) {
+    const auto items = make_batch_items(itemsNum, keysNum);
+    VirgilSigner signer;
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        for (const auto& item : items) {
+            (void)signer.verify(item.data, item.sign, item.publicKey);
+        }
+    }
+}
+
+void benchmark_verify_batch(benchpress::context* ctx, size_t itemsNum, size_t keysNum) {
+    const auto items = make_batch_items(itemsNum, keysNum);
+    VirgilSigner signer;
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)signer.verifyBatch(items);
+    }
+}
+
+/**
+ * Verify signs made with the given number of keys, where every second sign is made with the one hot key,
+ *     and every fourth sign - with the one of the 3 warm keys.
+ */
+void benchmark_verify_skewed_keys(benchpress::context* ctx, size_t keysNum, bool useCache) {
+    auto items = make_batch_items(keysNum, keysNum);
+    std::vector<VirgilSigner::BatchItem> skewedItems;
+    for (size_t i = 0; i < items.size(); ++i) {
+        skewedItems.push_back(items[i]);
+        skewedItems.push_back(items[0]);
+        if (i % 2 == 0) {
+            skewedItems.push_back(items[1 + i % 3]);
+        }
+    }
+    VirgilSigner signer;
+    if (useCache) {
+        signer.setPublicKeyCache(std::make_shared<VirgilPublicKeyCache>(keysNum / 4));
+    }
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        const auto& item = skewedItems[i % skewedItems.size()];
+        (void)signer.verify(item.data, item.sign, item.publicKey);
+    }
+}
+
+void benchmark_stream_sign(benchpress::context* ctx, size_t leafSize, size_t threadsNum) {
+    VirgilByteArray testData(kStreamData_Size, 0xAB);
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilStreamSigner signer;
+    signer.setTreeHashLeafSize(leafSize);
+    signer.setTreeHashThreadsNum(threadsNum);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        VirgilBytesDataSource dataSource(testData, kStreamData_ChunkSize);
+        (void)signer.sign(dataSource, keyPair.privateKey());
+    }
+}
+
 BENCHMARK("Sign -> RSA 2048                  ", std::bind(benchmark_sign, _1, VirgilKeyPair::Type::RSA_2048));
 BENCHMARK("Sign -> RSA 3072                  ", std::bind(benchmark_sign, _1, VirgilKeyPair::Type::RSA_3072));
 BENCHMARK("Sign -> RSA 4096                  ", std::bind(benchmark_sign, _1, VirgilKeyPair::Type::RSA_4096));
@@ -93,6 +214,20 @@ BENCHMARK("Sign -> 224-bits 'Koblitz' curve  ", std::bind(benchmark_sign, _1, Vi
 BENCHMARK("Sign -> 256-bits 'Koblitz' curve  ", std::bind(benchmark_sign, _1, VirgilKeyPair::Type::EC_SECP256K1));
 BENCHMARK("Sign -> Ed25519 curve             ", std::bind(benchmark_sign, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
 
+BENCHMARK("Sign with preloaded key -> RSA 2048        ",
+          std::bind(benchmark_sign_preloaded, _1, VirgilKeyPair::Type::RSA_2048));
+BENCHMARK("Sign with preloaded key -> 256-bits NIST   ",
+          std::bind(benchmark_sign_preloaded, _1, VirgilKeyPair::Type::EC_SECP256R1));
+BENCHMARK("Sign with preloaded key -> Ed25519 curve   ",
+          std::bind(benchmark_sign_preloaded, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
+
+BENCHMARK("Sign with 16 keys in turn -> 256-bits NIST     ",
+          std::bind(benchmark_sign_with_many_keys, _1, VirgilKeyPair::Type::EC_SECP256R1, 16));
+BENCHMARK("Sign with 16 keys in turn -> 512-bits Brainpool",
+          std::bind(benchmark_sign_with_many_keys, _1, VirgilKeyPair::Type::EC_BP512R1, 16));
+BENCHMARK("Sign with 16 keys in turn -> 256-bits 'Koblitz'",
+          std::bind(benchmark_sign_with_many_keys, _1, VirgilKeyPair::Type::EC_SECP256K1, 16));
+
 BENCHMARK("Verify -> RSA 2048                ", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::RSA_2048));
 BENCHMARK("Verify -> RSA 3072                ", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::RSA_3072));
 BENCHMARK("Verify -> RSA 4096                ", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::RSA_4096));
@@ -107,3 +242,85 @@ BENCHMARK("Verify -> 192-bits 'Koblitz' curve", std::bind(benchmark_verify, _1,
 BENCHMARK("Verify -> 224-bits 'Koblitz' curve", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::EC_SECP224K1));
 BENCHMARK("Verify -> 256-bits 'Koblitz' curve", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::EC_SECP256K1));
 BENCHMARK("Verify -> Ed25519 curve           ", std::bind(benchmark_verify, _1, VirgilKeyPair::Type::FAST_EC_ED25519));
+
+BENCHMARK("Verify, 256 skewed keys -> no cache      ", std::bind(benchmark_verify_skewed_keys, _1, 256, false));
+BENCHMARK("Verify, 256 skewed keys -> 64 keys cache ", std::bind(benchmark_verify_skewed_keys, _1, 256, true));
+
+BENCHMARK("Stream sign 16 MB -> sequential hash    ", std::bind(benchmark_stream_sign, _1, 0, 1));
+BENCHMARK("Stream sign 16 MB -> tree hash, 1 thread", std::bind(benchmark_stream_sign, _1, 1024 * 1024, 1));
+BENCHMARK("Stream sign 16 MB -> tree hash, 4 thread", std::bind(benchmark_stream_sign, _1, 1024 * 1024, 4));
+
+BENCHMARK("Verify 256 Ed25519 signs, 1 key -> one by one    ", std::bind(benchmark_verify_one_by_one, _1, 256, 1));
+BENCHMARK("Verify 256 Ed25519 signs, 1 key -> batch         ", std::bind(benchmark_verify_batch, _1, 256, 1));
+BENCHMARK("Verify 256 Ed25519 signs, 256 keys -> one by one ", std::bind(benchmark_verify_one_by_one, _1, 256, 256));
+BENCHMARK("Verify 256 Ed25519 signs, 256 keys -> batch      ", std::bind(benchmark_verify_batch, _1, 256, 256));
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+/**
+ * One signer and one pair of key handles are shared by all threads, iterations are split between threads.
+ * With linear scaling time per iteration decreases proportionally to the number of threads.
+ */
+void benchmark_concurrently(benchpress::context* ctx, const VirgilKeyPair::Type& keyType, bool sign, size_t threadsNum) {
+    VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be signed");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
+    const VirgilPrivateKeyHandle privateKey(keyPair.privateKey());
+    const VirgilPublicKeyHandle publicKey(keyPair.publicKey());
+    const VirgilSigner signer;
+    const VirgilByteArray testSign = signer.sign(testData, privateKey);
+    // Threads are started before the timer is reset, and wait until they are released.
+    std::atomic<size_t> readyThreadsNum(0);
+    std::atomic<bool> isStarted(false);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < threadsNum; ++threadIndex) {
+        threads.emplace_back([&, threadIndex]() {
+            ++readyThreadsNum;
+            while (!isStarted) {
+                std::this_thread::yield();
+            }
+            for (size_t i = threadIndex; i < ctx->num_iterations(); i += threadsNum) {
+                if (sign) {
+                    (void)signer.sign(testData, privateKey);
+                } else {
+                    (void)signer.verify(testData, testSign, publicKey);
+                }
+            }
+        });
+    }
+    while (readyThreadsNum < threadsNum) {
+        std::this_thread::yield();
+    }
+    ctx->reset_timer();
+    isStarted = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+BENCHMARK("Sign concurrently -> Ed25519, 1 thread        ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, true, 1));
+BENCHMARK("Sign concurrently -> Ed25519, 2 threads       ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, true, 2));
+BENCHMARK("Sign concurrently -> Ed25519, 4 threads       ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, true, 4));
+BENCHMARK("Sign concurrently -> Ed25519, 8 threads       ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, true, 8));
+
+BENCHMARK("Sign concurrently -> 256-bits NIST, 1 thread  ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::EC_SECP256R1, true, 1));
+BENCHMARK("Sign concurrently -> 256-bits NIST, 4 threads ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::EC_SECP256R1, true, 4));
+
+BENCHMARK("Sign concurrently -> RSA 2048, 1 thread       ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::RSA_2048, true, 1));
+BENCHMARK("Sign concurrently -> RSA 2048, 4 threads      ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::RSA_2048, true, 4));
+
+BENCHMARK("Verify concurrently -> Ed25519, 1 thread      ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, false, 1));
+BENCHMARK("Verify concurrently -> Ed25519, 2 threads     ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, false, 2));
+BENCHMARK("Verify concurrently -> Ed25519, 4 threads     ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, false, 4));
+BENCHMARK("Verify concurrently -> Ed25519, 8 threads     ",
+          std::bind(benchmark_concurrently, _1, VirgilKeyPair::Type::FAST_EC_ED25519, false, 8));
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
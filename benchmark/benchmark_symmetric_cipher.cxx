@@ -0,0 +1,107 @@
+
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+
+/**
+ * @file benchmark_symmetric_cipher.cxx
+ * @brief Benchmark for symmetric encryption throughput
+ *
+ * Throughput is reported in MB/s, bytes per cycle is the reported value divided by the CPU frequency in MHz.
+ */
+
+#define BENCHPRESS_CONFIG_MAIN
+#include "benchpress.hpp"
+
+#include <functional>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+
+using std::placeholders::_1;
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::VirgilRandom;
+
+void benchmark_symmetric_cipher(
+        benchpress::context* ctx, VirgilSymmetricCipher::Algorithm algorithm, size_t dataSize, bool encrypt) {
+    VirgilRandom random(VirgilByteArrayUtils::stringToBytes("seed"));
+    VirgilSymmetricCipher cipher(algorithm);
+    const VirgilByteArray key = random.randomize(cipher.keyLength());
+    const VirgilByteArray iv = random.randomize(cipher.ivSize());
+    VirgilByteArray data = random.randomize(dataSize);
+    if (!encrypt) {
+        cipher.setEncryptionKey(key);
+        data = cipher.crypt(data, iv);
+        cipher.clear();
+    }
+    if (encrypt) {
+        cipher.setEncryptionKey(key);
+    } else {
+        cipher.setDecryptionKey(key);
+    }
+    VirgilByteArray output(data.size() + cipher.blockSize() + cipher.authTagLength());
+
+    ctx->set_bytes(dataSize);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        cipher.setIV(iv);
+        cipher.reset();
+        const size_t written = cipher.update(data.data(), data.size(), output.data(), output.size());
+        (void)cipher.finish(output.data() + written, output.size() - written);
+    }
+}
+
+BENCHMARK("Encrypt 16 KB -> AES-128-GCM", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_128_GCM, 16 * 1024, true));
+BENCHMARK("Encrypt 16 KB -> AES-256-GCM", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM, 16 * 1024, true));
+BENCHMARK("Encrypt 16 KB -> AES-256-CBC", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_256_CBC, 16 * 1024, true));
+BENCHMARK("Encrypt 1 MB  -> AES-256-GCM", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM, 1024 * 1024, true));
+BENCHMARK("Encrypt 16 KB -> CHACHA20-POLY1305", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305, 16 * 1024, true));
+BENCHMARK("Encrypt 1 MB  -> CHACHA20-POLY1305", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305, 1024 * 1024, true));
+BENCHMARK("Decrypt 16 KB -> AES-256-GCM", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM, 16 * 1024, false));
+BENCHMARK("Decrypt 1 MB  -> AES-256-GCM", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::AES_256_GCM, 1024 * 1024, false));
+BENCHMARK("Decrypt 1 MB  -> CHACHA20-POLY1305", std::bind(benchmark_symmetric_cipher, _1,
+        VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305, 1024 * 1024, false));
@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_BATCH_CIPHER_H
+#define VIRGIL_BATCH_CIPHER_H
+
+#include <memory>
+#include <vector>
+
+#include "VirgilByteArray.h"
+#include "VirgilCustomParams.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class encrypts many messages for the same set of recipients.
+ *
+ * Each message is encrypted with its own content encryption key, and the result is the same
+ * as if the message was encrypted by VirgilCipher::encrypt() with embedded content info,
+ * so it can be decrypted by VirgilCipher.
+ *
+ * Recipients public keys are parsed and random generators are seeded once per batch
+ * for each processing thread, instead of once per message.
+ *
+ * @note This class CAN not be used in wrappers.
+ */
+class VirgilBatchCipher {
+public:
+    /**
+     * @brief Create object without recipients.
+     */
+    VirgilBatchCipher();
+
+    /**
+     * @name Recipients management
+     */
+    ///@{
+    /**
+     * @brief Add recipient defined with id and public key.
+     * @throw VirgilCryptoException, if public key is invalid.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Add recipient defined with password.
+     */
+    void addPasswordRecipient(const VirgilByteArray& pwd);
+
+    /**
+     * @brief Remove all recipients.
+     */
+    void removeAllRecipients();
+    ///@}
+
+    /**
+     * @brief Provide access to the object that handles custom parameters.
+     * @note Given parameters are added to the content info of the each message.
+     */
+    VirgilCustomParams& customParams();
+
+    /**
+     * @brief Provide access to the object that handles custom parameters.
+     */
+    const VirgilCustomParams& customParams() const;
+
+    /**
+     * @brief Set maximum number of threads used to encrypt messages.
+     * @param threadsNum - maximum number of threads, 0 or 1 means sequential processing.
+     */
+    void setBatchThreadsNum(size_t threadsNum);
+
+    /**
+     * @brief Return maximum number of threads used to encrypt messages.
+     */
+    size_t getBatchThreadsNum() const;
+
+    /**
+     * @brief Encrypt each given message with its own content encryption key.
+     * @param messages - messages to be encrypted.
+     * @return Encrypted messages with embedded content info, in the same order.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if no recipients were added.
+     */
+    std::vector<VirgilByteArray> encrypt(const std::vector<VirgilByteArray>& messages) const;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilBatchCipher(VirgilBatchCipher&& rhs) noexcept;
+
+    VirgilBatchCipher& operator=(VirgilBatchCipher&& rhs) noexcept;
+
+    ~VirgilBatchCipher() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif /* VIRGIL_BATCH_CIPHER_H */
@@ -42,6 +42,7 @@
 #include "VirgilCipherBase.h"
 #include "VirgilByteArray.h"
 #include "VirgilDataSource.h"
+#include "VirgilRandomAccessDataSource.h"
 #include "VirgilDataSink.h"
 
 namespace virgil { namespace crypto {
@@ -50,6 +51,12 @@ namespace virgil { namespace crypto {
  * @brief This class provides high-level interface to encrypt / decrypt data splitted to chunks.
  * @note Virgil Security keys is used for encryption and decryption.
  * @note This class algorithms are not compatible with VirgilCipher and VirgilStreamCipher class algorithms.
+ * @warning Compatibility break: by default, nonce of each chunk is derived from the chunk index,
+ *     and the custom parameter "chunkNonce" is set to 1 in the content info.
+ *     Such data can not be decrypted by releases before this mode was introduced,
+ *     because they ignore this parameter and derive nonces differently.
+ *     Data encrypted by earlier releases (no "chunkNonce" parameter) is still decrypted.
+ *     Use @link setIndexedChunkNonce() @endlink to produce data readable by earlier releases.
  */
 class VirgilChunkCipher : public VirgilCipherBase {
 public:
@@ -87,6 +94,16 @@ public:
             VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& recipientId,
             const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Decrypt data read from given source for recipient defined by id and parsed private key,
+     *     and write it to the sink.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     */
+    void decryptWithKey(
+            VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& recipientId,
+            const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * @brief Decrypt data read from given source for recipient defined by password,
      *     and write it to the sink.
@@ -95,6 +112,82 @@ public:
      */
     void decryptWithPassword(VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& pwd);
 
+    /**
+     * @brief Decrypt given range of the plain text for recipient defined by id and private key,
+     *     and write it to the sink.
+     *
+     * Only chunks that cover requested range are read from the source, decrypted and verified.
+     *
+     * @param source - source of the encrypted data.
+     * @param sink - target sink for the decrypted range.
+     * @param offset - position of the first plain text byte to be decrypted.
+     * @param length - number of plain text bytes to be decrypted,
+     *     range is trimmed if it goes beyond the end of the plain text.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @note Data encrypted by previous versions of the library is not supported.
+     * @see method setContentInfo().
+     */
+    void decryptRangeWithKey(
+            VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+            const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt given range of the plain text for recipient defined by id and parsed private key,
+     *     and write it to the sink.
+     * @see decryptRangeWithKey(VirgilRandomAccessDataSource&, VirgilDataSink&, size_t, size_t,
+     *     const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)
+     */
+    void decryptRangeWithKey(
+            VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+            const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
+    /**
+     * @brief Decrypt given range of the plain text for recipient defined by password,
+     *     and write it to the sink.
+     * @see decryptRangeWithKey(VirgilRandomAccessDataSource&, VirgilDataSink&, size_t, size_t,
+     *     const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)
+     */
+    void decryptRangeWithPassword(
+            VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+            const VirgilByteArray& pwd);
+
+    /**
+     * @brief Define number of threads that are used to encrypt / decrypt chunks concurrently.
+     *
+     * Processed chunks are written to the sink in the original order.
+     * At most threadsNum chunks are read from the source and processed at once,
+     *     so memory held in flight is limited by 2 * threadsNum * chunk size.
+     *
+     * @param threadsNum - number of threads, 0 or 1 means sequential processing.
+     * @note Data encrypted by previous versions of the library is always decrypted sequentially.
+     * @note If library is built without VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, processing is always sequential.
+     */
+    void setChunksThreadsNum(size_t threadsNum);
+
+    /**
+     * @brief Return number of threads that are used to encrypt / decrypt chunks concurrently.
+     * @see setChunksThreadsNum()
+     */
+    size_t getChunksThreadsNum() const;
+
+    /**
+     * @brief Define whether encryption derives nonce of each chunk from the chunk index, or not.
+     *
+     * @param enabled - if true (default), data can be encrypted / decrypted in parallel and by ranges,
+     *     but can not be decrypted by earlier releases of the library.
+     *     If false, data is encrypted in the format of earlier releases: sequentially,
+     *     and without range decryption support.
+     * @note Decryption always detects nonce mode from the content info, so this option affects encryption only.
+     */
+    void setIndexedChunkNonce(bool enabled);
+
+    /**
+     * @brief Return true if encryption derives nonce of each chunk from the chunk index.
+     * @see setIndexedChunkNonce()
+     */
+    bool isIndexedChunkNonce() const;
+
 private:
     /**
      * @brief Store actual chunk size in the custom parameters.
@@ -106,10 +199,42 @@ private:
      */
     size_t retrieveChunkSize() const;
 
+    /**
+     * @brief Store nonce mode in the custom parameters: chunk nonce is derived from the chunk index.
+     */
+    void storeIndexedNonce();
+
+    /**
+     * @brief Return true if custom parameters define that chunk nonce is derived from the chunk index.
+     */
+    bool retrieveIndexedNonce() const;
+
     /**
      * @brief Do encryption / decryption depends on the configured mode.
      */
     void process(VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize);
+
+    /**
+     * @brief Process chunks, which nonces are derived from the chunk index, possibly in parallel.
+     */
+    void processIndexed(
+            VirgilDataSource& source, VirgilDataSink& sink, VirgilByteArray& data, size_t actualChunkSize);
+
+    /**
+     * @brief Process chunks, which nonces are derived from the previous chunk nonce and read pattern.
+     * @note Used to decrypt data encrypted by previous versions of the library.
+     */
+    void processLegacy(
+            VirgilDataSource& source, VirgilDataSink& sink, VirgilByteArray& data, size_t actualChunkSize);
+
+    /**
+     * @brief Decrypt chunks that cover given range of the plain text.
+     */
+    void processRange(VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length);
+
+private:
+    size_t chunksThreadsNum_ = 1;
+    bool indexedChunkNonce_ = true;
 };
 
 }}
@@ -59,6 +59,31 @@ public:
      */
     VirgilByteArray encrypt(const VirgilByteArray& data, bool embedContentInfo = true);
 
+    /**
+     * @brief Encrypt given data and write the result to the given buffer.
+     * @param data - data to be encrypted.
+     * @param dataLen - data length.
+     * @param encryptedData - buffer for the encrypted data.
+     * @param encryptedDataLen - buffer length, MUST be at least the value returned by defineEncryptedSize().
+     * @param embedContentInfo - determines whether to embed content info the the encrypted data, or not.
+     * @note Store content info to use it for decription process, if embedContentInfo parameter is false.
+     * @see getContentInfo()
+     * @return Number of bytes written to the buffer.
+     */
+    size_t encrypt(
+            const unsigned char* data, size_t dataLen, unsigned char* encryptedData, size_t encryptedDataLen,
+            bool embedContentInfo = true);
+
+    /**
+     * @brief Define exact size of the data that will be produced by the next encrypt() call.
+     * @param dataSize - size of the data to be encrypted.
+     * @param embedContentInfo - determines whether content info will be embedded to the encrypted data, or not.
+     * @note Content encryption key is generated and encrypted for the recipients by this method,
+     *     and then it is used by the next encrypt() call.
+     * @return Size of the encrypted data.
+     */
+    size_t defineEncryptedSize(size_t dataSize, bool embedContentInfo = true);
+
     /**
      * @brief Decrypt given data for recipient defined by id and private key.
      * @note Content info MUST be defined, if it was not embedded to the encrypted data.
@@ -70,6 +95,16 @@ public:
             const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Decrypt given data for recipient defined by id and parsed private key.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     * @return Decrypted data.
+     */
+    VirgilByteArray decryptWithKey(
+            const VirgilByteArray& encryptedData,
+            const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * @brief Decrypt given data for recipient defined by password.
      * @note Content info MUST be defined, if it was not embedded to the encrypted data.
@@ -83,6 +118,12 @@ private:
      * @return Decrypted data.
      */
     VirgilByteArray decrypt(const VirgilByteArray& encryptedData);
+
+    /**
+     * @brief Configure symmetric cipher for encryption, if it was not configured yet,
+     *     and encrypt content encryption key for the recipients that were added since then.
+     */
+    void prepareEncryption();
 };
 
 }}
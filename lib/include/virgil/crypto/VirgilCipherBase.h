@@ -43,15 +43,10 @@
 
 #include "VirgilByteArray.h"
 #include "VirgilCustomParams.h"
-
-/**
- * @name Forward declaration
- */
-/// @{
-namespace virgil { namespace crypto { namespace foundation {
-class VirgilSymmetricCipher;
-}}}
-/// @}
+#include "VirgilPrivateKeyHandle.h"
+#include "VirgilPublicKeyHandle.h"
+#include "VirgilRecipientSet.h"
+#include "foundation/VirgilSymmetricCipher.h"
 
 namespace virgil { namespace crypto {
 
@@ -78,6 +73,22 @@ public:
      */
     void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey);
 
+    /**
+     * @brief Add recipient defined with id and parsed public key.
+     * @param recipientId Recipient's unique identifier, MUST not be empty.
+     * @param publicKey Recipient's parsed public key.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if invalid arguments are given.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey);
+
+    /**
+     * @brief Add all recipients from the given set.
+     * @note Public keys are not parsed again.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if recipient already exists,
+     *     in this case none of the recipients is added.
+     */
+    void addKeyRecipients(const VirgilRecipientSet& recipients);
+
     /**
      * @brief Remove recipient with given identifier.
      * @param recipientId Recipient's unique identifier.
@@ -128,6 +139,42 @@ public:
      * @brief Remove all recipients.
      */
     void removeAllRecipients();
+
+    /**
+     * @brief Define maximum number of threads that are used to encrypt content encryption key for recipients.
+     *
+     * By default, content encryption key is encrypted for each recipient sequentially.
+     * Use this method to speed up encryption for a big number of recipients.
+     *
+     * @param threadsNum - maximum number of threads, 0 or 1 means sequential processing.
+     * @note Produced content info is the same as in the sequential mode.
+     * @note Takes effect only if library is built with VIRGIL_CRYPTO_FEATURE_MULTI_THREAD.
+     */
+    void setRecipientsThreadsNum(size_t threadsNum);
+
+    /**
+     * @brief Return maximum number of threads that are used to encrypt content encryption key for recipients.
+     */
+    size_t getRecipientsThreadsNum() const;
+    ///@}
+    /**
+     * @name Content encryption
+     */
+    ///@{
+    /**
+     * @brief Define symmetric algorithm that is used to encrypt content, default is AES-256-GCM.
+     *
+     * Use CHACHA20_POLY1305 on platforms without hardware AES support.
+     *
+     * @note Algorithm is stored within the content info, so decryption detects it automatically.
+     * @note Takes effect on the next encryption.
+     */
+    void setContentEncryptionAlgorithm(foundation::VirgilSymmetricCipher::Algorithm algorithm);
+
+    /**
+     * @brief Return symmetric algorithm that is used to encrypt content.
+     */
+    foundation::VirgilSymmetricCipher::Algorithm getContentEncryptionAlgorithm() const;
     ///@}
     /**
      * @name Content Info Access / Management
@@ -239,6 +286,13 @@ protected:
             const VirgilByteArray& recipientId,
             const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword);
 
+    /**
+     * @brief Stores recipient's information that is used for cipher's key decryption when content becomes available.
+     * @param recipientId - recipient's id.
+     * @param privateKey - recipient's parsed private key.
+     */
+    void initDecryptionWithKey(const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * Return true if one one of the init function was called.
      */
@@ -260,6 +314,14 @@ protected:
      */
     virgil::crypto::foundation::VirgilSymmetricCipher& getSymmetricCipher();
 
+    /**
+     * @brief Return new symmetric cipher configured with the same algorithm, key and mode
+     *     as the cipher returned by the method @link getSymmetricCipher() @endlink.
+     * @note Returned cipher is independent, so it can be used concurrently with the original one.
+     * @note Input vector MUST be set and method reset() MUST be called before returned cipher usage.
+     */
+    virgil::crypto::foundation::VirgilSymmetricCipher cloneSymmetricCipher() const;
+
     /**
      * @brief Build VirgilContentInfo object.
      *
@@ -292,6 +354,14 @@ private:
             const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
             const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword) const;
 
+    /**
+     * @brief Decrypt content encryption key with the parsed private key.
+     * @see initDecryptionWithKey(const VirgilByteArray&, const VirgilPrivateKeyHandle&)
+     */
+    virtual VirgilByteArray doDecryptWithKey(
+            const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
+            const VirgilPrivateKeyHandle& privateKey) const;
+
     virtual VirgilByteArray doDecryptWithPassword(
             const VirgilByteArray& encryptedKey, const VirgilByteArray& encryptionAlgorithm,
             const VirgilByteArray& password) const;
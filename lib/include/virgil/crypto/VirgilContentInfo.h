@@ -45,6 +45,12 @@
 
 namespace virgil { namespace crypto {
 
+//! @cond Doxygen_Suppress
+namespace internal {
+class VirgilContentInfoUtils;
+}
+//! @endcond
+
 /**
  * High level API to the VirgilContentInfo structure.
  */
@@ -203,9 +209,23 @@ private:
         VirgilByteArray encryptedContent;
     };
 
-    void encryptKeyRecipients(std::function<EncryptionResult(const VirgilByteArray& publicKey)> encrypt);
+    /**
+     * @brief Iterate over key recipients, and store encryption result for each of them.
+     * @param encrypt - encryption function, it MUST be thread-safe if threadsNum is greater than 1.
+     * @param threadsNum - maximum number of threads used to call encryption function.
+     * @note Recipients are stored in the same order regardless of the threads number.
+     */
+    void encryptKeyRecipients(
+            std::function<EncryptionResult(const VirgilByteArray& publicKey)> encrypt, size_t threadsNum = 1);
 
-    void encryptPasswordRecipients(std::function<EncryptionResult(const VirgilByteArray& pwd)> encrypt);
+    /**
+     * @brief Iterate over password recipients, and store encryption result for each of them.
+     * @param encrypt - encryption function, it MUST be thread-safe if threadsNum is greater than 1.
+     * @param threadsNum - maximum number of threads used to call encryption function.
+     * @note Recipients are stored in the same order regardless of the threads number.
+     */
+    void encryptPasswordRecipients(
+            std::function<EncryptionResult(const VirgilByteArray& pwd)> encrypt, size_t threadsNum = 1);
 
     void setContentEncryptionAlgorithm(const VirgilByteArray& contentEncryptionAlgorithm);
 
@@ -216,6 +236,7 @@ private:
     bool isReadyForDecryption();
 
     friend class VirgilCipherBase;
+    friend class internal::VirgilContentInfoUtils;
     ///@}
 
 public:
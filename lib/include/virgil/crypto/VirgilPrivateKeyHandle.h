@@ -0,0 +1,113 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PRIVATE_KEY_HANDLE_H
+#define VIRGIL_CRYPTO_PRIVATE_KEY_HANDLE_H
+
+#include <memory>
+
+#include "VirgilByteArray.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class handles private key that was parsed once and can be used for many decryption
+ *     and signing operations.
+ *
+ * Private key is parsed, and decrypted if it is protected with password, only once - when handle is created.
+ * Then handle can be passed to the Virgil*Cipher and Virgil*Signer classes instead of the raw private key.
+ *
+ * @note Handle is immutable, so it can be copied cheaply and shared between threads.
+ */
+class VirgilPrivateKeyHandle {
+public:
+    /**
+     * @brief Parse given private key.
+     *
+     * @param privateKey - private key in DER or PEM format.
+     * @param privateKeyPassword - private key password if exists.
+     *
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPrivateKey, if private key is invalid.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPrivateKeyPassword,
+     *     if private key password mismatch.
+     */
+    explicit VirgilPrivateKeyHandle(
+            const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt given data with the underlying private key.
+     *
+     * @param encryptedData - data encrypted with the correspond public key.
+     * @return Decrypted data.
+     *
+     * @note This method is thread-safe.
+     */
+    VirgilByteArray decrypt(const VirgilByteArray& encryptedData) const;
+
+    /**
+     * @brief Sign given digest with the underlying private key.
+     *
+     * @param digest - digest to be signed.
+     * @param hashType - type of the hash algorithm that was used to get digest, see VirgilHash::type().
+     * @return Signed digest.
+     *
+     * @note This method is reentrant and does not take locks,
+     *     so one handle can serve signing in any number of threads.
+     */
+    VirgilByteArray sign(const VirgilByteArray& digest, int hashType) const;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilPrivateKeyHandle(const VirgilPrivateKeyHandle& rhs);
+
+    VirgilPrivateKeyHandle& operator=(const VirgilPrivateKeyHandle& rhs);
+
+    VirgilPrivateKeyHandle(VirgilPrivateKeyHandle&& rhs) noexcept;
+
+    VirgilPrivateKeyHandle& operator=(VirgilPrivateKeyHandle&& rhs) noexcept;
+
+    ~VirgilPrivateKeyHandle() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::shared_ptr<const Impl> impl_;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_PRIVATE_KEY_HANDLE_H */
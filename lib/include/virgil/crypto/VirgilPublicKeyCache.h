@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PUBLIC_KEY_CACHE_H
+#define VIRGIL_CRYPTO_PUBLIC_KEY_CACHE_H
+
+#include <cstddef>
+#include <memory>
+
+#include "VirgilByteArray.h"
+#include "VirgilPublicKeyHandle.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class holds bounded number of parsed public keys, so they are not parsed again on every use.
+ *
+ * Keys are identified by the digest of their bytes. When cache is full, the least recently used key is evicted.
+ * Cache can be given to the signers with VirgilSignerBase::setPublicKeyCache(),
+ *     or parsed keys can be requested explicitly with get().
+ *
+ * @note This class is thread-safe, so one instance can be shared between many signers and threads.
+ */
+class VirgilPublicKeyCache {
+public:
+    /**
+     * @brief Create empty cache.
+     *
+     * @param capacity - maximum number of parsed keys to be held.
+     *
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if capacity is 0.
+     */
+    explicit VirgilPublicKeyCache(size_t capacity = kDefaultCapacity);
+
+    /**
+     * @brief Return parsed public key, parse it and put to the cache if it is absent.
+     *
+     * @param publicKey - public key in DER or PEM format.
+     * @return Parsed public key.
+     *
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPublicKey, if public key is invalid.
+     */
+    VirgilPublicKeyHandle get(const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Return maximum number of parsed keys to be held.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Return number of parsed keys that are held now.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Return number of get() calls that found parsed key in the cache.
+     */
+    size_t getHits() const;
+
+    /**
+     * @brief Return number of get() calls that parsed key.
+     */
+    size_t getMisses() const;
+
+    /**
+     * @brief Remove all parsed keys.
+     * @note Hit and miss counters are not reset.
+     */
+    void clear();
+
+public:
+    /**
+     * @brief Default maximum number of parsed keys to be held.
+     */
+    static constexpr size_t kDefaultCapacity = 1024;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilPublicKeyCache(const VirgilPublicKeyCache&) = delete;
+
+    VirgilPublicKeyCache& operator=(const VirgilPublicKeyCache&) = delete;
+
+    ~VirgilPublicKeyCache() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_PUBLIC_KEY_CACHE_H */
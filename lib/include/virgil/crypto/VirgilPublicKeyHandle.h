@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PUBLIC_KEY_HANDLE_H
+#define VIRGIL_CRYPTO_PUBLIC_KEY_HANDLE_H
+
+#include <memory>
+
+#include "VirgilByteArray.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class handles public key that was parsed once and can be used for many encryption
+ *     and verification operations.
+ *
+ * Public key is parsed and validated only once - when handle is created.
+ *
+ * @note Handle is immutable, so it can be copied cheaply and shared between threads.
+ */
+class VirgilPublicKeyHandle {
+public:
+    /**
+     * @brief Parse given public key.
+     *
+     * @param publicKey - public key in DER or PEM format.
+     *
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPublicKey, if public key is invalid.
+     */
+    explicit VirgilPublicKeyHandle(const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Return public key as it was given to the constructor.
+     */
+    const VirgilByteArray& getKey() const;
+
+    /**
+     * @brief Return ASN.1 structure that identifies public key algorithm.
+     */
+    const VirgilByteArray& getAlgorithm() const;
+
+    /**
+     * @brief Encrypt given data with the underlying public key.
+     *
+     * @param data - data to be encrypted.
+     * @return Encrypted data.
+     *
+     * @note This method is thread-safe.
+     */
+    VirgilByteArray encrypt(const VirgilByteArray& data) const;
+
+    /**
+     * @brief Verify given digest with given sign and the underlying public key.
+     *
+     * @param digest - digest to be verified.
+     * @param sign - signed digest to be used during verification.
+     * @param hashType - type of the hash algorithm that was used to get digest, see VirgilHash::type().
+     * @return true if given sign corresponds to the given digest, otherwise - false.
+     *
+     * @note This method is reentrant and does not take locks,
+     *     so one handle can serve verification in any number of threads.
+     */
+    bool verify(const VirgilByteArray& digest, const VirgilByteArray& sign, int hashType) const;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilPublicKeyHandle(const VirgilPublicKeyHandle& rhs);
+
+    VirgilPublicKeyHandle& operator=(const VirgilPublicKeyHandle& rhs);
+
+    VirgilPublicKeyHandle(VirgilPublicKeyHandle&& rhs) noexcept;
+
+    VirgilPublicKeyHandle& operator=(VirgilPublicKeyHandle&& rhs) noexcept;
+
+    ~VirgilPublicKeyHandle() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::shared_ptr<const Impl> impl_;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_PUBLIC_KEY_HANDLE_H */
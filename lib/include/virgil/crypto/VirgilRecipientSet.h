@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_RECIPIENT_SET_H
+#define VIRGIL_CRYPTO_RECIPIENT_SET_H
+
+#include <map>
+
+#include "VirgilByteArray.h"
+#include "VirgilPublicKeyHandle.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class holds key recipients with public keys that were parsed and validated once.
+ *
+ * Set can be added to any number of ciphers with VirgilCipherBase::addKeyRecipients(),
+ * and public keys are not parsed again.
+ *
+ * @note Copies of the set share parsed public keys.
+ * @note Set that is not modified can be shared between threads.
+ */
+class VirgilRecipientSet {
+public:
+    /**
+     * @brief Create empty set.
+     */
+    VirgilRecipientSet();
+
+    /**
+     * @brief Add recipient defined with id and public key.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPublicKey, if public key is invalid.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if recipient already exists.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Add recipient defined with id and parsed public key.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if recipient already exists.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey);
+
+    /**
+     * @brief Remove recipient with given id.
+     * @note If recipient with given id is absent - do nothing.
+     */
+    void removeKeyRecipient(const VirgilByteArray& recipientId);
+
+    /**
+     * @brief Check whether recipient with given id exists.
+     */
+    bool keyRecipientExists(const VirgilByteArray& recipientId) const;
+
+    /**
+     * @brief Return number of recipients.
+     */
+    size_t size() const;
+
+private:
+    std::map<VirgilByteArray, VirgilPublicKeyHandle> keyRecipients_;
+
+    friend class VirgilCipherBase;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_RECIPIENT_SET_H */
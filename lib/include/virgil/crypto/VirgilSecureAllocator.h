@@ -0,0 +1,208 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_SECURE_ALLOCATOR_H
+#define VIRGIL_CRYPTO_SECURE_ALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Slab allocator that keeps sensitive data within locked memory pages.
+ *
+ * Arena reserves address space once, and commits memory from it in regions,
+ * that are locked in RAM (mlock / VirtualLock) to keep secrets out of swap,
+ * and split to the blocks of the fixed size classes.
+ * Released blocks are zeroized and kept in the per-class free lists,
+ * so they are recycled without new system calls and page faults.
+ * Allocations that do not fit the largest size class take several whole regions,
+ * and are recycled the same way by the number of regions.
+ *
+ * @note This class is thread-safe, every size class is locked separately.
+ * @note If pages can not be locked (i.e. RLIMIT_MEMLOCK is exceeded), memory is still allocated,
+ *     but it is reported by the Stats::lockFailures counter.
+ */
+class VirgilSecureArena {
+public:
+    /**
+     * @brief Default size of the reserved address space.
+     */
+    static constexpr size_t kDefaultCapacity = sizeof(void*) >= 8 ? (size_t(1) << 30) : (size_t(64) << 20);
+
+    /**
+     * @brief Arena usage statistics.
+     */
+    struct Stats {
+        size_t reservedBytes = 0; ///< Bytes requested from the system.
+        size_t lockedBytes = 0; ///< Bytes successfully locked in RAM.
+        size_t usedBytes = 0; ///< Bytes of the blocks that are currently allocated.
+        size_t peakUsedBytes = 0; ///< Maximum value of the usedBytes.
+        size_t usedBlocks = 0; ///< Number of the blocks that are currently allocated.
+        size_t allocations = 0; ///< Total number of the allocations.
+        size_t systemAllocations = 0; ///< Total number of the regions requested from the system.
+        size_t lockFailures = 0; ///< Number of the regions that were not locked.
+    };
+
+    /**
+     * @brief Create arena.
+     *
+     * @param regionSize - size of the region that is requested from the system for the slab,
+     *     rounded up to the page size.
+     * @param capacity - size of the reserved address space, it limits the total size of the arena memory.
+     * @throw std::bad_alloc, if address space can not be reserved.
+     */
+    explicit VirgilSecureArena(size_t regionSize = 64 * 1024, size_t capacity = kDefaultCapacity);
+
+    /**
+     * @brief Return arena that is used by default.
+     *
+     * @note Default arena is never destroyed, so it can be used during static objects destruction.
+     */
+    static VirgilSecureArena& defaultArena();
+
+    /**
+     * @brief Allocate memory block.
+     *
+     * @param size - block size in bytes.
+     * @return Zero filled block.
+     * @throw std::bad_alloc, if memory can not be allocated.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Zeroize and release memory block.
+     *
+     * @param ptr - pointer returned by @link allocate() @endlink or nullptr.
+     * @return true if block belongs to this arena and was released, false otherwise.
+     */
+    bool deallocate(void* ptr) noexcept;
+
+    /**
+     * @brief Return current arena usage statistics.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Route all memory allocations of the underlying crypto library to the default arena.
+     *
+     * Blocks that were allocated before this call are released with the standard free() function,
+     * so this method can be called at any time. Once installed, allocator can not be uninstalled.
+     *
+     * @throw VirgilCryptoException with VirgilCryptoError::UnsupportedAlgorithm,
+     *     if underlying crypto library was built without custom allocator support.
+     */
+    static void installSystemCryptoAllocator();
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilSecureArena(const VirgilSecureArena&) = delete;
+
+    VirgilSecureArena& operator=(const VirgilSecureArena&) = delete;
+
+    ~VirgilSecureArena() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Standard allocator that takes memory from the VirgilSecureArena.
+ *
+ * Can be used with standard containers to store keys and other sensitive data.
+ *
+ * @see VirgilSecureByteArray
+ */
+template<typename T>
+class VirgilSecureAllocator {
+public:
+    //! @cond Doxygen_Suppress
+    using value_type = T;
+
+    VirgilSecureAllocator() noexcept : arena_(&VirgilSecureArena::defaultArena()) {}
+
+    explicit VirgilSecureAllocator(VirgilSecureArena& arena) noexcept : arena_(&arena) {}
+
+    template<typename U>
+    VirgilSecureAllocator(const VirgilSecureAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max)() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        arena_->deallocate(ptr);
+    }
+
+    VirgilSecureArena* arena() const noexcept {
+        return arena_;
+    }
+    //! @endcond
+
+private:
+    VirgilSecureArena* arena_;
+};
+
+//! @cond Doxygen_Suppress
+template<typename T, typename U>
+bool operator==(const VirgilSecureAllocator<T>& lhs, const VirgilSecureAllocator<U>& rhs) noexcept {
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const VirgilSecureAllocator<T>& lhs, const VirgilSecureAllocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+//! @endcond
+
+/**
+ * @brief Byte array that is stored within locked memory and zeroized when released.
+ */
+using VirgilSecureByteArray = std::vector<unsigned char, VirgilSecureAllocator<unsigned char>>;
+
+}}
+
+#endif /* VIRGIL_CRYPTO_SECURE_ALLOCATOR_H */
@@ -64,6 +64,14 @@ public:
     void startDecryptionWithKey(
             const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Start sequential decryption for recipient defined by id and parsed private key.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     */
+    void startDecryptionWithKey(const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * @brief Start sequential decryption for recipient defined by id and private key.
      * @note Content info MUST be defined, if it was not embedded to the encrypted data.
@@ -78,12 +86,36 @@ public:
      */
     VirgilByteArray process(const VirgilByteArray& data);
 
+    /**
+     * Encrypt or decrypt given data depends on the current sequential mode, and write result to the given buffer.
+     * @param data - plain text, if cipher in the encryption mode, encrypted data, if cipher in the decryption mode.
+     * @param dataLen - data length.
+     * @param output - buffer for the plain text, if cipher in the decryption mode,
+     *     or encrypted data, if cipher in the encryption mode.
+     * @param outputLen - output buffer length, MUST be at least dataLen + 16 (symmetric cipher block size).
+     * @return Number of bytes written to the output.
+     * @note This method does not allocate memory in the encryption mode,
+     *     and in the decryption mode after content info was extracted.
+     * @note While embedded content info is being extracted, data is accumulated by the cipher,
+     *     so output buffer MUST have room for all data passed since decryption start plus 16 bytes.
+     */
+    size_t process(const unsigned char* data, size_t dataLen, unsigned char* output, size_t outputLen);
+
     /**
      * Accomplish sequential encryption or decryption depends on the mode.
      * @return plain text, if cipher in the decryption mode, encrypted data, if cipher in the encryption mode.
      */
     VirgilByteArray finish();
 
+    /**
+     * Accomplish sequential encryption or decryption depends on the mode, and write result to the given buffer.
+     * @param output - buffer for the plain text, if cipher in the decryption mode,
+     *     or encrypted data, if cipher in the encryption mode.
+     * @param outputLen - output buffer length, MUST be at least 32 bytes (symmetric cipher block and tag size).
+     * @return Number of bytes written to the output.
+     */
+    size_t finish(unsigned char* output, size_t outputLen);
+
 private:
     /**
      * @brief Decrypt given data.
@@ -84,6 +84,12 @@ public:
     VirgilByteArray sign(const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Sign data that was collected by update() function with given preloaded private key.
+     * @return Virgil Security sign.
+     */
+    VirgilByteArray sign(const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * @brief Verify sign and data that was collected by update() function to be conformed to the given public key.
      * @return true if sign is valid and data was not malformed.
@@ -91,7 +97,7 @@ public:
     bool verify(const VirgilByteArray& publicKey);
 
 private:
-    VirgilByteArray unpackedSignature_;
+    UnpackedSignature unpackedSignature_;
     foundation::VirgilHash hash_;
 };
 
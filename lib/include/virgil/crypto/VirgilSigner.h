@@ -42,15 +42,31 @@
 #include "VirgilByteArray.h"
 #include "foundation/VirgilHash.h"
 
+#include <vector>
+
 namespace virgil { namespace crypto {
 
 /**
  * @brief This class provides high-level interface to sign and verify data using Virgil Security keys.
  *
  * This module can sign / verify as raw data and Virgil Security tickets.
+ *
+ * @note Methods that take preloaded keys (VirgilPrivateKeyHandle, VirgilPublicKeyHandle) are const
+ *     and keep all per-call state on the stack, so one signer can be used by many threads concurrently,
+ *     while it is not reconfigured. Other methods change the signer.
  */
 class VirgilSigner : public VirgilSignerBase {
 public:
+    /**
+     * @brief Data with its sign and signer's public key to be verified within batch.
+     * @see verifyBatch()
+     */
+    struct BatchItem {
+        VirgilByteArray data;
+        VirgilByteArray sign;
+        VirgilByteArray publicKey;
+    };
+
     /**
      * @brief Create signer with predefined hash function.
      * @note Specified hash function algorithm is used only during signing.
@@ -67,11 +83,40 @@ public:
             const VirgilByteArray& data, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Sign data with given preloaded private key.
+     * @return Virgil Security sign.
+     * @note Private key is not parsed again, and this method can be called concurrently.
+     */
+    VirgilByteArray sign(const VirgilByteArray& data, const VirgilPrivateKeyHandle& privateKey) const;
+
     /**
      * @brief Verify sign and data to be conformed to the given public key.
      * @return true if sign is valid and data was not malformed.
      */
     bool verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Verify sign and data to be conformed to the given preloaded public key.
+     * @return true if sign is valid and data was not malformed.
+     * @note Public key is not parsed again, and this method can be called concurrently.
+     */
+    bool verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey) const;
+
+    /**
+     * @brief Verify many signs at once.
+     *
+     * Ed25519 signs are verified together with randomized batch verification,
+     *     that is based on the single multi-scalar multiplication, and each public key is parsed once.
+     *     If batch verification fails, it is split to find invalid signs.
+     * Signs made with other key types are verified one by one.
+     *
+     * @param items - data, signs and public keys to be verified.
+     * @return Indices of the items which signs are invalid or malformed, empty if all signs are valid.
+     * @note Batch verification of Ed25519 signs is cofactored, so it MAY accept a sign
+     *     deliberately crafted with small order components, that is rejected by @link verify() @endlink.
+     */
+    std::vector<size_t> verifyBatch(const std::vector<BatchItem>& items);
 };
 
 }}
@@ -37,7 +37,13 @@
 #ifndef VIRGIL_CRYPTO_SIGNER_BASE_H
 #define VIRGIL_CRYPTO_SIGNER_BASE_H
 
+#include <memory>
+
 #include "VirgilByteArray.h"
+#include "VirgilDataSource.h"
+#include "VirgilPrivateKeyHandle.h"
+#include "VirgilPublicKeyCache.h"
+#include "VirgilPublicKeyHandle.h"
 #include "foundation/VirgilHash.h"
 #include "foundation/VirgilAsymmetricCipher.h"
 
@@ -61,6 +67,60 @@ public:
      */
     foundation::VirgilHash::Algorithm getHashAlgorithm() const;
 
+    /**
+     * @brief Enable tree hashing of the data to be signed.
+     *
+     * Data is split to the leaves of the given size, leaves are hashed concurrently,
+     *     and their hashes are combined within a Merkle tree, which root is signed.
+     * Tree hashing is stored within the packed signature, so verification selects it automatically.
+     *
+     * @param leafSize - leaf size in bytes from 1 KB to 16 MB, 0 means the data is hashed sequentially (default).
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if leaf size is out of the range.
+     * @note Tree hashing is supported by VirgilSigner and VirgilStreamSigner.
+     * @note Specified leaf size is used only during signing, verification takes leaf size from the signature.
+     */
+    void setTreeHashLeafSize(size_t leafSize);
+
+    /**
+     * @brief Return leaf size of the tree hashing.
+     * @return 0 if tree hashing is disabled.
+     * @see setTreeHashLeafSize()
+     */
+    size_t getTreeHashLeafSize() const;
+
+    /**
+     * @brief Define maximum number of threads that are used to hash leaves during tree hashing.
+     *
+     * At most threadsNum leaves are read from the source and hashed at once.
+     *
+     * @param threadsNum - maximum number of threads, 0 or 1 means sequential processing.
+     * @note If library is built without VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, processing is always sequential.
+     */
+    void setTreeHashThreadsNum(size_t threadsNum);
+
+    /**
+     * @brief Return maximum number of threads that are used to hash leaves during tree hashing.
+     * @see setTreeHashThreadsNum()
+     */
+    size_t getTreeHashThreadsNum() const;
+
+    /**
+     * @brief Define cache of the parsed public keys that is used during signature verification.
+     *
+     * If cache is defined, public key is parsed only if it is absent in the cache.
+     * One cache can be shared between many signers.
+     *
+     * @param publicKeyCache - cache of the parsed public keys, nullptr means keys are parsed on every verification.
+     */
+    void setPublicKeyCache(std::shared_ptr<VirgilPublicKeyCache> publicKeyCache);
+
+    /**
+     * @brief Return cache of the parsed public keys that is used during signature verification.
+     * @return nullptr if cache is not defined.
+     * @see setPublicKeyCache()
+     */
+    std::shared_ptr<VirgilPublicKeyCache> getPublicKeyCache() const;
+
     /**
      * @brief Create signature over pre-calculated hash.
      *
@@ -73,6 +133,16 @@ public:
             const VirgilByteArray& digest, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Create signature over pre-calculated hash with preloaded private key.
+     *
+     * @param digest - hash digest of the data.
+     * @param privateKey - parsed private key to be used for signature operation.
+     * @return Signature.
+     * @note This method does not change signer, so it can be called concurrently.
+     */
+    VirgilByteArray signHash(const VirgilByteArray& digest, const VirgilPrivateKeyHandle& privateKey) const;
+
     /**
      * @brief Verify signature over pre-calculated hash.
      *
@@ -86,6 +156,39 @@ public:
             const VirgilByteArray& publicKey);
 
 protected:
+    /**
+     * @brief Signature and parameters of the data digest calculation, unpacked without changing the signer.
+     * @see readSignature()
+     */
+    struct UnpackedSignature {
+        VirgilByteArray signature; ///< Signature over digest
+        foundation::VirgilHash::Algorithm hashAlgorithm; ///< Algorithm of the digest calculation
+        int hashType; ///< Algorithm of the digest calculation, see VirgilHash::type()
+        size_t treeHashLeafSize; ///< Leaf size of the tree hashing, 0 if tree hashing is not used
+    };
+
+    /**
+     * @brief Calculate digest of the data provided by the source.
+     * @note Tree hashing is used if it is enabled, see setTreeHashLeafSize().
+     */
+    VirgilByteArray hashData(VirgilDataSource& source) const;
+
+    /**
+     * @brief Calculate digest of the given data.
+     * @note Tree hashing is used if it is enabled, see setTreeHashLeafSize().
+     */
+    VirgilByteArray hashData(const VirgilByteArray& data) const;
+
+    /**
+     * @brief Calculate digest of the data provided by the source, as it was calculated for the given signature.
+     */
+    VirgilByteArray hashData(VirgilDataSource& source, const UnpackedSignature& signature) const;
+
+    /**
+     * @brief Calculate digest of the given data, as it was calculated for the given signature.
+     */
+    VirgilByteArray hashData(const VirgilByteArray& data, const UnpackedSignature& signature) const;
+
     /**
      * @brief Pack given signature to the ASN.1 structure.
      *
@@ -96,9 +199,23 @@ protected:
      *     }
      * @endcode
      *
+     * If tree hashing is enabled, digestAlgorithm is:
+     *
+     * @code
+     *     AlgorithmIdentifier ::= SEQUENCE {
+     *         algorithm id-virgil-tree-hash,
+     *         parameters VirgilTreeHashParams
+     *     }
+     *
+     *     VirgilTreeHashParams ::= SEQUENCE {
+     *         digestAlgorithm ::= AlgorithmIdentifier,
+     *         leafSize ::= INTEGER
+     *     }
+     * @endcode
+     *
      * @param signature - signature to be wrapped
      * @return Packed signature.
-     * @note This function use value returned by function getHashAlgorithm().
+     * @note This function use values returned by functions getHashAlgorithm() and getTreeHashLeafSize().
      */
     VirgilByteArray packSignature(const VirgilByteArray& signature) const;
 
@@ -114,11 +231,34 @@ protected:
      *
      * @param packedSignature - signature packed within ASN.1 structure.
      * @return Signature.
-     * @note This function has side-effect it changes object field VirgilSignerBase::hashAlgorithm_,
+     * @note This function has side-effect it changes object field VirgilSignerBase::hash_,
      *     that can be accessed via function getHashAlgorithm().
+     * @note Leaf size of the tree hashing is not returned, use readSignature() to get it.
      */
     VirgilByteArray unpackSignature(const VirgilByteArray& packedSignature);
 
+    /**
+     * @brief Unpack signature and parameters of the data digest calculation from the ASN.1 structure.
+     *
+     * Unlike unpackSignature(), this function has no side-effects, so it can be called concurrently.
+     *
+     * @param packedSignature - signature packed within ASN.1 structure.
+     * @return Signature and parameters of the data digest calculation.
+     */
+    UnpackedSignature readSignature(const VirgilByteArray& packedSignature) const;
+
+    /**
+     * @brief Verify unpacked signature over pre-calculated hash.
+     *
+     * @param digest - hash digest of the data, see hashData(const VirgilByteArray&, const UnpackedSignature&).
+     * @param signature - signature returned by readSignature().
+     * @param publicKey - public key to be used for signature verification.
+     * @return true if signature verification was successful, false - otherwise.
+     * @note This function has side-effect it changes hash algorithm of the signer to the signature one.
+     */
+    bool verifyHash(
+            const VirgilByteArray& digest, const UnpackedSignature& signature, const VirgilByteArray& publicKey);
+
 private:
     /**
      * @see signHash()
@@ -136,6 +276,9 @@ private:
 private:
     foundation::VirgilHash hash_;
     foundation::VirgilAsymmetricCipher pk_;
+    size_t treeHashLeafSize_ = 0;
+    size_t treeHashThreadsNum_ = 1;
+    std::shared_ptr<VirgilPublicKeyCache> publicKeyCache_;
 };
 
 }}
@@ -49,6 +49,10 @@ namespace virgil { namespace crypto {
  * @brief This class provides high-level interface to sign and verify data using Virgil Security keys.
  *
  * This module can sign / verify data provided by stream.
+ *
+ * @note Methods that take preloaded keys (VirgilPrivateKeyHandle, VirgilPublicKeyHandle) are const
+ *     and keep all per-call state on the stack, so one signer can be used by many threads concurrently,
+ *     while it is not reconfigured. Every thread MUST use its own data source.
  */
 class VirgilStreamSigner : public VirgilSignerBase {
 public:
@@ -68,11 +72,25 @@ public:
             VirgilDataSource& source, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Sign data provided by the source with given preloaded private key.
+     * @return Virgil Security sign.
+     * @note Private key is not parsed again, and this method can be called concurrently with different sources.
+     */
+    VirgilByteArray sign(VirgilDataSource& source, const VirgilPrivateKeyHandle& privateKey) const;
+
     /**
      * @brief Verify sign and data provided by the source to be conformed to the given public key.
      * @return true if sign is valid and data was not malformed.
      */
     bool verify(VirgilDataSource& source, const VirgilByteArray& sign, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Verify sign and data provided by the source to be conformed to the given preloaded public key.
+     * @return true if sign is valid and data was not malformed.
+     * @note Public key is not parsed again, and this method can be called concurrently with different sources.
+     */
+    bool verify(VirgilDataSource& source, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey) const;
 };
 
 }}
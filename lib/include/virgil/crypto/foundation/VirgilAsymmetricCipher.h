@@ -358,6 +358,8 @@ public:
      * @return Signed digest.
      * @throw VirgilCryptoException with VirgilCryptoError::UnsupportedAlgorithm,
      *     if current context does not support sign or connected algorithms (Hash, RNG, etc).
+     * @note This method does not modify the key, so it can be called concurrently on the same object,
+     *     while the key is not changed.
      */
     virgil::crypto::VirgilByteArray sign(const virgil::crypto::VirgilByteArray& digest, int hashType) const;
 
@@ -371,6 +373,8 @@ public:
      * @param sign - signed digest to be used during verification.
      * @param hashType - type of the hash algorithm that was used to get digest
      * @return true if given digest corresponds to the given digest sign, otherwise - false.
+     * @note This method does not modify the key, so it can be called concurrently on the same object,
+     *     while the key is not changed.
      */
     bool verify(
             const virgil::crypto::VirgilByteArray& digest,
@@ -39,6 +39,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "../VirgilByteArray.h"
 #include "asn1/VirgilAsn1Compatible.h"
@@ -135,6 +136,19 @@ public:
      * @return Hash of the given message.
      */
     virgil::crypto::VirgilByteArray hash(const virgil::crypto::VirgilByteArray& data) const;
+
+    /**
+     * @brief Produce hash of each given message.
+     *
+     * Process many independent messages at once and return their hashes in the same order.
+     * SHA-2 family is computed over several messages in parallel if CPU supports AVX2 or AVX-512,
+     *     otherwise messages are processed one by one.
+     *
+     * @param messages - messages to be hashed.
+     * @return Hashes of the given messages, identical to the one produced by @link hash() @endlink.
+     */
+    std::vector<virgil::crypto::VirgilByteArray> hashBatch(
+            const std::vector<virgil::crypto::VirgilByteArray>& messages) const;
     ///@}
 
     /**
@@ -73,7 +73,8 @@ public:
         AES_128_CBC, ///< Cipher algorithm: AES-128, mode: CBC
         AES_128_GCM, ///< Cipher algorithm: AES-128, mode: GCM
         AES_256_CBC, ///< Cipher algorithm: AES-256, mode: CBC
-        AES_256_GCM  ///< Cipher algorithm: AES-256, mode: GCM
+        AES_256_GCM, ///< Cipher algorithm: AES-256, mode: GCM
+        CHACHA20_POLY1305 ///< Cipher algorithm: ChaCha20, mode: Poly1305 AEAD (RFC 8439)
     };
     ///@}
 
@@ -93,13 +94,13 @@ public:
 
     /**
      * @brief Create object with given algorithm name.
-     * @note Name format: {ALG}-{LEN}-{MODE}, i.e AES-256-GCM.
+     * @note Name format: {ALG}-{LEN}-{MODE}, i.e AES-256-GCM, or CHACHA20-POLY1305.
      */
     explicit VirgilSymmetricCipher(const std::string& name);
 
     /**
      * @brief Create object with given algorithm name.
-     * @note Name format: {ALG}-{LEN}-{MODE}, i.e AES-256-GCM.
+     * @note Name format: {ALG}-{LEN}-{MODE}, i.e AES-256-GCM, or CHACHA20-POLY1305.
      */
     explicit VirgilSymmetricCipher(const char* name);
     ///@}
@@ -167,6 +168,13 @@ public:
      */
     bool isSupportPadding() const;
 
+    /**
+     * @brief Returns the exact size of the encrypted data for the current configuration.
+     * @param dataSize - size of the data to be encrypted, in octets.
+     * @return Size of the encrypted data with padding and authentication tag, in octets.
+     */
+    size_t defineEncryptedSize(size_t dataSize) const;
+
     /**
      * @brief Return cipher IV, or NONCE_COUNTER for CTR-mode ciphers
      */
@@ -209,7 +217,7 @@ public:
 
     /**
      * @brief Add additional data (for AEAD ciphers).
-     * @note Currently only supported with GCM.
+     * @note Currently only supported with GCM and ChaCha20-Poly1305.
      * @note Must be called before reset().
      * @see isAuthMode()
      */
@@ -258,6 +266,19 @@ public:
      */
     virgil::crypto::VirgilByteArray update(const virgil::crypto::VirgilByteArray& input);
 
+    /**
+     * @brief Generic cipher update function that writes to the caller-provided buffer.
+     *
+     * Behaves exactly as @link update(const virgil::crypto::VirgilByteArray&) @endlink,
+     *     but does not allocate memory for the result.
+     * @param input - data to be encrypted / decrypted.
+     * @param inputLen - input length.
+     * @param output - buffer for encrypted or decrypted bytes (rely on the current mode).
+     * @param outputLen - output buffer length, inputLen + blockSize() is always enough.
+     * @return Number of bytes written to the output.
+     */
+    size_t update(const unsigned char* input, size_t inputLen, unsigned char* output, size_t outputLen);
+
     /**
      * @brief Cipher finalization method.
      *
@@ -267,6 +288,16 @@ public:
      * @return Encrypted or decrypted bytes (rely on the current mode).
      */
     virgil::crypto::VirgilByteArray finish();
+
+    /**
+     * @brief Cipher finalization method that writes to the caller-provided buffer.
+     *
+     * Behaves exactly as @link finish() @endlink, but does not allocate memory for the result.
+     * @param output - buffer for encrypted or decrypted bytes (rely on the current mode).
+     * @param outputLen - output buffer length, blockSize() + authTagLength() is always enough.
+     * @return Number of bytes written to the output.
+     */
+    size_t finish(unsigned char* output, size_t outputLen);
     ///@}
     /**
      * @name VirgilAsn1Compatible implementation
@@ -140,6 +140,29 @@ public:
      */
     size_t readSet();
     ///@}
+    /**
+     * @name Navigation
+     *
+     * Allow to index big ASN.1 structures, and read only required parts of them.
+     */
+    ///@{
+    /**
+     * @brief Return current read position from the beginning of the ASN.1 structure.
+     */
+    size_t getPosition() const;
+
+    /**
+     * @brief Move read position to the given offset from the beginning of the ASN.1 structure.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if position is out of bounds.
+     */
+    void setPosition(size_t position);
+
+    /**
+     * @brief Skip preformatted ASN.1 structure without copying it.
+     * @return Skipped structure size in bytes, including tag and length.
+     */
+    size_t skipData();
+    ///@}
 public:
     /**
      * @brief Delete copy constructor
@@ -114,6 +114,12 @@ public:
      */
     static VirgilOperationCipher getDefault();
 
+    /**
+     * @brief Return ChaCha20-Poly1305 implementation.
+     * @note Prefer it over the default one on platforms without hardware AES support.
+     */
+    static VirgilOperationCipher getChaCha20Poly1305();
+
 private:
     struct Concept {
         virtual size_t doGetKeySize() const = 0;
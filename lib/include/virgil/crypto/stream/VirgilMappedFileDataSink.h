@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H
+#define VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H
+
+#include <string>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataSink.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Memory mapped file implementation of the VirgilDataSink class.
+ *
+ * Data is written directly to the file mapping, that grows on demand.
+ * Disk space is reserved before the mapping grows, so lack of space is reported
+ * with an exception instead of SIGBUS on write.
+ * File is truncated to the written size on @link close() @endlink.
+ *
+ * @note Available on POSIX platforms only.
+ * @note This class CAN not be used in wrappers.
+ */
+class VirgilMappedFileDataSink : public virgil::crypto::VirgilDataSink {
+public:
+    /**
+     * @brief Creates or truncates given file and maps it to the memory for writing.
+     * @param path - path to the file.
+     * @param expectedSize - expected size of the written data, used as initial mapping size.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if file can not be mapped,
+     *     or it is not a regular file.
+     */
+    explicit VirgilMappedFileDataSink(const std::string& path, size_t expectedSize = 0);
+
+    /**
+     * @brief Closes file, if it was not closed explicitly.
+     */
+    virtual ~VirgilMappedFileDataSink() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::isGood() @endlink method.
+     */
+    virtual bool isGood();
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::write() @endlink method.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if file mapping can not be extended,
+     *     for instance there is no space left on the device.
+     */
+    virtual void write(const virgil::crypto::VirgilByteArray& data);
+
+    /**
+     * @brief Unmaps file and truncates it to the written size.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if file can not be truncated.
+     */
+    void close();
+
+    //! @cond Doxygen_Suppress
+    VirgilMappedFileDataSink(const VirgilMappedFileDataSink&) = delete;
+
+    VirgilMappedFileDataSink& operator=(const VirgilMappedFileDataSink&) = delete;
+    //! @endcond
+
+private:
+    void remap(size_t capacity);
+
+private:
+    int fd_;
+    unsigned char* data_;
+    size_t size_;
+    size_t capacity_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H */
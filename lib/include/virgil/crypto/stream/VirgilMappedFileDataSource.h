@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H
+#define VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H
+
+#include <string>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataSource.h"
+#include "../VirgilRandomAccessDataSource.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Memory mapped file implementation of the VirgilDataSource class.
+ *
+ * File is mapped to the memory once, so data is read without intermediate stream buffers.
+ * Also it can be used as VirgilRandomAccessDataSource, and whole file content
+ * can be accessed directly with @link data() @endlink and @link size() @endlink methods.
+ *
+ * @note Available on POSIX platforms only.
+ * @note This class CAN not be used in wrappers.
+ * @warning File MUST not be truncated by other processes while it is mapped:
+ *     access to the mapped pages beyond the new end of the file raises SIGBUS,
+ *     that can not be handled as an exception.
+ *     Use VirgilStreamDataSource for files that can be modified concurrently.
+ */
+class VirgilMappedFileDataSource :
+        public virgil::crypto::VirgilDataSource,
+        public virgil::crypto::VirgilRandomAccessDataSource {
+public:
+    /**
+     * @brief Maps given file to the memory for reading.
+     * @param path - path to the file.
+     * @param chunkSize - size of the data that will be returned by @link read() @endlink method.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if file can not be mapped,
+     *     or it is not a regular file.
+     */
+    explicit VirgilMappedFileDataSource(const std::string& path, size_t chunkSize = 1024 * 1024);
+
+    /**
+     * @brief Unmaps file.
+     */
+    virtual ~VirgilMappedFileDataSource() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::hasData() @endlink method.
+     */
+    virtual bool hasData();
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::read() @endlink method.
+     */
+    virtual virgil::crypto::VirgilByteArray read();
+
+    /**
+     * @brief Overriding of @link VirgilRandomAccessDataSource::read() @endlink method.
+     */
+    virtual virgil::crypto::VirgilByteArray read(size_t offset, size_t length);
+
+    /**
+     * @brief Return pointer to the mapped file content, or nullptr if file is empty.
+     */
+    const unsigned char* data() const;
+
+    /**
+     * @brief Return size of the mapped file content.
+     */
+    size_t size() const;
+
+    //! @cond Doxygen_Suppress
+    VirgilMappedFileDataSource(const VirgilMappedFileDataSource&) = delete;
+
+    VirgilMappedFileDataSource& operator=(const VirgilMappedFileDataSource&) = delete;
+    //! @endcond
+
+private:
+    unsigned char* data_;
+    size_t size_;
+    size_t offset_;
+    size_t chunkSize_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H */
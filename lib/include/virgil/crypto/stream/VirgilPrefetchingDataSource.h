@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_PREFETCHING_DATA_SOURCE_H
+#define VIRGIL_CRYPTO_VIRGIL_PREFETCHING_DATA_SOURCE_H
+
+#include <memory>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataSource.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Adapter that reads given data source ahead in the background thread.
+ *
+ * Read data is kept in the bounded queue, so reading of the next portion
+ * overlaps with processing of the current one. Queued portions are returned as is, without copying.
+ * Exception thrown by the wrapped source is rethrown by @link read() @endlink.
+ *
+ * @note Wrapped source is accessed only from the background thread until this object is destroyed.
+ * @note If library is built without VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, wrapped source is read synchronously.
+ * @note This class CAN not be used in wrappers.
+ */
+class VirgilPrefetchingDataSource : public virgil::crypto::VirgilDataSource {
+public:
+    /**
+     * @brief Starts reading of the given source in the background thread.
+     * @param source - wrapped data source.
+     * @param queueSize - maximum number of portions read ahead.
+     */
+    explicit VirgilPrefetchingDataSource(virgil::crypto::VirgilDataSource& source, size_t queueSize = 4);
+
+    /**
+     * @brief Stops background reading.
+     */
+    virtual ~VirgilPrefetchingDataSource() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::hasData() @endlink method.
+     */
+    virtual bool hasData();
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::read() @endlink method.
+     */
+    virtual virgil::crypto::VirgilByteArray read();
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_PREFETCHING_DATA_SOURCE_H */
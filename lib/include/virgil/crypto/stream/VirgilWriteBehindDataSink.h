@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_WRITE_BEHIND_DATA_SINK_H
+#define VIRGIL_CRYPTO_VIRGIL_WRITE_BEHIND_DATA_SINK_H
+
+#include <memory>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataSink.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Adapter that writes to the given data sink in the background thread.
+ *
+ * Written data is kept in the bounded queue, so writing of the previous portion
+ * overlaps with producing of the next one.
+ * Exception thrown by the wrapped sink is rethrown by the next @link write() @endlink or @link flush() @endlink.
+ *
+ * @note Wrapped sink is accessed only from the background thread until this object is destroyed.
+ * @note If library is built without VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, wrapped sink is written synchronously.
+ * @note This class CAN not be used in wrappers.
+ */
+class VirgilWriteBehindDataSink : public virgil::crypto::VirgilDataSink {
+public:
+    /**
+     * @brief Starts writing to the given sink in the background thread.
+     * @param sink - wrapped data sink.
+     * @param queueSize - maximum number of portions waiting to be written.
+     */
+    explicit VirgilWriteBehindDataSink(virgil::crypto::VirgilDataSink& sink, size_t queueSize = 4);
+
+    /**
+     * @brief Writes queued data and stops background writing.
+     * @note Errors are ignored, call @link flush() @endlink before to handle them.
+     */
+    virtual ~VirgilWriteBehindDataSink() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::isGood() @endlink method.
+     * @return State of the wrapped sink after the last written portion.
+     */
+    virtual bool isGood();
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::write() @endlink method.
+     */
+    virtual void write(const virgil::crypto::VirgilByteArray& data);
+
+    /**
+     * @brief Wait until all queued data is written to the wrapped sink.
+     */
+    void flush();
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_WRITE_BEHIND_DATA_SINK_H */
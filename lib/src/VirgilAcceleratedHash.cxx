@@ -0,0 +1,461 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilAcceleratedHash.h"
+#include "VirgilCpuFeatures.h"
+#include "VirgilSha2Constants.h"
+#include "utils.h"
+
+#include <mbedtls/md_internal.h>
+#include <mbedtls/platform.h>
+#include <mbedtls/version.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+#include <immintrin.h>
+#endif
+
+using virgil::crypto::foundation::internal::VirgilAcceleratedHash;
+using virgil::crypto::foundation::internal::VirgilCpuFeatures;
+using virgil::crypto::foundation::internal::sha2::kSha224Init;
+using virgil::crypto::foundation::internal::sha2::kSha256Init;
+using virgil::crypto::foundation::internal::sha2::kSha384Init;
+using virgil::crypto::foundation::internal::sha2::kSha512Init;
+using virgil::crypto::foundation::internal::sha2::kSha256K;
+using virgil::crypto::foundation::internal::sha2::kSha512K;
+using virgil::crypto::internal::secure_zeroize;
+
+namespace {
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+
+/**
+ * @brief Four SHA-256 rounds with SHA-NI, message words of rounds are in the msg.
+ */
+#define VIRGIL_SHA256_NI_ROUNDS(msg, i) \
+    do { \
+        __m128i wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kSha256K + 4 * (i)))); \
+        state1 = _mm_sha256rnds2_epu32(state1, state0, wk); \
+        wk = _mm_shuffle_epi32(wk, 0x0e); \
+        state0 = _mm_sha256rnds2_epu32(state0, state1, wk); \
+    } while (0)
+
+/**
+ * @brief Four SHA-256 rounds with SHA-NI, that also finish message schedule of the next words.
+ */
+#define VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg, next, prev, i) \
+    do { \
+        __m128i wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kSha256K + 4 * (i)))); \
+        state1 = _mm_sha256rnds2_epu32(state1, state0, wk); \
+        next = _mm_sha256msg2_epu32(_mm_add_epi32(next, _mm_alignr_epi8(msg, prev, 4)), msg); \
+        wk = _mm_shuffle_epi32(wk, 0x0e); \
+        state0 = _mm_sha256rnds2_epu32(state0, state1, wk); \
+    } while (0)
+
+VIRGIL_CRYPTO_X86_TARGET("sha,sse4.1,ssse3")
+void sha256_process_shani(uint32_t* state, const unsigned char* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Instructions expect state as ABEF and CDGH.
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+
+        __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byteSwap);
+        __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), byteSwap);
+        __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), byteSwap);
+        __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), byteSwap);
+
+        VIRGIL_SHA256_NI_ROUNDS(msg0, 0);
+        VIRGIL_SHA256_NI_ROUNDS(msg1, 1);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+        VIRGIL_SHA256_NI_ROUNDS(msg2, 2);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg3, msg0, msg2, 3);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg0, msg1, msg3, 4);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg1, msg2, msg0, 5);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg2, msg3, msg1, 6);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg3, msg0, msg2, 7);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg0, msg1, msg3, 8);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg1, msg2, msg0, 9);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg2, msg3, msg1, 10);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg3, msg0, msg2, 11);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg0, msg1, msg3, 12);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg1, msg2, msg0, 13);
+        VIRGIL_SHA256_NI_ROUNDS_SCHEDULE(msg2, msg3, msg1, 14);
+        VIRGIL_SHA256_NI_ROUNDS(msg3, 15);
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#undef VIRGIL_SHA256_NI_ROUNDS
+#undef VIRGIL_SHA256_NI_ROUNDS_SCHEDULE
+
+#define VIRGIL_SHA512_ROTR_X2(x, n) _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - (n)))
+
+/**
+ * @brief Compute two words of the SHA-512 message schedule, and store them with added round constants.
+ *
+ * The x0 holds words W[t-16], W[t-15] and is replaced with W[t], W[t+1].
+ */
+#define VIRGIL_SHA512_SCHEDULE_X2(t, x0, x1, x4, x5, x7) \
+    do { \
+        const __m128i w15 = _mm_alignr_epi8(x1, x0, 8); \
+        const __m128i w7 = _mm_alignr_epi8(x5, x4, 8); \
+        const __m128i s0 = _mm_xor_si128(_mm_xor_si128(VIRGIL_SHA512_ROTR_X2(w15, 1), VIRGIL_SHA512_ROTR_X2(w15, 8)), \
+                _mm_srli_epi64(w15, 7)); \
+        const __m128i s1 = _mm_xor_si128(_mm_xor_si128(VIRGIL_SHA512_ROTR_X2(x7, 19), VIRGIL_SHA512_ROTR_X2(x7, 61)), \
+                _mm_srli_epi64(x7, 6)); \
+        x0 = _mm_add_epi64(_mm_add_epi64(x0, s0), _mm_add_epi64(w7, s1)); \
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + (t)), \
+                _mm_add_epi64(x0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kSha512K + (t))))); \
+    } while (0)
+
+#define VIRGIL_SHA512_ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define VIRGIL_SHA512_ROUND(a, b, c, d, e, f, g, h, t) \
+    do { \
+        const uint64_t t1 = h + (VIRGIL_SHA512_ROTR(e, 14) ^ VIRGIL_SHA512_ROTR(e, 18) ^ VIRGIL_SHA512_ROTR(e, 41)) + \
+                (g ^ (e & (f ^ g))) + wk[t]; \
+        const uint64_t t2 = (VIRGIL_SHA512_ROTR(a, 28) ^ VIRGIL_SHA512_ROTR(a, 34) ^ VIRGIL_SHA512_ROTR(a, 39)) + \
+                ((a & b) | (c & (a | b))); \
+        d += t1; \
+        h = t1 + t2; \
+    } while (0)
+
+VIRGIL_CRYPTO_X86_TARGET("ssse3")
+void sha512_process_ssse3(uint64_t* state, const unsigned char* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+    alignas(16) uint64_t wk[80];
+
+    for (; blocks > 0; --blocks, data += 128) {
+        // Message schedule is computed two words at a time, then rounds consume it with added constants.
+        __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byteSwap);
+        __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), byteSwap);
+        __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), byteSwap);
+        __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), byteSwap);
+        __m128i x4 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 64)), byteSwap);
+        __m128i x5 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 80)), byteSwap);
+        __m128i x6 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 96)), byteSwap);
+        __m128i x7 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 112)), byteSwap);
+        const __m128i* k = reinterpret_cast<const __m128i*>(kSha512K);
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk), _mm_add_epi64(x0, _mm_loadu_si128(k)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 2), _mm_add_epi64(x1, _mm_loadu_si128(k + 1)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 4), _mm_add_epi64(x2, _mm_loadu_si128(k + 2)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 6), _mm_add_epi64(x3, _mm_loadu_si128(k + 3)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 8), _mm_add_epi64(x4, _mm_loadu_si128(k + 4)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 10), _mm_add_epi64(x5, _mm_loadu_si128(k + 5)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 12), _mm_add_epi64(x6, _mm_loadu_si128(k + 6)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk + 14), _mm_add_epi64(x7, _mm_loadu_si128(k + 7)));
+        for (size_t t = 16; t < 80; t += 16) {
+            VIRGIL_SHA512_SCHEDULE_X2(t, x0, x1, x4, x5, x7);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 2, x1, x2, x5, x6, x0);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 4, x2, x3, x6, x7, x1);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 6, x3, x4, x7, x0, x2);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 8, x4, x5, x0, x1, x3);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 10, x5, x6, x1, x2, x4);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 12, x6, x7, x2, x3, x5);
+            VIRGIL_SHA512_SCHEDULE_X2(t + 14, x7, x0, x3, x4, x6);
+        }
+
+        uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (size_t t = 0; t < 80; t += 8) {
+            VIRGIL_SHA512_ROUND(a, b, c, d, e, f, g, h, t);
+            VIRGIL_SHA512_ROUND(h, a, b, c, d, e, f, g, t + 1);
+            VIRGIL_SHA512_ROUND(g, h, a, b, c, d, e, f, t + 2);
+            VIRGIL_SHA512_ROUND(f, g, h, a, b, c, d, e, t + 3);
+            VIRGIL_SHA512_ROUND(e, f, g, h, a, b, c, d, t + 4);
+            VIRGIL_SHA512_ROUND(d, e, f, g, h, a, b, c, t + 5);
+            VIRGIL_SHA512_ROUND(c, d, e, f, g, h, a, b, t + 6);
+            VIRGIL_SHA512_ROUND(b, c, d, e, f, g, h, a, t + 7);
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    volatile uint64_t* p = wk;
+    for (size_t i = 0; i < 80; ++i) { p[i] = 0; }
+}
+
+#undef VIRGIL_SHA512_ROTR_X2
+#undef VIRGIL_SHA512_SCHEDULE_X2
+#undef VIRGIL_SHA512_ROTR
+#undef VIRGIL_SHA512_ROUND
+
+#endif /* VIRGIL_CRYPTO_X86_ENABLED */
+
+template<typename Word>
+using sha2_process_fn = void (*)(Word* state, const unsigned char* data, size_t blocks);
+
+sha2_process_fn<uint32_t> select_sha256_process() noexcept {
+#if VIRGIL_CRYPTO_X86_ENABLED
+    if (VirgilCpuFeatures::hasShaNi()) {
+        return sha256_process_shani;
+    }
+#endif
+    return nullptr;
+}
+
+sha2_process_fn<uint64_t> select_sha512_process() noexcept {
+#if VIRGIL_CRYPTO_X86_ENABLED
+    if (VirgilCpuFeatures::hasSsse3()) {
+        return sha512_process_ssse3;
+    }
+#endif
+    return nullptr;
+}
+
+template<typename Word>
+sha2_process_fn<Word> get_process() noexcept;
+
+template<>
+sha2_process_fn<uint32_t> get_process<uint32_t>() noexcept {
+    static const sha2_process_fn<uint32_t> process = select_sha256_process();
+    return process;
+}
+
+template<>
+sha2_process_fn<uint64_t> get_process<uint64_t>() noexcept {
+    static const sha2_process_fn<uint64_t> process = select_sha512_process();
+    return process;
+}
+
+/**
+ * @brief Implements MbedTLS message digest callbacks over the accelerated SHA-2 compression function.
+ */
+template<typename Word, const Word* Init, size_t DigestSize>
+class sha2_md {
+public:
+    static constexpr size_t kBlockSize = 16 * sizeof(Word);
+
+    struct context {
+        Word state[8];
+        uint64_t total;
+        unsigned char buffer[kBlockSize];
+    };
+
+    static void starts(void* ctx) {
+        auto c = static_cast<context*>(ctx);
+        std::memcpy(c->state, Init, sizeof(c->state));
+        c->total = 0;
+    }
+
+    static void update(void* ctx, const unsigned char* input, size_t ilen) {
+        auto c = static_cast<context*>(ctx);
+        const auto process = get_process<Word>();
+        size_t used = static_cast<size_t>(c->total % kBlockSize);
+        c->total += ilen;
+        if (used > 0) {
+            const size_t fill = kBlockSize - used;
+            if (ilen < fill) {
+                std::memcpy(c->buffer + used, input, ilen);
+                return;
+            }
+            std::memcpy(c->buffer + used, input, fill);
+            process(c->state, c->buffer, 1);
+            input += fill;
+            ilen -= fill;
+        }
+        const size_t blocks = ilen / kBlockSize;
+        if (blocks > 0) {
+            process(c->state, input, blocks);
+            input += blocks * kBlockSize;
+            ilen -= blocks * kBlockSize;
+        }
+        if (ilen > 0) {
+            std::memcpy(c->buffer, input, ilen);
+        }
+    }
+
+    static void finish(void* ctx, unsigned char* output) {
+        auto c = static_cast<context*>(ctx);
+        const auto process = get_process<Word>();
+        constexpr size_t kLengthSize = 2 * sizeof(Word);
+        size_t used = static_cast<size_t>(c->total % kBlockSize);
+        c->buffer[used++] = 0x80;
+        if (used > kBlockSize - kLengthSize) {
+            std::memset(c->buffer + used, 0, kBlockSize - used);
+            process(c->state, c->buffer, 1);
+            used = 0;
+        }
+        std::memset(c->buffer + used, 0, kBlockSize - used);
+        // Message length in bits, SHA-384/512 length is 128 bits wide.
+        const uint64_t bitLen = c->total << 3;
+        for (size_t i = 0; i < 8; ++i) {
+            c->buffer[kBlockSize - 1 - i] = static_cast<unsigned char>(bitLen >> (8 * i));
+        }
+        if (kLengthSize > 8) {
+            c->buffer[kBlockSize - 9] = static_cast<unsigned char>(c->total >> 61);
+        }
+        process(c->state, c->buffer, 1);
+        for (size_t i = 0; i < DigestSize; ++i) {
+            output[i] = static_cast<unsigned char>(
+                    c->state[i / sizeof(Word)] >> (8 * (sizeof(Word) - 1 - i % sizeof(Word))));
+        }
+    }
+
+    static void digest(const unsigned char* input, size_t ilen, unsigned char* output) {
+        context ctx;
+        starts(&ctx);
+        update(&ctx, input, ilen);
+        finish(&ctx, output);
+        secure_zeroize(&ctx, sizeof(ctx));
+    }
+
+    // Context is allocated with mbedtls_calloc(), like the contexts of the mbedtls own hashes.
+    static void* alloc_ctx() {
+        void* storage = mbedtls_calloc(1, sizeof(context));
+        return storage != nullptr ? new(storage) context() : nullptr;
+    }
+
+    // Not named free(), because mbedtls_free can be defined as free, so the call would recurse.
+    static void free_ctx(void* ctx) {
+        if (ctx == nullptr) {
+            return;
+        }
+        auto c = static_cast<context*>(ctx);
+        secure_zeroize(c, sizeof(context));
+        c->~context();
+        mbedtls_free(c);
+    }
+
+    static void clone(void* dst, const void* src) {
+        *static_cast<context*>(dst) = *static_cast<const context*>(src);
+    }
+
+    static void process(void* ctx, const unsigned char* data) {
+        get_process<Word>()(static_cast<context*>(ctx)->state, data, 1);
+    }
+};
+
+using sha224_md = sha2_md<uint32_t, kSha224Init, 28>;
+using sha256_md = sha2_md<uint32_t, kSha256Init, 32>;
+using sha384_md = sha2_md<uint64_t, kSha384Init, 48>;
+using sha512_md = sha2_md<uint64_t, kSha512Init, 64>;
+
+/**
+ * @name Layout of the mbedtls_md_info_t
+ *
+ * Structure is internal to MbedTLS (md_internal.h), so it is checked against the pinned version
+ * (libs_ext/mbedtls/mbedtls.cmake) to be updated together with it.
+ */
+///@{
+static_assert(MBEDTLS_VERSION_NUMBER >= 0x02040000 && MBEDTLS_VERSION_NUMBER < 0x02050000,
+        "Layout of mbedtls_md_info_t is checked for MbedTLS 2.4 only, revise make_md_info().");
+static_assert(offsetof(mbedtls_md_info_t, type) == 0 &&
+        offsetof(mbedtls_md_info_t, name) < offsetof(mbedtls_md_info_t, size) &&
+        offsetof(mbedtls_md_info_t, size) < offsetof(mbedtls_md_info_t, block_size) &&
+        offsetof(mbedtls_md_info_t, block_size) < offsetof(mbedtls_md_info_t, starts_func) &&
+        offsetof(mbedtls_md_info_t, starts_func) < offsetof(mbedtls_md_info_t, update_func) &&
+        offsetof(mbedtls_md_info_t, update_func) < offsetof(mbedtls_md_info_t, finish_func) &&
+        offsetof(mbedtls_md_info_t, finish_func) < offsetof(mbedtls_md_info_t, digest_func) &&
+        offsetof(mbedtls_md_info_t, digest_func) < offsetof(mbedtls_md_info_t, ctx_alloc_func) &&
+        offsetof(mbedtls_md_info_t, ctx_alloc_func) < offsetof(mbedtls_md_info_t, ctx_free_func) &&
+        offsetof(mbedtls_md_info_t, ctx_free_func) < offsetof(mbedtls_md_info_t, clone_func) &&
+        offsetof(mbedtls_md_info_t, clone_func) < offsetof(mbedtls_md_info_t, process_func),
+        "Fields of mbedtls_md_info_t are not in the order expected by make_md_info().");
+static_assert(sizeof(mbedtls_md_info_t) ==
+        offsetof(mbedtls_md_info_t, process_func) + sizeof(mbedtls_md_info_t::process_func),
+        "Structure mbedtls_md_info_t has fields unknown to make_md_info().");
+///@}
+
+template<typename Md>
+constexpr mbedtls_md_info_t make_md_info(mbedtls_md_type_t type, const char* name, int size) {
+    return {
+            type, name, size, static_cast<int>(Md::kBlockSize),
+            Md::starts, Md::update, Md::finish, Md::digest, Md::alloc_ctx, Md::free_ctx, Md::clone, Md::process
+    };
+}
+
+const mbedtls_md_info_t kSha224Info = make_md_info<sha224_md>(MBEDTLS_MD_SHA224, "SHA224", 28);
+const mbedtls_md_info_t kSha256Info = make_md_info<sha256_md>(MBEDTLS_MD_SHA256, "SHA256", 32);
+const mbedtls_md_info_t kSha384Info = make_md_info<sha384_md>(MBEDTLS_MD_SHA384, "SHA384", 48);
+const mbedtls_md_info_t kSha512Info = make_md_info<sha512_md>(MBEDTLS_MD_SHA512, "SHA512", 64);
+
+}
+
+const mbedtls_md_info_t* VirgilAcceleratedHash::mdInfo(const mbedtls_md_info_t* info) noexcept {
+    if (info == nullptr) {
+        return info;
+    }
+    switch (mbedtls_md_get_type(info)) {
+        case MBEDTLS_MD_SHA224:
+            return get_process<uint32_t>() ? &kSha224Info : info;
+        case MBEDTLS_MD_SHA256:
+            return get_process<uint32_t>() ? &kSha256Info : info;
+        case MBEDTLS_MD_SHA384:
+            return get_process<uint64_t>() ? &kSha384Info : info;
+        case MBEDTLS_MD_SHA512:
+            return get_process<uint64_t>() ? &kSha512Info : info;
+        default:
+            return info;
+    }
+}
+
+const mbedtls_md_info_t* VirgilAcceleratedHash::mdInfoFromType(mbedtls_md_type_t type) noexcept {
+    return mdInfo(mbedtls_md_info_from_type(type));
+}
+
+const mbedtls_md_info_t* VirgilAcceleratedHash::mdInfoFromString(const char* name) noexcept {
+    return mdInfo(mbedtls_md_info_from_string(name));
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_ACCELERATED_HASH_H
+#define VIRGIL_CRYPTO_ACCELERATED_HASH_H
+
+#include <mbedtls/md.h>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Hardware accelerated drop-in replacements of the MbedTLS message digests.
+ *
+ * SHA-224/256 are computed with SHA extensions (SHA-NI),
+ * SHA-384/512 are computed with message schedule vectorized by SSSE3.
+ *
+ * Replacement is a regular MbedTLS message digest info with the same type, name and sizes,
+ * so it can be used anywhere MbedTLS expects one, including HMAC, KDF and PBKDF2.
+ */
+class VirgilAcceleratedHash {
+public:
+    /**
+     * @brief Return accelerated replacement of the given message digest info.
+     * @return Given info, if it can not be accelerated on the current CPU.
+     */
+    static const mbedtls_md_info_t* mdInfo(const mbedtls_md_info_t* info) noexcept;
+
+    /**
+     * @brief Return accelerated message digest info of the given type.
+     * @see mdInfo()
+     */
+    static const mbedtls_md_info_t* mdInfoFromType(mbedtls_md_type_t type) noexcept;
+
+    /**
+     * @brief Return accelerated message digest info of the given name.
+     * @see mdInfo()
+     */
+    static const mbedtls_md_info_t* mdInfoFromString(const char* name) noexcept;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_ACCELERATED_HASH_H */
@@ -0,0 +1,492 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilAesNiGcm.h"
+#include "VirgilCpuFeatures.h"
+#include "utils.h"
+
+#include <cstring>
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+#define VIRGIL_AES_NI_GCM_ENABLED 1
+#define VIRGIL_AES_NI_TARGET VIRGIL_CRYPTO_X86_TARGET("aes,pclmul,ssse3")
+#else
+#define VIRGIL_AES_NI_GCM_ENABLED 0
+#endif
+
+#if VIRGIL_AES_NI_GCM_ENABLED
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+using virgil::crypto::foundation::internal::VirgilAesNiGcm;
+using virgil::crypto::foundation::internal::VirgilCpuFeatures;
+using virgil::crypto::internal::secure_zeroize;
+
+static constexpr size_t kBlockSize = 16;
+static constexpr size_t kParallelBlocks = 8;
+//! Maximum length of the data processed with one IV, the same limit is applied by the mbedtls GCM.
+static constexpr uint64_t kMaxDataLen = (static_cast<uint64_t>(1) << 36) - 32;
+
+#if VIRGIL_AES_NI_GCM_ENABLED
+
+/**
+ * @brief Mask of the first N bytes of the block is loaded from the offset (16 - N).
+ */
+alignas(16) static const unsigned char kPartialBlockMask[2 * kBlockSize] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+namespace {
+
+/**
+ * @brief Byte order of the GHASH operands is reversed, so blocks can be multiplied as integers.
+ */
+VIRGIL_AES_NI_TARGET inline __m128i byte_swap(__m128i block) {
+    return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/**
+ * @brief Counter is kept in the little-endian 32-bit lane, so it can be incremented with one addition.
+ */
+VIRGIL_AES_NI_TARGET inline __m128i counter_swap(__m128i block) {
+    return _mm_shuffle_epi8(block, _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+VIRGIL_AES_NI_TARGET inline __m128i load_block(const unsigned char* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+VIRGIL_AES_NI_TARGET inline void store_block(unsigned char* data, __m128i block) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), block);
+}
+
+VIRGIL_AES_NI_TARGET inline __m128i load_partial_block(const unsigned char* data, size_t dataLen) {
+    alignas(16) unsigned char block[kBlockSize] = { 0 };
+    std::memcpy(block, data, dataLen);
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+}
+
+VIRGIL_AES_NI_TARGET inline __m128i encrypt_block(__m128i block, const __m128i* roundKeys, size_t rounds) {
+    block = _mm_xor_si128(block, roundKeys[0]);
+    for (size_t i = 1; i < rounds; ++i) {
+        block = _mm_aesenc_si128(block, roundKeys[i]);
+    }
+    return _mm_aesenclast_si128(block, roundKeys[rounds]);
+}
+
+VIRGIL_AES_NI_TARGET inline __m128i expand_key_step(__m128i key, __m128i assist) {
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+#define VIRGIL_AES128_EXPAND(i, rcon) \
+    roundKeys[i] = expand_key_step(roundKeys[i - 1], \
+            _mm_shuffle_epi32(_mm_aeskeygenassist_si128(roundKeys[i - 1], rcon), 0xff))
+
+VIRGIL_AES_NI_TARGET void expand_key_128(const unsigned char* key, __m128i* roundKeys) {
+    roundKeys[0] = load_block(key);
+    VIRGIL_AES128_EXPAND(1, 0x01);
+    VIRGIL_AES128_EXPAND(2, 0x02);
+    VIRGIL_AES128_EXPAND(3, 0x04);
+    VIRGIL_AES128_EXPAND(4, 0x08);
+    VIRGIL_AES128_EXPAND(5, 0x10);
+    VIRGIL_AES128_EXPAND(6, 0x20);
+    VIRGIL_AES128_EXPAND(7, 0x40);
+    VIRGIL_AES128_EXPAND(8, 0x80);
+    VIRGIL_AES128_EXPAND(9, 0x1b);
+    VIRGIL_AES128_EXPAND(10, 0x36);
+}
+
+#undef VIRGIL_AES128_EXPAND
+
+#define VIRGIL_AES256_EXPAND_EVEN(i, rcon) \
+    roundKeys[i] = expand_key_step(roundKeys[i - 2], \
+            _mm_shuffle_epi32(_mm_aeskeygenassist_si128(roundKeys[i - 1], rcon), 0xff))
+
+#define VIRGIL_AES256_EXPAND_ODD(i) \
+    roundKeys[i] = expand_key_step(roundKeys[i - 2], \
+            _mm_shuffle_epi32(_mm_aeskeygenassist_si128(roundKeys[i - 1], 0x00), 0xaa))
+
+VIRGIL_AES_NI_TARGET void expand_key_256(const unsigned char* key, __m128i* roundKeys) {
+    roundKeys[0] = load_block(key);
+    roundKeys[1] = load_block(key + kBlockSize);
+    VIRGIL_AES256_EXPAND_EVEN(2, 0x01);
+    VIRGIL_AES256_EXPAND_ODD(3);
+    VIRGIL_AES256_EXPAND_EVEN(4, 0x02);
+    VIRGIL_AES256_EXPAND_ODD(5);
+    VIRGIL_AES256_EXPAND_EVEN(6, 0x04);
+    VIRGIL_AES256_EXPAND_ODD(7);
+    VIRGIL_AES256_EXPAND_EVEN(8, 0x08);
+    VIRGIL_AES256_EXPAND_ODD(9);
+    VIRGIL_AES256_EXPAND_EVEN(10, 0x10);
+    VIRGIL_AES256_EXPAND_ODD(11);
+    VIRGIL_AES256_EXPAND_EVEN(12, 0x20);
+    VIRGIL_AES256_EXPAND_ODD(13);
+    VIRGIL_AES256_EXPAND_EVEN(14, 0x40);
+}
+
+#undef VIRGIL_AES256_EXPAND_EVEN
+#undef VIRGIL_AES256_EXPAND_ODD
+
+/**
+ * @brief Unreduced 256-bit product of the GF(2^128) elements.
+ */
+struct ghash_product {
+    __m128i lo;
+    __m128i mid;
+    __m128i hi;
+};
+
+VIRGIL_AES_NI_TARGET inline void ghash_multiply_add(ghash_product& product, __m128i a, __m128i b) {
+    product.lo = _mm_xor_si128(product.lo, _mm_clmulepi64_si128(a, b, 0x00));
+    product.hi = _mm_xor_si128(product.hi, _mm_clmulepi64_si128(a, b, 0x11));
+    product.mid = _mm_xor_si128(product.mid, _mm_clmulepi64_si128(a, b, 0x01));
+    product.mid = _mm_xor_si128(product.mid, _mm_clmulepi64_si128(a, b, 0x10));
+}
+
+/**
+ * @brief Reduce product modulo x^128 + x^7 + x^2 + x + 1 within bit-reflected representation.
+ */
+VIRGIL_AES_NI_TARGET inline __m128i ghash_reduce(const ghash_product& product) {
+    __m128i lo = _mm_xor_si128(product.lo, _mm_slli_si128(product.mid, 8));
+    __m128i hi = _mm_xor_si128(product.hi, _mm_srli_si128(product.mid, 8));
+
+    // Shift 256-bit value left by one bit to compensate bit reflection.
+    __m128i loCarry = _mm_srli_epi32(lo, 31);
+    __m128i hiCarry = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    const __m128i midCarry = _mm_srli_si128(loCarry, 12);
+    hiCarry = _mm_slli_si128(hiCarry, 4);
+    loCarry = _mm_slli_si128(loCarry, 4);
+    lo = _mm_or_si128(lo, loCarry);
+    hi = _mm_or_si128(hi, hiCarry);
+    hi = _mm_or_si128(hi, midCarry);
+
+    // First phase of the reduction.
+    __m128i t1 = _mm_slli_epi32(lo, 31);
+    __m128i t2 = _mm_slli_epi32(lo, 30);
+    __m128i t3 = _mm_slli_epi32(lo, 25);
+    t1 = _mm_xor_si128(t1, t2);
+    t1 = _mm_xor_si128(t1, t3);
+    const __m128i t4 = _mm_srli_si128(t1, 4);
+    t1 = _mm_slli_si128(t1, 12);
+    lo = _mm_xor_si128(lo, t1);
+
+    // Second phase of the reduction.
+    __m128i t5 = _mm_srli_epi32(lo, 1);
+    t2 = _mm_srli_epi32(lo, 2);
+    t3 = _mm_srli_epi32(lo, 7);
+    t5 = _mm_xor_si128(t5, t2);
+    t5 = _mm_xor_si128(t5, t3);
+    t5 = _mm_xor_si128(t5, t4);
+    lo = _mm_xor_si128(lo, t5);
+    return _mm_xor_si128(hi, lo);
+}
+
+VIRGIL_AES_NI_TARGET inline __m128i ghash_multiply(__m128i a, __m128i b) {
+    ghash_product product = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+    ghash_multiply_add(product, a, b);
+    return ghash_reduce(product);
+}
+
+/**
+ * @brief Absorb given blocks (byte order is not swapped yet) to the hash, tail is padded with zeros.
+ */
+VIRGIL_AES_NI_TARGET __m128i ghash_update(
+        __m128i hash, const __m128i* hashKeyPowers, const unsigned char* data, size_t dataLen) {
+    for (; dataLen >= kParallelBlocks * kBlockSize; dataLen -= kParallelBlocks * kBlockSize) {
+        ghash_product product = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+        for (size_t i = 0; i < kParallelBlocks; ++i) {
+            __m128i block = byte_swap(load_block(data + i * kBlockSize));
+            if (i == 0) {
+                block = _mm_xor_si128(block, hash);
+            }
+            ghash_multiply_add(product, block, hashKeyPowers[kParallelBlocks - 1 - i]);
+        }
+        hash = ghash_reduce(product);
+        data += kParallelBlocks * kBlockSize;
+    }
+    for (; dataLen >= kBlockSize; dataLen -= kBlockSize) {
+        hash = ghash_multiply(_mm_xor_si128(hash, byte_swap(load_block(data))), hashKeyPowers[0]);
+        data += kBlockSize;
+    }
+    if (dataLen > 0) {
+        hash = ghash_multiply(_mm_xor_si128(hash, byte_swap(load_partial_block(data, dataLen))), hashKeyPowers[0]);
+    }
+    return hash;
+}
+
+VIRGIL_AES_NI_TARGET void set_key(
+        const unsigned char* key, size_t rounds, unsigned char* roundKeysBytes, unsigned char* hashKeyPowersBytes) {
+    __m128i roundKeys[15];
+    if (rounds == 10) {
+        expand_key_128(key, roundKeys);
+    } else {
+        expand_key_256(key, roundKeys);
+    }
+    __m128i hashKeyPowers[kParallelBlocks];
+    hashKeyPowers[0] = byte_swap(encrypt_block(_mm_setzero_si128(), roundKeys, rounds));
+    for (size_t i = 1; i < kParallelBlocks; ++i) {
+        hashKeyPowers[i] = ghash_multiply(hashKeyPowers[i - 1], hashKeyPowers[0]);
+    }
+    std::memcpy(roundKeysBytes, roundKeys, (rounds + 1) * kBlockSize);
+    std::memcpy(hashKeyPowersBytes, hashKeyPowers, sizeof(hashKeyPowers));
+    secure_zeroize(roundKeys, sizeof(roundKeys));
+    secure_zeroize(hashKeyPowers, sizeof(hashKeyPowers));
+}
+
+VIRGIL_AES_NI_TARGET void start(
+        const unsigned char* roundKeysBytes, size_t rounds, const unsigned char* hashKeyPowersBytes,
+        const unsigned char* iv, size_t ivLen, const unsigned char* authData, size_t authDataLen,
+        unsigned char* counterBytes, unsigned char* hashBytes, unsigned char* baseEncryptedCounterBytes) {
+    const __m128i* roundKeys = reinterpret_cast<const __m128i*>(roundKeysBytes);
+    const __m128i* hashKeyPowers = reinterpret_cast<const __m128i*>(hashKeyPowersBytes);
+
+    __m128i counter;
+    if (ivLen == 12) {
+        alignas(16) unsigned char block[kBlockSize] = { 0 };
+        std::memcpy(block, iv, ivLen);
+        block[kBlockSize - 1] = 1;
+        counter = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+    } else {
+        alignas(16) unsigned char lengths[kBlockSize] = { 0 };
+        const uint64_t ivBitLen = static_cast<uint64_t>(ivLen) * 8;
+        for (size_t i = 0; i < 8; ++i) {
+            lengths[kBlockSize - 1 - i] = static_cast<unsigned char>(ivBitLen >> (8 * i));
+        }
+        __m128i ivHash = ghash_update(_mm_setzero_si128(), hashKeyPowers, iv, ivLen);
+        ivHash = ghash_update(ivHash, hashKeyPowers, lengths, kBlockSize);
+        counter = byte_swap(ivHash);
+    }
+    store_block(baseEncryptedCounterBytes, encrypt_block(counter, roundKeys, rounds));
+    store_block(counterBytes, counter_swap(counter));
+    store_block(hashBytes, ghash_update(_mm_setzero_si128(), hashKeyPowers, authData, authDataLen));
+}
+
+VIRGIL_AES_NI_TARGET void update(
+        const unsigned char* roundKeysBytes, size_t rounds, const unsigned char* hashKeyPowersBytes,
+        const unsigned char* input, size_t inputLen, unsigned char* output, bool isEncryption,
+        unsigned char* counterBytes, unsigned char* hashBytes) {
+    const __m128i* roundKeys = reinterpret_cast<const __m128i*>(roundKeysBytes);
+    const __m128i* hashKeyPowers = reinterpret_cast<const __m128i*>(hashKeyPowersBytes);
+    const __m128i one = _mm_set_epi32(1, 0, 0, 0);
+
+    __m128i counter = load_block(counterBytes);
+    __m128i hash = load_block(hashBytes);
+
+    for (; inputLen >= kParallelBlocks * kBlockSize; inputLen -= kParallelBlocks * kBlockSize) {
+        __m128i blocks[kParallelBlocks];
+        for (size_t i = 0; i < kParallelBlocks; ++i) {
+            counter = _mm_add_epi32(counter, one);
+            blocks[i] = _mm_xor_si128(counter_swap(counter), roundKeys[0]);
+        }
+        for (size_t round = 1; round < rounds; ++round) {
+            const __m128i roundKey = roundKeys[round];
+            for (size_t i = 0; i < kParallelBlocks; ++i) {
+                blocks[i] = _mm_aesenc_si128(blocks[i], roundKey);
+            }
+        }
+        ghash_product product = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+        for (size_t i = 0; i < kParallelBlocks; ++i) {
+            // Input is read before the output is written, so in-place processing is safe.
+            const __m128i inputBlock = load_block(input + i * kBlockSize);
+            const __m128i outputBlock = _mm_xor_si128(_mm_aesenclast_si128(blocks[i], roundKeys[rounds]), inputBlock);
+            store_block(output + i * kBlockSize, outputBlock);
+            __m128i hashBlock = byte_swap(isEncryption ? outputBlock : inputBlock);
+            if (i == 0) {
+                hashBlock = _mm_xor_si128(hashBlock, hash);
+            }
+            ghash_multiply_add(product, hashBlock, hashKeyPowers[kParallelBlocks - 1 - i]);
+        }
+        hash = ghash_reduce(product);
+        input += kParallelBlocks * kBlockSize;
+        output += kParallelBlocks * kBlockSize;
+    }
+
+    for (; inputLen >= kBlockSize; inputLen -= kBlockSize) {
+        counter = _mm_add_epi32(counter, one);
+        const __m128i inputBlock = load_block(input);
+        const __m128i outputBlock = _mm_xor_si128(encrypt_block(counter_swap(counter), roundKeys, rounds), inputBlock);
+        store_block(output, outputBlock);
+        hash = ghash_multiply(
+                _mm_xor_si128(hash, byte_swap(isEncryption ? outputBlock : inputBlock)), hashKeyPowers[0]);
+        input += kBlockSize;
+        output += kBlockSize;
+    }
+
+    if (inputLen > 0) {
+        // Same as mbedtls: partial block consumes whole counter value and is hashed padded with zeros.
+        counter = _mm_add_epi32(counter, one);
+        const __m128i inputBlock = load_partial_block(input, inputLen);
+        const __m128i outputBlock = _mm_and_si128(
+                _mm_xor_si128(encrypt_block(counter_swap(counter), roundKeys, rounds), inputBlock),
+                load_block(kPartialBlockMask + kBlockSize - inputLen));
+        alignas(16) unsigned char block[kBlockSize];
+        _mm_store_si128(reinterpret_cast<__m128i*>(block), outputBlock);
+        std::memcpy(output, block, inputLen);
+        secure_zeroize(block, sizeof(block));
+        hash = ghash_multiply(
+                _mm_xor_si128(hash, byte_swap(isEncryption ? outputBlock : inputBlock)), hashKeyPowers[0]);
+    }
+
+    store_block(counterBytes, counter);
+    store_block(hashBytes, hash);
+}
+
+VIRGIL_AES_NI_TARGET void finish(
+        const unsigned char* hashKeyPowersBytes, uint64_t dataLen, uint64_t authDataLen,
+        const unsigned char* hashBytes, const unsigned char* baseEncryptedCounterBytes, unsigned char* tag) {
+    const __m128i* hashKeyPowers = reinterpret_cast<const __m128i*>(hashKeyPowersBytes);
+    alignas(16) unsigned char lengths[kBlockSize];
+    for (size_t i = 0; i < 8; ++i) {
+        lengths[7 - i] = static_cast<unsigned char>((authDataLen * 8) >> (8 * i));
+        lengths[kBlockSize - 1 - i] = static_cast<unsigned char>((dataLen * 8) >> (8 * i));
+    }
+    const __m128i hash = ghash_update(load_block(hashBytes), hashKeyPowers, lengths, kBlockSize);
+    store_block(tag, _mm_xor_si128(byte_swap(hash), load_block(baseEncryptedCounterBytes)));
+}
+
+} // namespace
+
+#endif /* VIRGIL_AES_NI_GCM_ENABLED */
+
+bool VirgilAesNiGcm::isSupported() noexcept {
+#if VIRGIL_AES_NI_GCM_ENABLED
+    return VirgilCpuFeatures::hasAesNi();
+#else
+    return false;
+#endif
+}
+
+VirgilAesNiGcm::VirgilAesNiGcm() noexcept : rounds_(0), dataLen_(0), authDataLen_(0), isEncryption_(true) {
+    std::memset(roundKeys_, 0, sizeof(roundKeys_));
+    std::memset(hashKeyPowers_, 0, sizeof(hashKeyPowers_));
+    std::memset(counter_, 0, sizeof(counter_));
+    std::memset(hash_, 0, sizeof(hash_));
+    std::memset(baseEncryptedCounter_, 0, sizeof(baseEncryptedCounter_));
+}
+
+VirgilAesNiGcm::~VirgilAesNiGcm() noexcept {
+    clear();
+}
+
+bool VirgilAesNiGcm::setKey(const unsigned char* key, size_t keyBitLen) noexcept {
+#if VIRGIL_AES_NI_GCM_ENABLED
+    if (!isSupported() || (keyBitLen != 128 && keyBitLen != 256)) {
+        return false;
+    }
+    rounds_ = keyBitLen == 128 ? 10 : 14;
+    ::set_key(key, rounds_, roundKeys_, hashKeyPowers_);
+    return true;
+#else
+    (void) key;
+    (void) keyBitLen;
+    return false;
+#endif
+}
+
+bool VirgilAesNiGcm::start(
+        const unsigned char* iv, size_t ivLen, const unsigned char* authData, size_t authDataLen,
+        bool isEncryption) noexcept {
+#if VIRGIL_AES_NI_GCM_ENABLED
+    if (rounds_ == 0 || ivLen == 0) {
+        return false;
+    }
+    ::start(roundKeys_, rounds_, hashKeyPowers_, iv, ivLen, authData, authDataLen,
+            counter_, hash_, baseEncryptedCounter_);
+    dataLen_ = 0;
+    authDataLen_ = authDataLen;
+    isEncryption_ = isEncryption;
+    return true;
+#else
+    (void) iv;
+    (void) ivLen;
+    (void) authData;
+    (void) authDataLen;
+    (void) isEncryption;
+    return false;
+#endif
+}
+
+bool VirgilAesNiGcm::update(const unsigned char* input, size_t inputLen, unsigned char* output) noexcept {
+#if VIRGIL_AES_NI_GCM_ENABLED
+    if (static_cast<uint64_t>(inputLen) > kMaxDataLen - dataLen_) {
+        return false;
+    }
+    ::update(roundKeys_, rounds_, hashKeyPowers_, input, inputLen, output, isEncryption_, counter_, hash_);
+    dataLen_ += inputLen;
+    return true;
+#else
+    (void) input;
+    (void) inputLen;
+    (void) output;
+    return false;
+#endif
+}
+
+bool VirgilAesNiGcm::finish(unsigned char* tag, size_t tagLen) noexcept {
+#if VIRGIL_AES_NI_GCM_ENABLED
+    if (tagLen > kBlockSize) {
+        return false;
+    }
+    alignas(16) unsigned char fullTag[kBlockSize];
+    ::finish(hashKeyPowers_, dataLen_, authDataLen_, hash_, baseEncryptedCounter_, fullTag);
+    std::memcpy(tag, fullTag, tagLen);
+    secure_zeroize(fullTag, sizeof(fullTag));
+    return true;
+#else
+    (void) tag;
+    (void) tagLen;
+    return false;
+#endif
+}
+
+void VirgilAesNiGcm::clear() noexcept {
+    secure_zeroize(roundKeys_, sizeof(roundKeys_));
+    secure_zeroize(hashKeyPowers_, sizeof(hashKeyPowers_));
+    secure_zeroize(counter_, sizeof(counter_));
+    secure_zeroize(hash_, sizeof(hash_));
+    secure_zeroize(baseEncryptedCounter_, sizeof(baseEncryptedCounter_));
+    rounds_ = 0;
+    dataLen_ = 0;
+    authDataLen_ = 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_AES_NI_GCM_H
+#define VIRGIL_CRYPTO_AES_NI_GCM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief AES-GCM implementation based on the AES-NI and PCLMULQDQ instructions.
+ *
+ * Counter blocks are encrypted 8 at a time to keep AES pipeline busy,
+ * and GHASH is computed with carry-less multiplication, 8 blocks per one reduction.
+ *
+ * Output is bit-compatible with the mbedtls GCM for any sequence of calls,
+ * including the mbedtls behaviour for the partial block: when update() is called
+ * with data size that is not a multiple of 16, the tail is processed as a separate block.
+ *
+ * @note Use isSupported() to check whether current CPU supports required instructions.
+ */
+class VirgilAesNiGcm {
+public:
+    /**
+     * @brief Return true if current CPU supports AES-NI, PCLMULQDQ and SSSE3 instructions.
+     */
+    static bool isSupported() noexcept;
+
+    VirgilAesNiGcm() noexcept;
+
+    ~VirgilAesNiGcm() noexcept;
+
+    /**
+     * @brief Expand given key.
+     * @return false if key length is not supported (only 128 and 256 bits are supported).
+     */
+    bool setKey(const unsigned char* key, size_t keyBitLen) noexcept;
+
+    /**
+     * @brief Start new message with given IV and additional authenticated data.
+     * @return false if IV is empty.
+     */
+    bool start(
+            const unsigned char* iv, size_t ivLen, const unsigned char* authData, size_t authDataLen,
+            bool isEncryption) noexcept;
+
+    /**
+     * @brief Encrypt or decrypt given data, output size is equal to the input size.
+     * @return false if total length of the processed data exceeds 2^36 - 32 bytes,
+     *     in this case nothing is processed.
+     * @note Input and output can point to the same buffer.
+     */
+    bool update(const unsigned char* input, size_t inputLen, unsigned char* output) noexcept;
+
+    /**
+     * @brief Write authentication tag of the processed data.
+     * @return false if tag length is greater than 16.
+     */
+    bool finish(unsigned char* tag, size_t tagLen) noexcept;
+
+    /**
+     * @brief Zeroize key and state.
+     */
+    void clear() noexcept;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilAesNiGcm(const VirgilAesNiGcm&) = delete;
+
+    VirgilAesNiGcm& operator=(const VirgilAesNiGcm&) = delete;
+    //! @endcond
+
+private:
+    alignas(16) unsigned char roundKeys_[15 * 16];
+    alignas(16) unsigned char hashKeyPowers_[8 * 16];
+    alignas(16) unsigned char counter_[16];
+    alignas(16) unsigned char hash_[16];
+    alignas(16) unsigned char baseEncryptedCounter_[16];
+    size_t rounds_;
+    uint64_t dataLen_;
+    uint64_t authDataLen_;
+    bool isEncryption_;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_AES_NI_GCM_H */
@@ -178,6 +178,33 @@ size_t VirgilAsn1Reader::readSet() {
     return len;
 }
 
+size_t VirgilAsn1Reader::getPosition() const {
+    if (p_ == 0) {
+        return 0;
+    }
+    return static_cast<size_t>(p_ - data_.data());
+}
+
+void VirgilAsn1Reader::setPosition(size_t position) {
+    if (position > data_.size()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Requested ASN.1 position is out of bounds.");
+    }
+    p_ = data_.data() + position;
+}
+
+size_t VirgilAsn1Reader::skipData() {
+    checkState();
+    size_t len;
+    unsigned char* dataStart = p_;
+    p_ += 1; // Ignore tag value
+    system_crypto_handler(
+            mbedtls_asn1_get_len(&p_, end_, &len),
+            [](int){ std::throw_with_nested(make_error(VirgilCryptoError::InvalidFormat)); }
+    );
+    p_ += len;
+    return static_cast<size_t>(p_ - dataStart);
+}
+
 void VirgilAsn1Reader::checkState() {
     if (p_ == 0 || end_ == 0) {
         throw make_error(VirgilCryptoError::NotInitialized);
@@ -46,6 +46,8 @@
 #include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/ecdh.h>
+#include <mbedtls/ecdsa.h>
+#include <mbedtls/rsa.h>
 #include <mbedtls/asn1write.h>
 #include <mbedtls/kdf2.h>
 #include <mbedtls/md.h>
@@ -60,6 +62,7 @@
 
 #include "utils.h"
 #include "mbedtls_context.h"
+#include "mbedtls_ecp_tables.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
@@ -111,6 +114,23 @@ size_t key_material_entropy_len (key_material_entropy_t *ctx) {
 
 namespace virgil { namespace crypto { namespace foundation { namespace internal {
 
+/**
+ * @brief Compute values that MbedTLS otherwise computes lazily within the key on the first operation.
+ *
+ * After that signing and verification do not modify the key, so they can be performed concurrently.
+ */
+void pk_precompute(mbedtls_pk_context* pk_ctx) {
+    pk_attach_shared_ecp_table(pk_ctx);
+    if (mbedtls_pk_get_type(pk_ctx) == MBEDTLS_PK_RSA && mbedtls_pk_rsa(*pk_ctx)->len > 0) {
+        // Public operation caches Montgomery constant of the modulus (RN) within the key
+        mbedtls_rsa_context* rsa_ctx = mbedtls_pk_rsa(*pk_ctx);
+        VirgilByteArray input(rsa_ctx->len, 0x00);
+        VirgilByteArray output(rsa_ctx->len);
+        input.back() = 0x01;
+        (void) mbedtls_rsa_public(rsa_ctx, input.data(), output.data());
+    }
+}
+
 /**
  * Universal low-level key generation function.
  *
@@ -135,9 +155,15 @@ void gen_key_pair(
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     } else if (ecp_group_id != MBEDTLS_ECP_DP_NONE) {
         pk_ctx.clear().setup(MBEDTLS_PK_ECKEY);
+        // Same as mbedtls_ecp_gen_key(), but shared generator table is attached before key generation
+        mbedtls_ecp_keypair* ecp_keypair = mbedtls_pk_ec(*(pk_ctx.get()));
         system_crypto_handler(
-                mbedtls_ecp_gen_key(
-                        ecp_group_id, mbedtls_pk_ec(*(pk_ctx.get())),
+                mbedtls_ecp_group_load(&ecp_keypair->grp, ecp_group_id),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+        ecp_group_attach_shared_table(&ecp_keypair->grp);
+        system_crypto_handler(
+                mbedtls_ecp_gen_keypair(
+                        &ecp_keypair->grp, &ecp_keypair->d, &ecp_keypair->Q,
                         mbedtls_ctr_drbg_random, ctr_drbg_ctx.get()),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     } else if (fast_ec_type != MBEDTLS_FAST_EC_NONE) {
@@ -155,6 +181,7 @@ void gen_key_pair(
                         mbedtls_ctr_drbg_random, ctr_drbg_ctx.get()),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     }
+    pk_precompute(pk_ctx.get());
 }
 
 template<class EncDecFunc>
@@ -202,11 +229,50 @@ bool isEC(const mbedtls_pk_context* pk_ctx) {
            pk_type == MBEDTLS_PK_X25519;
 }
 
+/**
+ * @brief Return true if key is ECDSA key over short Weierstrass curve with attached generator table.
+ *
+ * Such keys are signed and verified directly on the key group,
+ *     because MbedTLS PK layer copies the group without precomputed generator table.
+ * Group without the table is left to the PK layer, otherwise comb method would build the table
+ *     within the key context, and concurrent operations on the same key would race.
+ */
+bool isWeierstrassECDSA(const mbedtls_pk_context* pk_ctx) {
+    const auto pk_type = mbedtls_pk_get_type(pk_ctx);
+    if (pk_type != MBEDTLS_PK_ECKEY && pk_type != MBEDTLS_PK_ECDSA) {
+        return false;
+    }
+    const mbedtls_ecp_group& grp = mbedtls_pk_ec(*pk_ctx)->grp;
+    return grp.G.Y.p != nullptr && grp.T != nullptr;
+}
+
+/**
+ * @brief Return random context of the current thread, and seed it on the first call.
+ *
+ * Signing is const operation that can be called concurrently on the same key,
+ *     so it can not use random context of the cipher.
+ */
+mbedtls_ctr_drbg_context* thread_random() {
+    struct random_type {
+        mbedtls_context<mbedtls_entropy_context> entropy_ctx;
+        mbedtls_context<mbedtls_ctr_drbg_context> ctr_drbg_ctx;
+        bool isSeeded = false;
+    };
+    // Per-thread regardless of VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, because callers can sign from own threads.
+    static thread_local random_type random;
+    if (!random.isSeeded) {
+        constexpr const char pers[] = "VirgilAsymmetricCipher::sign";
+        random.ctr_drbg_ctx.setup(mbedtls_entropy_func, random.entropy_ctx.get(), pers);
+        random.isSeeded = true;
+    }
+    return random.ctr_drbg_ctx.get();
+}
+
 mbedtls_context<mbedtls_ctr_drbg_context> create_deterministic_rng_ctx(const VirgilByteArray& keyMaterial) {
     mbedtls_context<mbedtls_ctr_drbg_context> drbg_ctx;
     key_material_entropy_t entropy_ctx;
 
-    system_crypto_handler(mbedtls_kdf2(mbedtls_md_info_from_type(MBEDTLS_MD_SHA512),
+    system_crypto_handler(mbedtls_kdf2(VirgilAcceleratedHash::mdInfoFromType(MBEDTLS_MD_SHA512),
             keyMaterial.data(), keyMaterial.size(), entropy_ctx.keyMaterial, key_material_entropy_len(&entropy_ctx)));
 
     key_material_entropy_reset(&entropy_ctx);
@@ -221,10 +287,32 @@ mbedtls_context<mbedtls_ctr_drbg_context> create_deterministic_rng_ctx(const Vir
 /// @name Public section
 
 class VirgilAsymmetricCipher::Impl {
+public:
+    Impl() : pk_ctx(), entropy_ctx(), ctr_drbg_ctx(), isRandomSeeded(false) {}
+
+    /**
+     * @brief Return random context, and seed it on the first call.
+     *
+     * Seeding requires entropy gathering which is expensive,
+     * so it is postponed until random is really needed: key generation, encryption, etc.
+     * Operations like signature verification, or key export without password do not need it at all.
+     */
+    mbedtls_context<mbedtls_ctr_drbg_context>& random() {
+        if (!isRandomSeeded) {
+            constexpr const char pers[] = "VirgilAsymmetricCipher";
+            ctr_drbg_ctx.setup(mbedtls_entropy_func, entropy_ctx.get(), pers);
+            isRandomSeeded = true;
+        }
+        return ctr_drbg_ctx;
+    }
+
 public:
     internal::mbedtls_context <mbedtls_pk_context> pk_ctx;
+
+private:
     mbedtls_context<mbedtls_entropy_context> entropy_ctx;
     mbedtls_context<mbedtls_ctr_drbg_context> ctr_drbg_ctx;
+    bool isRandomSeeded;
 };
 
 VirgilAsymmetricCipher::VirgilAsymmetricCipher(VirgilAsymmetricCipher&& other) noexcept = default;
@@ -233,10 +321,7 @@ VirgilAsymmetricCipher& VirgilAsymmetricCipher::operator=(VirgilAsymmetricCipher
 
 VirgilAsymmetricCipher::~VirgilAsymmetricCipher() noexcept = default;
 
-VirgilAsymmetricCipher::VirgilAsymmetricCipher() : impl_(std::make_unique<Impl>()) {
-    constexpr const char pers[] = "VirgilAsymmetricCipher";
-    impl_->ctr_drbg_ctx.setup(mbedtls_entropy_func, impl_->entropy_ctx.get(), pers);
-}
+VirgilAsymmetricCipher::VirgilAsymmetricCipher() : impl_(std::make_unique<Impl>()) {}
 
 size_t VirgilAsymmetricCipher::keySize() const {
     checkState();
@@ -309,6 +394,7 @@ void VirgilAsymmetricCipher::setPrivateKey(const VirgilByteArray& key, const Vir
                             std::throw_with_nested(make_error(VirgilCryptoError::InvalidPrivateKey));
                     }
             });
+    internal::pk_precompute(impl_->pk_ctx.get());
 }
 
 void VirgilAsymmetricCipher::setPublicKey(const VirgilByteArray& key) {
@@ -318,6 +404,7 @@ void VirgilAsymmetricCipher::setPublicKey(const VirgilByteArray& key) {
             mbedtls_pk_parse_public_key(impl_->pk_ctx.get(), fixedKey.data(), fixedKey.size()),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidPublicKey)); }
                          );
+    internal::pk_precompute(impl_->pk_ctx.get());
 }
 
 void VirgilAsymmetricCipher::genKeyPair(VirgilKeyPair::Type type) {
@@ -326,7 +413,7 @@ void VirgilAsymmetricCipher::genKeyPair(VirgilKeyPair::Type type) {
     mbedtls_ecp_group_id ecTypeId = MBEDTLS_ECP_DP_NONE;
     mbedtls_fast_ec_type_t fastEcType = MBEDTLS_FAST_EC_NONE;
     internal::key_type_set_params(type, &rsaSize, &ecTypeId, &fastEcType);
-    internal::gen_key_pair(impl_->pk_ctx, impl_->ctr_drbg_ctx, rsaSize, 65537, ecTypeId, fastEcType);
+    internal::gen_key_pair(impl_->pk_ctx, impl_->random(), rsaSize, 65537, ecTypeId, fastEcType);
 }
 
 void VirgilAsymmetricCipher::genKeyPairFromKeyMaterial(VirgilKeyPair::Type type, const VirgilByteArray& keyMaterial) {
@@ -352,18 +439,18 @@ void VirgilAsymmetricCipher::genKeyPairFrom(const VirgilAsymmetricCipher& other)
 
     if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_RSA)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->random(),
                 mbedtls_pk_get_bitlen(other.impl_->pk_ctx.get()), 65537,
                 MBEDTLS_ECP_DP_NONE, MBEDTLS_FAST_EC_NONE);
     } else if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_ECKEY)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->random(),
                 0, 0, mbedtls_pk_ec(*(other.impl_->pk_ctx.get()))->grp.id,
                 MBEDTLS_FAST_EC_NONE);
     } else if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_X25519) ||
                mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_ED25519)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->random(),
                 0, 0, MBEDTLS_ECP_DP_NONE,
                 mbedtls_fast_ec_get_type(mbedtls_pk_fast_ec(*(other.impl_->pk_ctx.get()))->info));
     } else {
@@ -413,7 +500,7 @@ VirgilByteArray VirgilAsymmetricCipher::computeShared(
         system_crypto_handler(
                 mbedtls_ecdh_calc_secret(
                         ecdh_ctx.get(), &sharedLen, shared.data(), shared.size(),
-                        mbedtls_ctr_drbg_random, publicContext.impl_->ctr_drbg_ctx.get()));
+                        mbedtls_ctr_drbg_random, publicContext.impl_->random().get()));
     } else if (mbedtls_pk_can_do(publicContext.impl_->pk_ctx.get(), MBEDTLS_PK_X25519) &&
                mbedtls_pk_can_do(privateContext.impl_->pk_ctx.get(), MBEDTLS_PK_X25519)) {
 
@@ -498,13 +585,13 @@ VirgilByteArray VirgilAsymmetricCipher::exportPrivateKeyToPEM(const VirgilByteAr
 VirgilByteArray VirgilAsymmetricCipher::encrypt(const VirgilByteArray& in) const {
     checkState();
     return internal::processEncryptionDecryption(
-            mbedtls_pk_encrypt, impl_->pk_ctx.get(), impl_->ctr_drbg_ctx.get(), in);
+            mbedtls_pk_encrypt, impl_->pk_ctx.get(), impl_->random().get(), in);
 }
 
 VirgilByteArray VirgilAsymmetricCipher::decrypt(const VirgilByteArray& in) const {
     checkState();
     return internal::processEncryptionDecryption(
-            mbedtls_pk_decrypt, impl_->pk_ctx.get(), impl_->ctr_drbg_ctx.get(), in);
+            mbedtls_pk_decrypt, impl_->pk_ctx.get(), impl_->random().get(), in);
 }
 
 VirgilByteArray VirgilAsymmetricCipher::sign(const VirgilByteArray& digest, int hashType) const {
@@ -529,20 +616,44 @@ VirgilByteArray VirgilAsymmetricCipher::sign(const VirgilByteArray& digest, int
 
     if (useRandom) {
         f_rng = mbedtls_ctr_drbg_random;
-        p_rng = impl_->ctr_drbg_ctx.get();
+        p_rng = internal::thread_random();
     }
 
-    system_crypto_handler(
-            mbedtls_pk_sign(
-                    impl_->pk_ctx.get(), static_cast<mbedtls_md_type_t>(hashType),
-                    digest.data(), digest.size(), sign, &actualSignLen, f_rng, p_rng),
-            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+    if (internal::isWeierstrassECDSA(impl_->pk_ctx.get())) {
+        system_crypto_handler(
+                mbedtls_ecdsa_write_signature(
+                        mbedtls_pk_ec(*impl_->pk_ctx.get()), static_cast<mbedtls_md_type_t>(hashType),
+                        digest.data(), digest.size(), sign, &actualSignLen, f_rng, p_rng),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+    } else if (mbedtls_pk_get_type(impl_->pk_ctx.get()) == MBEDTLS_PK_RSA) {
+        // Private operation updates blinding values within the key, so it is performed on the copy
+        mbedtls_context<mbedtls_rsa_context> rsa_ctx;
+        system_crypto_handler(
+                mbedtls_rsa_copy(rsa_ctx.get(), mbedtls_pk_rsa(*impl_->pk_ctx.get())),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+        system_crypto_handler(
+                mbedtls_rsa_pkcs1_sign(
+                        rsa_ctx.get(), f_rng, p_rng, MBEDTLS_RSA_PRIVATE, static_cast<mbedtls_md_type_t>(hashType),
+                        static_cast<unsigned int>(digest.size()), digest.data(), sign),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+        actualSignLen = rsa_ctx.get()->len;
+    } else {
+        system_crypto_handler(
+                mbedtls_pk_sign(
+                        impl_->pk_ctx.get(), static_cast<mbedtls_md_type_t>(hashType),
+                        digest.data(), digest.size(), sign, &actualSignLen, f_rng, p_rng),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
+    }
 
     return VirgilByteArray(sign, sign + actualSignLen);
 }
 
 bool VirgilAsymmetricCipher::verify(const VirgilByteArray& digest, const VirgilByteArray& sign, int hashType) const {
     checkState();
+    if (internal::isWeierstrassECDSA(impl_->pk_ctx.get())) {
+        return mbedtls_ecdsa_read_signature(
+                mbedtls_pk_ec(*impl_->pk_ctx.get()), digest.data(), digest.size(), sign.data(), sign.size()) == 0;
+    }
     return mbedtls_pk_verify(
             impl_->pk_ctx.get(), static_cast<mbedtls_md_type_t>(hashType),
             digest.data(), digest.size(), sign.data(), sign.size()) == 0;
@@ -699,7 +810,7 @@ size_t VirgilAsymmetricCipher::calculateExportedPrivateKeySizeMaxPEM(size_t encr
 
 VirgilByteArray VirgilAsymmetricCipher::generateParametersPBES() const {
     return VirgilAsn1Alg::buildPKCS5(
-            internal::randomize(impl_->ctr_drbg_ctx, 16), internal::randomize(impl_->ctr_drbg_ctx, 3072, 8192));
+            internal::randomize(impl_->random(), 16), internal::randomize(impl_->random(), 3072, 8192));
 }
 
 VirgilByteArray VirgilAsymmetricCipher::adjustBufferWithDER(const VirgilByteArray& buffer, int size) {
@@ -0,0 +1,237 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilBatchCipher.h>
+
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/VirgilContentInfo.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "utils.h"
+#include "parallel.h"
+#include "ScopeGuard.h"
+#include "VirgilContentInfoUtils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilBatchCipher;
+using virgil::crypto::VirgilContentInfo;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::VirgilCustomParams;
+using virgil::crypto::make_error;
+
+using virgil::crypto::foundation::VirgilRandom;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+
+using virgil::crypto::internal::VirgilContentInfoUtils;
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Handle class fields.
+ */
+class VirgilBatchCipher::Impl {
+public:
+    /**
+     * @brief Objects that are created once per processing thread and reused for the each message.
+     */
+    class Worker {
+    public:
+        /**
+         * @brief Recipient public key parsed once.
+         */
+        struct KeyRecipient {
+            VirgilAsymmetricCipher asymmetricCipher;
+            VirgilByteArray keyEncryptionAlgorithm;
+        };
+
+        Worker(
+                const std::map<VirgilByteArray, VirgilByteArray>& keyRecipients,
+                const std::set<VirgilByteArray>& passwordRecipients, const VirgilCustomParams& customParams) :
+                keyRecipients(keyRecipients), passwordRecipients(passwordRecipients), customParams(customParams),
+                random(VirgilByteArrayUtils::stringToBytes(std::string("virgil::VirgilBatchCipher"))),
+                symmetricCipher(VirgilContentInfoUtils::kSymmetricCipher_Algorithm) {
+
+            for (const auto& keyRecipient : keyRecipients) {
+                const auto& publicKey = keyRecipient.second;
+                if (parsedKeys.find(publicKey) == parsedKeys.end()) {
+                    KeyRecipient parsedKey;
+                    parsedKey.asymmetricCipher.setPublicKey(publicKey);
+                    parsedKey.keyEncryptionAlgorithm = parsedKey.asymmetricCipher.toAsn1();
+                    parsedKeys.emplace(publicKey, std::move(parsedKey));
+                }
+            }
+        }
+
+        VirgilByteArray encrypt(const VirgilByteArray& message) {
+            VirgilByteArray contentEncryptionKey = random.randomize(symmetricCipher.keyLength());
+            auto keyDisposer = ScopeGuard([&contentEncryptionKey]() {
+                VirgilByteArrayUtils::zeroize(contentEncryptionKey);
+            });
+
+            symmetricCipher.setEncryptionKey(contentEncryptionKey);
+            symmetricCipher.setIV(random.randomize(symmetricCipher.ivSize()));
+            symmetricCipher.reset();
+
+            VirgilContentInfo contentInfo;
+            contentInfo.customParams() = customParams;
+            for (const auto& keyRecipient : keyRecipients) {
+                contentInfo.addKeyRecipient(keyRecipient.first, keyRecipient.second);
+            }
+            for (const auto& pwd : passwordRecipients) {
+                contentInfo.addPasswordRecipient(pwd);
+            }
+
+            VirgilContentInfoUtils::encryptRecipients(
+                    contentInfo, symmetricCipher, contentEncryptionKey,
+                    [&](const VirgilByteArray& publicKey) -> VirgilContentInfoUtils::EncryptionResult {
+                        const auto parsedKey = parsedKeys.find(publicKey);
+                        if (parsedKey == parsedKeys.end()) {
+                            throw make_error(VirgilCryptoError::InvalidState,
+                                    "Public key of the key recipient is not parsed.");
+                        }
+                        return { parsedKey->second.keyEncryptionAlgorithm,
+                                 parsedKey->second.asymmetricCipher.encrypt(contentEncryptionKey) };
+                    },
+                    random, 1
+            );
+
+            VirgilByteArray result = contentInfo.toAsn1();
+            const size_t contentInfoSize = result.size();
+            result.resize(contentInfoSize + symmetricCipher.defineEncryptedSize(message.size()));
+
+            size_t writtenBytes = contentInfoSize;
+            writtenBytes += symmetricCipher.update(
+                    message.data(), message.size(), result.data() + writtenBytes, result.size() - writtenBytes);
+            writtenBytes += symmetricCipher.finish(result.data() + writtenBytes, result.size() - writtenBytes);
+            result.resize(writtenBytes);
+
+            return result;
+        }
+
+    private:
+        const std::map<VirgilByteArray, VirgilByteArray>& keyRecipients;
+        const std::set<VirgilByteArray>& passwordRecipients;
+        const VirgilCustomParams& customParams;
+        VirgilRandom random;
+        VirgilSymmetricCipher symmetricCipher;
+        std::map<VirgilByteArray, KeyRecipient> parsedKeys; ///< public key -> parsed public key
+    };
+
+public:
+    std::map<VirgilByteArray, VirgilByteArray> keyRecipients; ///< recipient id -> public key
+    std::set<VirgilByteArray> passwordRecipients; ///< passwords
+    VirgilCustomParams customParams;
+    size_t batchThreadsNum = 1;
+};
+
+}}
+
+VirgilBatchCipher::VirgilBatchCipher() : impl_(std::make_unique<Impl>()) {}
+
+VirgilBatchCipher::VirgilBatchCipher(VirgilBatchCipher&& rhs) noexcept = default;
+
+VirgilBatchCipher& VirgilBatchCipher::operator=(VirgilBatchCipher&& rhs) noexcept = default;
+
+VirgilBatchCipher::~VirgilBatchCipher() noexcept = default;
+
+void VirgilBatchCipher::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey) {
+    if (recipientId.empty()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not add recipient with empty 'recipientId'");
+    }
+    if (impl_->keyRecipients.find(recipientId) != impl_->keyRecipients.end()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Recipient with given 'recipientId' already exists");
+    }
+    VirgilAsymmetricCipher::checkPublicKey(publicKey);
+    impl_->keyRecipients[recipientId] = publicKey;
+}
+
+void VirgilBatchCipher::addPasswordRecipient(const VirgilByteArray& pwd) {
+    if (pwd.empty()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not add recipient with empty 'pwd'");
+    }
+    impl_->passwordRecipients.insert(pwd);
+}
+
+void VirgilBatchCipher::removeAllRecipients() {
+    impl_->keyRecipients.clear();
+    impl_->passwordRecipients.clear();
+}
+
+VirgilCustomParams& VirgilBatchCipher::customParams() {
+    return impl_->customParams;
+}
+
+const VirgilCustomParams& VirgilBatchCipher::customParams() const {
+    return impl_->customParams;
+}
+
+void VirgilBatchCipher::setBatchThreadsNum(size_t threadsNum) {
+    impl_->batchThreadsNum = threadsNum;
+}
+
+size_t VirgilBatchCipher::getBatchThreadsNum() const {
+    return impl_->batchThreadsNum;
+}
+
+std::vector<VirgilByteArray> VirgilBatchCipher::encrypt(const std::vector<VirgilByteArray>& messages) const {
+    if (impl_->keyRecipients.empty() && impl_->passwordRecipients.empty()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Recipients are not defined.");
+    }
+
+    std::vector<VirgilByteArray> result(messages.size());
+
+    // Each thread processes contiguous range of messages with its own parsed keys and random.
+    const size_t workersNum = std::min(std::max(impl_->batchThreadsNum, size_t(1)), messages.size());
+    internal::parallel_for(workersNum, workersNum, [&](size_t workerIndex) {
+        const size_t begin = messages.size() * workerIndex / workersNum;
+        const size_t end = messages.size() * (workerIndex + 1) / workersNum;
+        Impl::Worker worker(impl_->keyRecipients, impl_->passwordRecipients, impl_->customParams);
+        for (size_t index = begin; index < end; ++index) {
+            result[index] = worker.encrypt(messages[index]);
+        }
+    });
+
+    return result;
+}
@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file VirgilCMSConstants.h
+ *
+ * ASN.1 constants for CMS that are shared between CMS structures and content info reader.
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_CMS_CONSTANTS_H
+#define VIRGIL_CRYPTO_VIRGIL_CMS_CONSTANTS_H
+
+/**
+ * @name ASN.1 Constants for CMS RecipientInfo
+ */
+///@{
+static const unsigned char kCMS_OriginatorInfoTag = 0;
+static const unsigned char kCMS_KeyAgreeRecipientTag = 1;
+static const unsigned char kCMS_KEKRecipientTag = 2;
+static const unsigned char kCMS_PasswordRecipientTag = 3;
+static const unsigned char kCMS_OtherRecipientTag = 4;
+static const unsigned char kCMS_SubjectKeyTag = 0;
+static const int kCMS_KeyTransRecipientVersion = 2;
+///@}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_CMS_CONSTANTS_H */
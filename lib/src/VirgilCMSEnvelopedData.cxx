@@ -40,20 +40,12 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
+#include "VirgilCMSConstants.h"
+
 
 using virgil::crypto::foundation::cms::VirgilCMSEnvelopedData;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
-/**
- * @name ASN.1 Constants for CMS
- */
-///@{
-static const unsigned char kCMS_OriginatorInfoTag = 0;
-static const unsigned char kCMS_KeyAgreeRecipientTag = 1;
-static const unsigned char kCMS_KEKRecipientTag = 2;
-static const unsigned char kCMS_PasswordRecipientTag = 3;
-static const unsigned char kCMS_OtherRecipientTag = 4;
-///@}
 
 size_t VirgilCMSEnvelopedData::asn1Write(VirgilAsn1Writer& asn1Writer, size_t childWrittenBytes) const {
     size_t len = 0;
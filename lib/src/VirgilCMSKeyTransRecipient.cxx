@@ -41,19 +41,12 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
 #include "utils.h"
+#include "VirgilCMSConstants.h"
 
 using virgil::crypto::foundation::cms::VirgilCMSKeyTransRecipient;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 
-/**
- * @name ASN.1 Constants for CMS
- */
-///@{
-static const unsigned char kCMS_SubjectKeyTag = 0;
-static const int kCMS_KeyTransRecipientVersion = 2;
-///@}
-
 size_t VirgilCMSKeyTransRecipient::asn1Write(VirgilAsn1Writer& asn1Writer, size_t childWrittenBytes) const {
     size_t len = 0;
 
@@ -0,0 +1,700 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilChaCha20Poly1305.h"
+#include "VirgilCpuFeatures.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VIRGIL_CHACHA_NEON_ENABLED 1
+#include <arm_neon.h>
+#else
+#define VIRGIL_CHACHA_NEON_ENABLED 0
+#endif
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+using virgil::crypto::foundation::internal::VirgilPoly1305;
+using virgil::crypto::foundation::internal::VirgilChaCha20Poly1305;
+using virgil::crypto::foundation::internal::VirgilCpuFeatures;
+using virgil::crypto::internal::secure_zeroize;
+
+static constexpr size_t kChaChaBlockSize = 64;
+static constexpr size_t kPolyBlockSize = 16;
+//! Message is encrypted from the block 1, so the 32-bit block counter allows (2^32 - 1) blocks.
+static constexpr uint64_t kMaxDataLen = static_cast<uint64_t>(0xffffffff) * kChaChaBlockSize;
+
+static inline uint32_t load_le32(const unsigned char* data) noexcept {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+static inline void store_le32(unsigned char* data, uint32_t value) noexcept {
+    data[0] = static_cast<unsigned char>(value);
+    data[1] = static_cast<unsigned char>(value >> 8);
+    data[2] = static_cast<unsigned char>(value >> 16);
+    data[3] = static_cast<unsigned char>(value >> 24);
+}
+
+static inline uint64_t load_le64(const unsigned char* data) noexcept {
+    return static_cast<uint64_t>(load_le32(data)) | (static_cast<uint64_t>(load_le32(data + 4)) << 32);
+}
+
+static inline void store_le64(unsigned char* data, uint64_t value) noexcept {
+    store_le32(data, static_cast<uint32_t>(value));
+    store_le32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+// ---------------------------------------------------------------------------
+// Poly1305
+// ---------------------------------------------------------------------------
+
+#if defined(__SIZEOF_INT128__)
+
+// Radix 2^44, based on the public domain poly1305-donna-64 by Andrew Moon.
+
+typedef unsigned __int128 uint128_t;
+
+static constexpr uint64_t kMask44 = 0xfffffffffffULL;
+static constexpr uint64_t kMask42 = 0x3ffffffffffULL;
+
+void VirgilPoly1305::start(const unsigned char key[32]) noexcept {
+    const uint64_t t0 = load_le64(key);
+    const uint64_t t1 = load_le64(key + 8);
+    r_[0] = t0 & 0xffc0fffffffULL;
+    r_[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+    r_[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+    h_[0] = h_[1] = h_[2] = 0;
+    pad_[0] = load_le64(key + 16);
+    pad_[1] = load_le64(key + 24);
+    bufferLen_ = 0;
+}
+
+void VirgilPoly1305::processBlocks(const unsigned char* data, size_t dataLen, bool isFinal) noexcept {
+    const uint64_t hibit = isFinal ? 0 : (1ULL << 40);
+    const uint64_t r0 = r_[0], r1 = r_[1], r2 = r_[2];
+    const uint64_t s1 = r1 * (5 << 2);
+    const uint64_t s2 = r2 * (5 << 2);
+    uint64_t h0 = h_[0], h1 = h_[1], h2 = h_[2];
+
+    for (; dataLen >= kPolyBlockSize; data += kPolyBlockSize, dataLen -= kPolyBlockSize) {
+        const uint64_t t0 = load_le64(data);
+        const uint64_t t1 = load_le64(data + 8);
+        h0 += t0 & kMask44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & kMask44;
+        h2 += (((t1 >> 24)) & kMask42) | hibit;
+
+        uint128_t d0 = (uint128_t)h0 * r0 + (uint128_t)h1 * s2 + (uint128_t)h2 * s1;
+        uint128_t d1 = (uint128_t)h0 * r1 + (uint128_t)h1 * r0 + (uint128_t)h2 * s2;
+        uint128_t d2 = (uint128_t)h0 * r2 + (uint128_t)h1 * r1 + (uint128_t)h2 * r0;
+
+        uint64_t c = (uint64_t)(d0 >> 44); h0 = (uint64_t)d0 & kMask44;
+        d1 += c; c = (uint64_t)(d1 >> 44); h1 = (uint64_t)d1 & kMask44;
+        d2 += c; c = (uint64_t)(d2 >> 42); h2 = (uint64_t)d2 & kMask42;
+        h0 += c * 5; c = h0 >> 44; h0 &= kMask44;
+        h1 += c;
+    }
+
+    h_[0] = h0; h_[1] = h1; h_[2] = h2;
+}
+
+void VirgilPoly1305::finish(unsigned char mac[16]) noexcept {
+    if (bufferLen_ > 0) {
+        buffer_[bufferLen_] = 1;
+        std::memset(buffer_ + bufferLen_ + 1, 0, kPolyBlockSize - bufferLen_ - 1);
+        processBlocks(buffer_, kPolyBlockSize, true);
+    }
+
+    uint64_t h0 = h_[0], h1 = h_[1], h2 = h_[2];
+    uint64_t c;
+    c = h1 >> 44; h1 &= kMask44; h2 += c;
+    c = h2 >> 42; h2 &= kMask42; h0 += c * 5;
+    c = h0 >> 44; h0 &= kMask44; h1 += c;
+    c = h1 >> 44; h1 &= kMask44; h2 += c;
+    c = h2 >> 42; h2 &= kMask42; h0 += c * 5;
+    c = h0 >> 44; h0 &= kMask44; h1 += c;
+
+    // Compute h - p and select it in constant time if h >= p.
+    uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= kMask44;
+    uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= kMask44;
+    uint64_t g2 = h2 + c - (1ULL << 42);
+    c = (g2 >> 63) - 1;
+    g0 &= c; g1 &= c; g2 &= c;
+    c = ~c;
+    h0 = (h0 & c) | g0;
+    h1 = (h1 & c) | g1;
+    h2 = (h2 & c) | g2;
+
+    const uint64_t t0 = pad_[0];
+    const uint64_t t1 = pad_[1];
+    h0 += t0 & kMask44; c = h0 >> 44; h0 &= kMask44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & kMask44) + c; c = h1 >> 44; h1 &= kMask44;
+    h2 += ((t1 >> 24) & kMask42) + c; h2 &= kMask42;
+
+    store_le64(mac, h0 | (h1 << 44));
+    store_le64(mac + 8, (h1 >> 20) | (h2 << 24));
+
+    clear();
+}
+
+#else /* __SIZEOF_INT128__ */
+
+// Radix 2^26, based on the public domain poly1305-donna-32 by Andrew Moon.
+
+static constexpr uint32_t kMask26 = 0x3ffffff;
+
+void VirgilPoly1305::start(const unsigned char key[32]) noexcept {
+    r_[0] = load_le32(key) & 0x3ffffff;
+    r_[1] = (load_le32(key + 3) >> 2) & 0x3ffff03;
+    r_[2] = (load_le32(key + 6) >> 4) & 0x3ffc0ff;
+    r_[3] = (load_le32(key + 9) >> 6) & 0x3f03fff;
+    r_[4] = (load_le32(key + 12) >> 8) & 0x00fffff;
+    h_[0] = h_[1] = h_[2] = h_[3] = h_[4] = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        pad_[i] = load_le32(key + 16 + 4 * i);
+    }
+    bufferLen_ = 0;
+}
+
+void VirgilPoly1305::processBlocks(const unsigned char* data, size_t dataLen, bool isFinal) noexcept {
+    const uint32_t hibit = isFinal ? 0 : (1UL << 24);
+    const uint32_t r0 = r_[0], r1 = r_[1], r2 = r_[2], r3 = r_[3], r4 = r_[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h_[0], h1 = h_[1], h2 = h_[2], h3 = h_[3], h4 = h_[4];
+
+    for (; dataLen >= kPolyBlockSize; data += kPolyBlockSize, dataLen -= kPolyBlockSize) {
+        h0 += load_le32(data) & kMask26;
+        h1 += (load_le32(data + 3) >> 2) & kMask26;
+        h2 += (load_le32(data + 6) >> 4) & kMask26;
+        h3 += (load_le32(data + 9) >> 6) & kMask26;
+        h4 += (load_le32(data + 12) >> 8) | hibit;
+
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 +
+                      (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 +
+                      (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 +
+                      (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 +
+                      (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 +
+                      (uint64_t)h4 * r0;
+
+        uint32_t c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & kMask26;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & kMask26;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & kMask26;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & kMask26;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & kMask26;
+        h0 += c * 5; c = h0 >> 26; h0 &= kMask26;
+        h1 += c;
+    }
+
+    h_[0] = h0; h_[1] = h1; h_[2] = h2; h_[3] = h3; h_[4] = h4;
+}
+
+void VirgilPoly1305::finish(unsigned char mac[16]) noexcept {
+    if (bufferLen_ > 0) {
+        buffer_[bufferLen_] = 1;
+        std::memset(buffer_ + bufferLen_ + 1, 0, kPolyBlockSize - bufferLen_ - 1);
+        processBlocks(buffer_, kPolyBlockSize, true);
+    }
+
+    uint32_t h0 = h_[0], h1 = h_[1], h2 = h_[2], h3 = h_[3], h4 = h_[4];
+    uint32_t c;
+    c = h1 >> 26; h1 &= kMask26; h2 += c;
+    c = h2 >> 26; h2 &= kMask26; h3 += c;
+    c = h3 >> 26; h3 &= kMask26; h4 += c;
+    c = h4 >> 26; h4 &= kMask26; h0 += c * 5;
+    c = h0 >> 26; h0 &= kMask26; h1 += c;
+
+    // Compute h - p and select it in constant time if h >= p.
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= kMask26;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= kMask26;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= kMask26;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= kMask26;
+    uint32_t g4 = h4 + c - (1UL << 26);
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    uint64_t f = (uint64_t)h0 + pad_[0]; h0 = (uint32_t)f;
+    f = (uint64_t)h1 + pad_[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + pad_[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + pad_[3] + (f >> 32); h3 = (uint32_t)f;
+
+    store_le32(mac, h0);
+    store_le32(mac + 4, h1);
+    store_le32(mac + 8, h2);
+    store_le32(mac + 12, h3);
+
+    clear();
+}
+
+#endif /* __SIZEOF_INT128__ */
+
+void VirgilPoly1305::update(const unsigned char* data, size_t dataLen) noexcept {
+    if (bufferLen_ > 0) {
+        const size_t toCopy = std::min(kPolyBlockSize - bufferLen_, dataLen);
+        std::memcpy(buffer_ + bufferLen_, data, toCopy);
+        bufferLen_ += toCopy;
+        data += toCopy;
+        dataLen -= toCopy;
+        if (bufferLen_ < kPolyBlockSize) {
+            return;
+        }
+        processBlocks(buffer_, kPolyBlockSize, false);
+        bufferLen_ = 0;
+    }
+
+    const size_t fullLen = dataLen & ~(kPolyBlockSize - 1);
+    if (fullLen > 0) {
+        processBlocks(data, fullLen, false);
+        data += fullLen;
+        dataLen -= fullLen;
+    }
+
+    if (dataLen > 0) {
+        std::memcpy(buffer_, data, dataLen);
+        bufferLen_ = dataLen;
+    }
+}
+
+void VirgilPoly1305::clear() noexcept {
+    secure_zeroize(r_, sizeof(r_));
+    secure_zeroize(h_, sizeof(h_));
+    secure_zeroize(pad_, sizeof(pad_));
+    secure_zeroize(buffer_, sizeof(buffer_));
+    bufferLen_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// ChaCha20 key stream kernels
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief ChaCha20 rounds are shared by all kernels, vector operations are given as macro parameters.
+ */
+#define VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, a, b, c, d) \
+    a = ADD(a, b); d = ROTL16(XOR(d, a)); \
+    c = ADD(c, d); b = ROTL12(XOR(b, c)); \
+    a = ADD(a, b); d = ROTL8(XOR(d, a)); \
+    c = ADD(c, d); b = ROTL7(XOR(b, c))
+
+#define VIRGIL_CHACHA_ROUNDS(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x) \
+    for (int round = 0; round < 10; ++round) { \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[0], x[4], x[8], x[12]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[1], x[5], x[9], x[13]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[2], x[6], x[10], x[14]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[3], x[7], x[11], x[15]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[0], x[5], x[10], x[15]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[1], x[6], x[11], x[12]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[2], x[7], x[8], x[13]); \
+        VIRGIL_CHACHA_QUARTER_ROUND(ADD, XOR, ROTL16, ROTL12, ROTL8, ROTL7, x[3], x[4], x[9], x[14]); \
+    }
+
+namespace {
+
+/**
+ * @brief Kernel writes (blocks * 64) bytes of key stream starting from the counter state[12].
+ */
+typedef void (*chacha_kernel_fn)(const uint32_t state[16], unsigned char* keyStream);
+
+struct chacha_kernel {
+    chacha_kernel_fn fn;
+    size_t blocks;
+    const char* name;
+};
+
+#define VIRGIL_SCALAR_ADD(a, b) ((a) + (b))
+#define VIRGIL_SCALAR_XOR(a, b) ((a) ^ (b))
+#define VIRGIL_SCALAR_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define VIRGIL_SCALAR_ROTL16(v) VIRGIL_SCALAR_ROTL(v, 16)
+#define VIRGIL_SCALAR_ROTL12(v) VIRGIL_SCALAR_ROTL(v, 12)
+#define VIRGIL_SCALAR_ROTL8(v) VIRGIL_SCALAR_ROTL(v, 8)
+#define VIRGIL_SCALAR_ROTL7(v) VIRGIL_SCALAR_ROTL(v, 7)
+
+void chacha_blocks_scalar(const uint32_t state[16], unsigned char* keyStream) {
+    uint32_t x[16];
+    std::memcpy(x, state, sizeof(x));
+    VIRGIL_CHACHA_ROUNDS(VIRGIL_SCALAR_ADD, VIRGIL_SCALAR_XOR, VIRGIL_SCALAR_ROTL16, VIRGIL_SCALAR_ROTL12,
+            VIRGIL_SCALAR_ROTL8, VIRGIL_SCALAR_ROTL7, x);
+    for (size_t i = 0; i < 16; ++i) {
+        store_le32(keyStream + 4 * i, x[i] + state[i]);
+    }
+    secure_zeroize(x, sizeof(x));
+}
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+
+#define VIRGIL_SSE2_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define VIRGIL_SSE2_ROTL16(v) VIRGIL_SSE2_ROTL(v, 16)
+#define VIRGIL_SSE2_ROTL12(v) VIRGIL_SSE2_ROTL(v, 12)
+#define VIRGIL_SSE2_ROTL8(v) VIRGIL_SSE2_ROTL(v, 8)
+#define VIRGIL_SSE2_ROTL7(v) VIRGIL_SSE2_ROTL(v, 7)
+
+/**
+ * @brief Four blocks are computed in parallel, one block per 32-bit lane.
+ */
+VIRGIL_CRYPTO_X86_TARGET("sse2") void chacha_blocks_sse2(const uint32_t state[16], unsigned char* keyStream) {
+    __m128i x[16];
+    __m128i s[16];
+    for (size_t i = 0; i < 16; ++i) {
+        s[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+    }
+    s[12] = _mm_add_epi32(s[12], _mm_set_epi32(3, 2, 1, 0));
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] = s[i];
+    }
+
+    VIRGIL_CHACHA_ROUNDS(_mm_add_epi32, _mm_xor_si128, VIRGIL_SSE2_ROTL16, VIRGIL_SSE2_ROTL12,
+            VIRGIL_SSE2_ROTL8, VIRGIL_SSE2_ROTL7, x);
+
+    // Transpose 4x4 groups of words, so each group becomes 16 consecutive bytes of one block.
+    for (size_t i = 0; i < 16; i += 4) {
+        const __m128i a0 = _mm_add_epi32(x[i + 0], s[i + 0]);
+        const __m128i a1 = _mm_add_epi32(x[i + 1], s[i + 1]);
+        const __m128i a2 = _mm_add_epi32(x[i + 2], s[i + 2]);
+        const __m128i a3 = _mm_add_epi32(x[i + 3], s[i + 3]);
+        const __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+        const __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+        const __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+        const __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+        unsigned char* out = keyStream + 4 * i;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0 * kChaChaBlockSize), _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 1 * kChaChaBlockSize), _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * kChaChaBlockSize), _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * kChaChaBlockSize), _mm_unpackhi_epi64(t2, t3));
+    }
+}
+
+#define VIRGIL_AVX2_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define VIRGIL_AVX2_ROTL16(v) _mm256_shuffle_epi8(v, rotl16)
+#define VIRGIL_AVX2_ROTL12(v) VIRGIL_AVX2_ROTL(v, 12)
+#define VIRGIL_AVX2_ROTL8(v) _mm256_shuffle_epi8(v, rotl8)
+#define VIRGIL_AVX2_ROTL7(v) VIRGIL_AVX2_ROTL(v, 7)
+
+/**
+ * @brief Eight blocks are computed in parallel, one block per 32-bit lane.
+ */
+VIRGIL_CRYPTO_X86_TARGET("avx2") void chacha_blocks_avx2(const uint32_t state[16], unsigned char* keyStream) {
+    const __m256i rotl16 = _mm256_set_epi8(
+            13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+            13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rotl8 = _mm256_set_epi8(
+            14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+            14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    __m256i x[16];
+    __m256i s[16];
+    for (size_t i = 0; i < 16; ++i) {
+        s[i] = _mm256_set1_epi32(static_cast<int>(state[i]));
+    }
+    s[12] = _mm256_add_epi32(s[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] = s[i];
+    }
+
+    VIRGIL_CHACHA_ROUNDS(_mm256_add_epi32, _mm256_xor_si256, VIRGIL_AVX2_ROTL16, VIRGIL_AVX2_ROTL12,
+            VIRGIL_AVX2_ROTL8, VIRGIL_AVX2_ROTL7, x);
+
+    // Transpose is done within 128-bit lanes: lower lanes hold blocks 0..3, upper lanes hold blocks 4..7.
+    for (size_t i = 0; i < 16; i += 4) {
+        const __m256i a0 = _mm256_add_epi32(x[i + 0], s[i + 0]);
+        const __m256i a1 = _mm256_add_epi32(x[i + 1], s[i + 1]);
+        const __m256i a2 = _mm256_add_epi32(x[i + 2], s[i + 2]);
+        const __m256i a3 = _mm256_add_epi32(x[i + 3], s[i + 3]);
+        const __m256i t0 = _mm256_unpacklo_epi32(a0, a1);
+        const __m256i t1 = _mm256_unpacklo_epi32(a2, a3);
+        const __m256i t2 = _mm256_unpackhi_epi32(a0, a1);
+        const __m256i t3 = _mm256_unpackhi_epi32(a2, a3);
+        const __m256i b[4] = {
+            _mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+            _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3)
+        };
+        unsigned char* out = keyStream + 4 * i;
+        for (size_t j = 0; j < 4; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j * kChaChaBlockSize),
+                    _mm256_castsi256_si128(b[j]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (j + 4) * kChaChaBlockSize),
+                    _mm256_extracti128_si256(b[j], 1));
+        }
+    }
+}
+
+#endif /* VIRGIL_CRYPTO_X86_ENABLED */
+
+#if VIRGIL_CHACHA_NEON_ENABLED
+
+#define VIRGIL_NEON_ROTL(v, n) vsriq_n_u32(vshlq_n_u32(v, n), v, 32 - (n))
+#define VIRGIL_NEON_ROTL16(v) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+#define VIRGIL_NEON_ROTL12(v) VIRGIL_NEON_ROTL(v, 12)
+#define VIRGIL_NEON_ROTL8(v) VIRGIL_NEON_ROTL(v, 8)
+#define VIRGIL_NEON_ROTL7(v) VIRGIL_NEON_ROTL(v, 7)
+
+/**
+ * @brief Four blocks are computed in parallel, one block per 32-bit lane.
+ */
+void chacha_blocks_neon(const uint32_t state[16], unsigned char* keyStream) {
+    static const uint32_t kLaneOffsets[4] = { 0, 1, 2, 3 };
+    uint32x4_t x[16];
+    uint32x4_t s[16];
+    for (size_t i = 0; i < 16; ++i) {
+        s[i] = vdupq_n_u32(state[i]);
+    }
+    s[12] = vaddq_u32(s[12], vld1q_u32(kLaneOffsets));
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] = s[i];
+    }
+
+    VIRGIL_CHACHA_ROUNDS(vaddq_u32, veorq_u32, VIRGIL_NEON_ROTL16, VIRGIL_NEON_ROTL12,
+            VIRGIL_NEON_ROTL8, VIRGIL_NEON_ROTL7, x);
+
+    uint32_t words[4];
+    for (size_t i = 0; i < 16; ++i) {
+        vst1q_u32(words, vaddq_u32(x[i], s[i]));
+        for (size_t j = 0; j < 4; ++j) {
+            store_le32(keyStream + j * kChaChaBlockSize + 4 * i, words[j]);
+        }
+    }
+}
+
+#endif /* VIRGIL_CHACHA_NEON_ENABLED */
+
+/**
+ * @brief Kernels supported by the current CPU, the widest one goes first.
+ */
+struct chacha_kernels {
+    chacha_kernel items[3];
+    size_t count;
+};
+
+chacha_kernels select_kernels() noexcept {
+    chacha_kernels kernels = {};
+#if VIRGIL_CRYPTO_X86_ENABLED
+    if (VirgilCpuFeatures::hasAvx2()) {
+        kernels.items[kernels.count++] = { chacha_blocks_avx2, 8, "avx2" };
+    }
+    if (VirgilCpuFeatures::hasSse2()) {
+        kernels.items[kernels.count++] = { chacha_blocks_sse2, 4, "sse2" };
+    }
+#elif VIRGIL_CHACHA_NEON_ENABLED
+    kernels.items[kernels.count++] = { chacha_blocks_neon, 4, "neon" };
+#endif
+    kernels.items[kernels.count++] = { chacha_blocks_scalar, 1, "portable" };
+    return kernels;
+}
+
+const chacha_kernels& get_kernels() noexcept {
+    static const chacha_kernels kernels = select_kernels();
+    return kernels;
+}
+
+void xor_bytes(const unsigned char* input, const unsigned char* keyStream, size_t len, unsigned char* output) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t a, b;
+        std::memcpy(&a, input + i, sizeof(a));
+        std::memcpy(&b, keyStream + i, sizeof(b));
+        a ^= b;
+        std::memcpy(output + i, &a, sizeof(a));
+    }
+    for (; i < len; ++i) {
+        output[i] = input[i] ^ keyStream[i];
+    }
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// ChaCha20-Poly1305
+// ---------------------------------------------------------------------------
+
+constexpr size_t VirgilChaCha20Poly1305::kKeySize;
+constexpr size_t VirgilChaCha20Poly1305::kNonceSize;
+constexpr size_t VirgilChaCha20Poly1305::kTagSize;
+constexpr size_t VirgilChaCha20Poly1305::kKeyStreamSizeMax;
+
+size_t VirgilChaCha20Poly1305::kernelCount() noexcept {
+    return get_kernels().count;
+}
+
+const char* VirgilChaCha20Poly1305::kernelName(size_t index) noexcept {
+    return index < kernelCount() ? get_kernels().items[index].name : nullptr;
+}
+
+VirgilChaCha20Poly1305::VirgilChaCha20Poly1305() noexcept
+        : state_(), keyStream_(), keyStreamOffset_(0), keyStreamSize_(0), poly1305_(), kernelIndex_(0),
+          authDataLen_(0), dataLen_(0), hasKey_(false), isEncryption_(true) {
+}
+
+VirgilChaCha20Poly1305::~VirgilChaCha20Poly1305() noexcept {
+    clear();
+}
+
+bool VirgilChaCha20Poly1305::setKey(const unsigned char* key, size_t keyLen) noexcept {
+    if (keyLen != kKeySize) {
+        return false;
+    }
+    // "expand 32-byte k"
+    state_[0] = 0x61707865;
+    state_[1] = 0x3320646e;
+    state_[2] = 0x79622d32;
+    state_[3] = 0x6b206574;
+    for (size_t i = 0; i < 8; ++i) {
+        state_[4 + i] = load_le32(key + 4 * i);
+    }
+    hasKey_ = true;
+    return true;
+}
+
+bool VirgilChaCha20Poly1305::setKernel(size_t index) noexcept {
+    if (index >= kernelCount()) {
+        return false;
+    }
+    kernelIndex_ = index;
+    return true;
+}
+
+bool VirgilChaCha20Poly1305::start(
+        const unsigned char* nonce, size_t nonceLen, const unsigned char* authData, size_t authDataLen,
+        bool isEncryption) noexcept {
+    if (!hasKey_ || nonceLen != kNonceSize) {
+        return false;
+    }
+    state_[12] = 0;
+    state_[13] = load_le32(nonce);
+    state_[14] = load_le32(nonce + 4);
+    state_[15] = load_le32(nonce + 8);
+
+    // One-time Poly1305 key is the first half of the block 0, message is encrypted from the block 1.
+    unsigned char block[kChaChaBlockSize];
+    chacha_blocks_scalar(state_, block);
+    poly1305_.start(block);
+    secure_zeroize(block, sizeof(block));
+    state_[12] = 1;
+    keyStreamOffset_ = keyStreamSize_ = 0;
+
+    static const unsigned char kZeros[kPolyBlockSize] = { 0 };
+    if (authDataLen > 0) {
+        poly1305_.update(authData, authDataLen);
+        poly1305_.update(kZeros, (kPolyBlockSize - authDataLen % kPolyBlockSize) % kPolyBlockSize);
+    }
+    authDataLen_ = authDataLen;
+    dataLen_ = 0;
+    isEncryption_ = isEncryption;
+    return true;
+}
+
+bool VirgilChaCha20Poly1305::update(const unsigned char* input, size_t inputLen, unsigned char* output) noexcept {
+    if (static_cast<uint64_t>(inputLen) > kMaxDataLen - dataLen_) {
+        return false;
+    }
+    if (!isEncryption_) {
+        // Ciphertext is authenticated before it can be overwritten by in-place decryption.
+        poly1305_.update(input, inputLen);
+    }
+
+    const chacha_kernel& kernel = get_kernels().items[kernelIndex_];
+    const unsigned char* in = input;
+    unsigned char* out = output;
+    size_t remaining = inputLen;
+    while (remaining > 0) {
+        if (keyStreamOffset_ == keyStreamSize_) {
+            // Blocks beyond kMaxDataLen may wrap the counter, but they are never used.
+            kernel.fn(state_, keyStream_);
+            state_[12] += static_cast<uint32_t>(kernel.blocks);
+            keyStreamSize_ = kernel.blocks * kChaChaBlockSize;
+            keyStreamOffset_ = 0;
+        }
+        const size_t len = std::min(remaining, keyStreamSize_ - keyStreamOffset_);
+        xor_bytes(in, keyStream_ + keyStreamOffset_, len, out);
+        keyStreamOffset_ += len;
+        in += len;
+        out += len;
+        remaining -= len;
+    }
+
+    if (isEncryption_) {
+        poly1305_.update(output, inputLen);
+    }
+    dataLen_ += inputLen;
+    return true;
+}
+
+bool VirgilChaCha20Poly1305::finish(unsigned char* tag, size_t tagLen) noexcept {
+    if (tagLen > kTagSize) {
+        return false;
+    }
+    static const unsigned char kZeros[kPolyBlockSize] = { 0 };
+    poly1305_.update(kZeros, (kPolyBlockSize - dataLen_ % kPolyBlockSize) % kPolyBlockSize);
+
+    unsigned char lengths[kPolyBlockSize];
+    store_le64(lengths, authDataLen_);
+    store_le64(lengths + 8, dataLen_);
+    poly1305_.update(lengths, sizeof(lengths));
+
+    unsigned char fullTag[kTagSize];
+    poly1305_.finish(fullTag);
+    std::memcpy(tag, fullTag, tagLen);
+    secure_zeroize(fullTag, sizeof(fullTag));
+    secure_zeroize(keyStream_, sizeof(keyStream_));
+    keyStreamOffset_ = keyStreamSize_ = 0;
+    return true;
+}
+
+void VirgilChaCha20Poly1305::clear() noexcept {
+    secure_zeroize(state_, sizeof(state_));
+    secure_zeroize(keyStream_, sizeof(keyStream_));
+    poly1305_.clear();
+    keyStreamOffset_ = keyStreamSize_ = 0;
+    authDataLen_ = dataLen_ = 0;
+    hasKey_ = false;
+}
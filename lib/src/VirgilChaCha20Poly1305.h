@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_CHACHA20_POLY1305_H
+#define VIRGIL_CRYPTO_CHACHA20_POLY1305_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Poly1305 one-time authenticator (RFC 8439).
+ */
+class VirgilPoly1305 {
+public:
+    void start(const unsigned char key[32]) noexcept;
+
+    void update(const unsigned char* data, size_t dataLen) noexcept;
+
+    void finish(unsigned char mac[16]) noexcept;
+
+    void clear() noexcept;
+
+private:
+    void processBlocks(const unsigned char* data, size_t dataLen, bool isFinal) noexcept;
+
+private:
+#if defined(__SIZEOF_INT128__)
+    uint64_t r_[3];
+    uint64_t h_[3];
+    uint64_t pad_[2];
+#else
+    uint32_t r_[5];
+    uint32_t h_[5];
+    uint32_t pad_[4];
+#endif
+    unsigned char buffer_[16];
+    size_t bufferLen_;
+};
+
+/**
+ * @brief ChaCha20-Poly1305 AEAD construction (RFC 8439).
+ *
+ * Key stream is generated by the widest kernel supported by current CPU:
+ * AVX2 (8 blocks), SSE2 or NEON (4 blocks), or portable one (1 block).
+ *
+ * @note Single message can not exceed (2^32 - 1) * 64 bytes, because block counter is 32-bit.
+ */
+class VirgilChaCha20Poly1305 {
+public:
+    static constexpr size_t kKeySize = 32;
+    static constexpr size_t kNonceSize = 12;
+    static constexpr size_t kTagSize = 16;
+    static constexpr size_t kKeyStreamSizeMax = 8 * 64;
+
+    /**
+     * @brief Return number of the key stream kernels supported by the current CPU.
+     */
+    static size_t kernelCount() noexcept;
+
+    /**
+     * @brief Return name of the kernel with given index, kernel 0 is the widest one and is used by default.
+     * @return nullptr if index is out of range.
+     */
+    static const char* kernelName(size_t index) noexcept;
+
+    VirgilChaCha20Poly1305() noexcept;
+
+    ~VirgilChaCha20Poly1305() noexcept;
+
+    /**
+     * @brief Set key.
+     * @return false if key length is not equal to kKeySize.
+     */
+    bool setKey(const unsigned char* key, size_t keyLen) noexcept;
+
+    /**
+     * @brief Use kernel with given index for the next messages.
+     * @return false if index is out of range.
+     * @note Used by tests to check every kernel against the known vectors.
+     */
+    bool setKernel(size_t index) noexcept;
+
+    /**
+     * @brief Start new message with given nonce and additional authenticated data.
+     * @return false if key is not set, or nonce length is not equal to kNonceSize.
+     */
+    bool start(
+            const unsigned char* nonce, size_t nonceLen, const unsigned char* authData, size_t authDataLen,
+            bool isEncryption) noexcept;
+
+    /**
+     * @brief Encrypt or decrypt given data, output size is equal to the input size.
+     * @return false if total length of the processed data exceeds the block counter limit,
+     *     in this case nothing is processed.
+     * @note Input and output can point to the same buffer.
+     */
+    bool update(const unsigned char* input, size_t inputLen, unsigned char* output) noexcept;
+
+    /**
+     * @brief Write authentication tag of the processed data.
+     * @return false if tag length is greater than kTagSize.
+     */
+    bool finish(unsigned char* tag, size_t tagLen) noexcept;
+
+    /**
+     * @brief Zeroize key and state.
+     */
+    void clear() noexcept;
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilChaCha20Poly1305(const VirgilChaCha20Poly1305&) = delete;
+
+    VirgilChaCha20Poly1305& operator=(const VirgilChaCha20Poly1305&) = delete;
+    //! @endcond
+
+private:
+    uint32_t state_[16];
+    unsigned char keyStream_[kKeyStreamSizeMax];
+    size_t keyStreamOffset_;
+    size_t keyStreamSize_;
+    VirgilPoly1305 poly1305_;
+    size_t kernelIndex_;
+    uint64_t authDataLen_;
+    uint64_t dataLen_;
+    bool hasKey_;
+    bool isEncryption_;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_CHACHA20_POLY1305_H */
@@ -36,8 +36,10 @@
 
 #include <virgil/crypto/VirgilChunkCipher.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCryptoError.h>
@@ -45,12 +47,15 @@
 #include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
 
 #include "ScopeGuard.h"
+#include "parallel.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilChunkCipher;
 using virgil::crypto::VirgilDataSource;
 using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilRandomAccessDataSource;
+using virgil::crypto::VirgilPrivateKeyHandle;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 
@@ -59,6 +64,9 @@ using virgil::crypto::foundation::VirgilSymmetricCipher;
  */
 ///@{
 static const char* const kCustomParameterKey_ChunkSize = "chunkSize";
+static const char* const kCustomParameterKey_ChunkNonce = "chunkNonce";
+static const int kChunkNonce_Indexed = 1;
+static const size_t kContentInfoPreambleSize = 16;
 ///@}
 
 namespace virgil { namespace crypto { namespace internal {
@@ -105,6 +113,47 @@ static VirgilByteArray make_unique_nonce(const VirgilByteArray& nonce, const Vir
     return xor_octets(nonce, counter);
 }
 
+static VirgilByteArray make_nonce_counter(size_t index, size_t counterSize) {
+    VirgilByteArray counter(counterSize);
+    for (VirgilByteArray::reverse_iterator it = counter.rbegin(); it != counter.rend() && index != 0; ++it) {
+        *it = static_cast<unsigned char>(index & 0xFF);
+        index >>= 8;
+    }
+    return counter;
+}
+
+/**
+ * @brief Read from the source until buffer holds at least requiredSize unprocessed bytes.
+ *
+ * Processed bytes [0, dataOffset) are dropped once before the buffer grows,
+ * so every byte is moved at most once regardless of the source read size.
+ */
+static void refill_data(VirgilDataSource& source, VirgilByteArray& data, size_t& dataOffset, size_t requiredSize) {
+    if (!source.hasData() || data.size() - dataOffset >= requiredSize) {
+        return;
+    }
+    data.erase(data.begin(), data.begin() + dataOffset);
+    dataOffset = 0;
+    while (source.hasData() && data.size() < requiredSize) {
+        if (data.empty()) {
+            data = source.read();
+        } else {
+            VirgilByteArrayUtils::append(data, source.read());
+        }
+    }
+}
+
+/**
+ * @brief Encrypt or decrypt one chunk with the already configured cipher.
+ */
+static VirgilByteArray process_chunk(VirgilSymmetricCipher& cipher, const unsigned char* chunk, size_t chunkSize) {
+    VirgilByteArray result(chunkSize + cipher.blockSize() + cipher.authTagLength());
+    size_t writtenBytes = cipher.update(chunk, chunkSize, result.data(), result.size());
+    writtenBytes += cipher.finish(result.data() + writtenBytes, result.size() - writtenBytes);
+    result.resize(writtenBytes);
+    return result;
+}
+
 }}}
 
 void VirgilChunkCipher::encrypt(
@@ -122,6 +171,11 @@ void VirgilChunkCipher::encrypt(
             getSymmetricCipher().blockSize(), getSymmetricCipher().isSupportPadding());
 
     storeChunkSize(actualChunkSize);
+    if (indexedChunkNonce_) {
+        storeIndexedNonce();
+    } else {
+        customParams().removeInteger(str2bytes(kCustomParameterKey_ChunkNonce));
+    }
 
     if (embedContentInfo) {
         VirgilDataSink::safeWrite(sink, getContentInfo());
@@ -143,6 +197,19 @@ void VirgilChunkCipher::decryptWithKey(
     process(source, sink, 0);
 }
 
+void VirgilChunkCipher::decryptWithKey(
+        VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& recipientId,
+        const VirgilPrivateKeyHandle& privateKey) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithKey(recipientId, privateKey);
+
+    process(source, sink, 0);
+}
+
 void VirgilChunkCipher::decryptWithPassword(
         VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& pwd) {
 
@@ -155,6 +222,62 @@ void VirgilChunkCipher::decryptWithPassword(
     process(source, sink, 0);
 }
 
+void VirgilChunkCipher::decryptRangeWithKey(
+        VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+        const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithKey(recipientId, privateKey, privateKeyPassword);
+
+    processRange(source, sink, offset, length);
+}
+
+void VirgilChunkCipher::decryptRangeWithKey(
+        VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithKey(recipientId, privateKey);
+
+    processRange(source, sink, offset, length);
+}
+
+void VirgilChunkCipher::decryptRangeWithPassword(
+        VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+        const VirgilByteArray& pwd) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithPassword(pwd);
+
+    processRange(source, sink, offset, length);
+}
+
+void VirgilChunkCipher::setChunksThreadsNum(size_t threadsNum) {
+    chunksThreadsNum_ = threadsNum;
+}
+
+size_t VirgilChunkCipher::getChunksThreadsNum() const {
+    return chunksThreadsNum_;
+}
+
+void VirgilChunkCipher::setIndexedChunkNonce(bool enabled) {
+    indexedChunkNonce_ = enabled;
+}
+
+bool VirgilChunkCipher::isIndexedChunkNonce() const {
+    return indexedChunkNonce_;
+}
+
 void VirgilChunkCipher::storeChunkSize(size_t chunkSize) {
     if (chunkSize > std::numeric_limits<int>::max()) {
         throw make_error(VirgilCryptoError::InvalidArgument, "Chunk size is too big.");
@@ -170,6 +293,19 @@ size_t VirgilChunkCipher::retrieveChunkSize() const {
     return static_cast<size_t>(chunkSize);
 }
 
+void VirgilChunkCipher::storeIndexedNonce() {
+    customParams().setInteger(str2bytes(kCustomParameterKey_ChunkNonce), kChunkNonce_Indexed);
+}
+
+bool VirgilChunkCipher::retrieveIndexedNonce() const {
+    try {
+        return customParams().getInteger(str2bytes(kCustomParameterKey_ChunkNonce)) == kChunkNonce_Indexed;
+    } catch (...) {
+        // Parameter is absent, so data was encrypted by the previous version of the library.
+        return false;
+    }
+}
+
 
 void VirgilChunkCipher::process(VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize) {
 
@@ -178,10 +314,10 @@ void VirgilChunkCipher::process(VirgilDataSource& source, VirgilDataSink& sink,
     // Collect until Content Info fully read.
     while (source.hasData() && data.empty()) {
         VirgilByteArray chunk = source.read();
-        data = isReadyForEncryption() ? chunk : filterAndSetupContentInfo(chunk, !source.hasData());
+        data = isReadyForEncryption() ? std::move(chunk) : filterAndSetupContentInfo(chunk, !source.hasData());
     }
 
-    auto &symmetricCipher = getSymmetricCipher();
+    auto& symmetricCipher = getSymmetricCipher();
 
     // Adjust chunk size for decryption
     if (isReadyForDecryption()) {
@@ -190,25 +326,162 @@ void VirgilChunkCipher::process(VirgilDataSource& source, VirgilDataSink& sink,
             symmetricCipher.authTagLength());
     }
 
+    if (isReadyForEncryption() ? indexedChunkNonce_ : retrieveIndexedNonce()) {
+        processIndexed(source, sink, data, actualChunkSize);
+    } else {
+        processLegacy(source, sink, data, actualChunkSize);
+    }
+}
+
+
+void VirgilChunkCipher::processIndexed(
+        VirgilDataSource& source, VirgilDataSink& sink, VirgilByteArray& data, size_t actualChunkSize) {
+
+    const size_t batchSize = std::max(chunksThreadsNum_, size_t(1));
+
+    auto& symmetricCipher = getSymmetricCipher();
+    std::vector<VirgilSymmetricCipher> workerCiphers;
+    workerCiphers.reserve(batchSize - 1);
+
+    const VirgilByteArray nonce = symmetricCipher.iv();
+    VirgilByteArray nonceCounter(symmetricCipher.ivSize());
+
+    size_t dataOffset = 0;
+    std::vector<size_t> chunkOffsets;
+    std::vector<size_t> chunkSizes;
+    std::vector<VirgilByteArray> chunkNonces;
+    std::vector<VirgilByteArray> processedChunks;
+    chunkOffsets.reserve(batchSize);
+    chunkSizes.reserve(batchSize);
+    chunkNonces.reserve(batchSize);
+    processedChunks.reserve(batchSize);
+
+    do {
+        // Collect data for the batch of full chunks
+        internal::refill_data(source, data, dataOffset, actualChunkSize * batchSize);
+        // Split to chunks, chunks are referenced in place
+        chunkOffsets.clear();
+        chunkSizes.clear();
+        chunkNonces.clear();
+        while (chunkOffsets.size() < batchSize && (data.size() - dataOffset >= actualChunkSize ||
+               (data.size() > dataOffset && !source.hasData()))) {
+            const size_t chunkSize = std::min(actualChunkSize, data.size() - dataOffset);
+            chunkOffsets.push_back(dataOffset);
+            chunkSizes.push_back(chunkSize);
+            chunkNonces.push_back(internal::make_unique_nonce(nonce, nonceCounter));
+            internal::increment_octets(nonceCounter);
+            dataOffset += chunkSize;
+        }
+        while (workerCiphers.size() + 1 < chunkOffsets.size()) {
+            workerCiphers.push_back(cloneSymmetricCipher());
+        }
+        // Process (encrypt/decrypt)
+        processedChunks.resize(chunkOffsets.size());
+        internal::parallel_for(chunkOffsets.size(), batchSize, [&](size_t index) {
+            auto& cipher = (index == 0) ? symmetricCipher : workerCiphers[index - 1];
+            cipher.setIV(chunkNonces[index]);
+            cipher.reset();
+            processedChunks[index] = internal::process_chunk(
+                    cipher, data.data() + chunkOffsets[index], chunkSizes[index]);
+        });
+        // Write in the original order
+        for (const auto& processedChunk : processedChunks) {
+            VirgilDataSink::safeWrite(sink, processedChunk);
+        }
+        processedChunks.clear();
+    } while (source.hasData() || data.size() > dataOffset);
+}
+
+
+void VirgilChunkCipher::processLegacy(
+        VirgilDataSource& source, VirgilDataSink& sink, VirgilByteArray& data, size_t actualChunkSize) {
+
+    auto& symmetricCipher = getSymmetricCipher();
+    size_t dataOffset = 0;
+
     do {
         VirgilByteArray nonceCounter(symmetricCipher.ivSize());
         const VirgilByteArray nonce = symmetricCipher.iv();
 
         // Collect data for full chunk
-        while (source.hasData() && data.size() < actualChunkSize) {
-            VirgilByteArrayUtils::append(data, source.read());
-        }
+        internal::refill_data(source, data, dataOffset, actualChunkSize);
         // Process (encrypt/decrypt)
-        while (data.size() >= actualChunkSize || (!data.empty() && !source.hasData())) {
+        while (data.size() - dataOffset >= actualChunkSize || (data.size() > dataOffset && !source.hasData())) {
             // Reconfigure symmetric cipher
             symmetricCipher.setIV(internal::make_unique_nonce(nonce, nonceCounter));
             symmetricCipher.reset();
-            const VirgilByteArray chunk = VirgilByteArrayUtils::popBytes(data, actualChunkSize);
-            VirgilByteArray processedChunk;
-            VirgilByteArrayUtils::append(processedChunk, symmetricCipher.update(chunk));
-            VirgilByteArrayUtils::append(processedChunk, symmetricCipher.finish());
+            const size_t chunkSize = std::min(actualChunkSize, data.size() - dataOffset);
+            const VirgilByteArray processedChunk = internal::process_chunk(
+                    symmetricCipher, data.data() + dataOffset, chunkSize);
+            dataOffset += chunkSize;
             internal::increment_octets(nonceCounter);
             VirgilDataSink::safeWrite(sink, processedChunk);
         }
     } while (source.hasData());
 }
+
+
+void VirgilChunkCipher::processRange(
+        VirgilRandomAccessDataSource& source, VirgilDataSink& sink, size_t offset, size_t length) {
+
+    // Extract embedded content info, if exists.
+    VirgilByteArray contentInfo = source.read(0, kContentInfoPreambleSize);
+    const size_t contentInfoSize = defineContentInfoSize(contentInfo);
+    if (contentInfoSize > 0) {
+        contentInfo = source.read(0, contentInfoSize);
+    } else {
+        contentInfo.clear();
+    }
+    filterAndSetupContentInfo(contentInfo, true);
+
+    if (!retrieveIndexedNonce()) {
+        throw make_error(VirgilCryptoError::InvalidFormat,
+            "Range decryption is not supported for data encrypted by previous versions of the library.");
+    }
+
+    const size_t plainChunkSize = retrieveChunkSize();
+    if (plainChunkSize == 0) {
+        throw make_error(VirgilCryptoError::InvalidFormat, "Retrieved chunk size is zero.");
+    }
+
+    auto& symmetricCipher = getSymmetricCipher();
+    const size_t encryptedChunkSize = internal::adjustDecryptionChunkSize(plainChunkSize,
+            symmetricCipher.blockSize(), symmetricCipher.isSupportPadding(),
+            symmetricCipher.authTagLength());
+
+    length = std::min(length, std::numeric_limits<size_t>::max() - offset);
+    if (length == 0) {
+        return;
+    }
+
+    const VirgilByteArray nonce = symmetricCipher.iv();
+    const size_t firstChunkIndex = offset / plainChunkSize;
+    const size_t lastChunkIndex = (offset + length - 1) / plainChunkSize;
+
+    for (size_t chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        const VirgilByteArray encryptedChunk =
+                source.read(contentInfoSize + chunkIndex * encryptedChunkSize, encryptedChunkSize);
+        if (encryptedChunk.empty()) {
+            break;
+        }
+
+        symmetricCipher.setIV(internal::make_unique_nonce(
+                nonce, internal::make_nonce_counter(chunkIndex, symmetricCipher.ivSize())));
+        symmetricCipher.reset();
+        const VirgilByteArray chunk = internal::process_chunk(
+                symmetricCipher, encryptedChunk.data(), encryptedChunk.size());
+
+        // Write only requested part of the chunk
+        const size_t chunkOffset = chunkIndex * plainChunkSize;
+        const size_t rangeBegin = (offset > chunkOffset) ? offset - chunkOffset : 0;
+        const size_t rangeEnd = std::min(chunk.size(), offset + length - chunkOffset);
+        if (rangeBegin < rangeEnd) {
+            VirgilDataSink::safeWrite(sink, VirgilByteArray(chunk.begin() + rangeBegin, chunk.begin() + rangeEnd));
+        }
+
+        if (encryptedChunk.size() < encryptedChunkSize) {
+            // The last chunk was processed.
+            break;
+        }
+    }
+}
@@ -36,6 +36,8 @@
 
 #include <virgil/crypto/VirgilCipher.h>
 
+#include <algorithm>
+
 #include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
@@ -46,6 +48,7 @@ using virgil::crypto::VirgilCipher;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilPrivateKeyHandle;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 using virgil::crypto::make_error;
@@ -56,23 +59,67 @@ VirgilByteArray VirgilCipher::encrypt(const VirgilByteArray& data, bool embedCon
         clear();
     });
 
-    initEncryption();
+    prepareEncryption();
 
     VirgilByteArray encryptedData;
 
-    buildContentInfo();
-
     if (embedContentInfo) {
         VirgilByteArray contentInfo = getContentInfo();
         encryptedData.swap(contentInfo);
     }
 
-    VirgilByteArrayUtils::append(encryptedData, getSymmetricCipher().update(data));
-    VirgilByteArrayUtils::append(encryptedData, getSymmetricCipher().finish());
+    size_t writtenBytes = encryptedData.size();
+    encryptedData.resize(writtenBytes + getSymmetricCipher().defineEncryptedSize(data.size()));
 
+    writtenBytes += getSymmetricCipher().update(
+            data.data(), data.size(), encryptedData.data() + writtenBytes, encryptedData.size() - writtenBytes);
+    writtenBytes += getSymmetricCipher().finish(
+            encryptedData.data() + writtenBytes, encryptedData.size() - writtenBytes);
+
+    encryptedData.resize(writtenBytes);
     return encryptedData;
 }
 
+size_t VirgilCipher::encrypt(
+        const unsigned char* data, size_t dataLen, unsigned char* encryptedData, size_t encryptedDataLen,
+        bool embedContentInfo) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    prepareEncryption();
+
+    size_t writtenBytes = 0;
+
+    if (embedContentInfo) {
+        VirgilByteArray contentInfo = getContentInfo();
+        if (contentInfo.size() > encryptedDataLen) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Buffer is too small for the encrypted data.");
+        }
+        writtenBytes = std::copy(contentInfo.cbegin(), contentInfo.cend(), encryptedData) - encryptedData;
+    }
+
+    writtenBytes += getSymmetricCipher().update(
+            data, dataLen, encryptedData + writtenBytes, encryptedDataLen - writtenBytes);
+    writtenBytes += getSymmetricCipher().finish(
+            encryptedData + writtenBytes, encryptedDataLen - writtenBytes);
+
+    return writtenBytes;
+}
+
+size_t VirgilCipher::defineEncryptedSize(size_t dataSize, bool embedContentInfo) {
+
+    auto disposer = ScopeGuardOnException([this]() {
+        clear();
+    });
+
+    prepareEncryption();
+
+    const size_t contentInfoSize = embedContentInfo ? getContentInfo().size() : 0;
+    return contentInfoSize + getSymmetricCipher().defineEncryptedSize(dataSize);
+}
+
 VirgilByteArray VirgilCipher::decryptWithKey(
         const VirgilByteArray& encryptedData,
         const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
@@ -83,6 +130,15 @@ VirgilByteArray VirgilCipher::decryptWithKey(
     return decrypt(encryptedData);
 }
 
+VirgilByteArray VirgilCipher::decryptWithKey(
+        const VirgilByteArray& encryptedData,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    initDecryptionWithKey(recipientId, privateKey);
+
+    return decrypt(encryptedData);
+}
+
 VirgilByteArray VirgilCipher::decryptWithPassword(const VirgilByteArray& encryptedData, const VirgilByteArray& pwd) {
 
     initDecryptionWithPassword(pwd);
@@ -108,3 +164,11 @@ VirgilByteArray VirgilCipher::decrypt(const VirgilByteArray& encryptedData) {
 
     return decryptedData;
 }
+
+void VirgilCipher::prepareEncryption() {
+    if (!isReadyForEncryption()) {
+        initEncryption();
+    }
+
+    buildContentInfo();
+}
@@ -46,6 +46,7 @@
 
 #include "utils.h"
 #include "VirgilContentInfoFilter.h"
+#include "VirgilContentInfoUtils.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
@@ -53,6 +54,9 @@ using virgil::crypto::VirgilCipherBase;
 using virgil::crypto::VirgilCustomParams;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::VirgilContentInfo;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilRecipientSet;
 using virgil::crypto::make_error;
 
 using virgil::crypto::foundation::VirgilRandom;
@@ -61,6 +65,15 @@ using virgil::crypto::foundation::VirgilAsymmetricCipher;
 using virgil::crypto::foundation::VirgilPBE;
 
 using virgil::crypto::internal::VirgilContentInfoFilter;
+using virgil::crypto::internal::VirgilContentInfoUtils;
+
+/**
+ * @name Configuration constants.
+ */
+///@{
+static constexpr VirgilSymmetricCipher::Padding
+        kSymmetricCipher_Padding = VirgilSymmetricCipher::Padding::PKCS7;
+///@}
 
 namespace virgil { namespace crypto {
 
@@ -72,7 +85,9 @@ public:
     Impl() noexcept :
             random(VirgilByteArrayUtils::stringToBytes(std::string("virgil::VirgilCipherBase"))),
             symmetricCipher(), symmetricCipherKey(), contentInfo(), contentInfoFilter(),
-            recipientId(), privateKey(), pwd(), isInited(false) {}
+            recipientId(), privateKey(), privateKeyHandle(), pwd(), isInited(false), recipientsThreadsNum(1),
+            contentEncryptionAlgorithm(VirgilContentInfoUtils::kSymmetricCipher_Algorithm), publicKeyHandles(),
+            keyRecipientPublicKeys() {}
 
 public:
     VirgilRandom random;
@@ -82,22 +97,17 @@ public:
     VirgilContentInfoFilter contentInfoFilter;
     VirgilByteArray recipientId;
     VirgilByteArray privateKey;
+    std::shared_ptr<const VirgilPrivateKeyHandle> privateKeyHandle;
     VirgilByteArray pwd;
     bool isInited;
+    size_t recipientsThreadsNum;
+    VirgilSymmetricCipher::Algorithm contentEncryptionAlgorithm;
+    std::map<VirgilByteArray, VirgilPublicKeyHandle> publicKeyHandles; ///< public key -> parsed public key
+    std::map<VirgilByteArray, VirgilByteArray> keyRecipientPublicKeys; ///< recipient id -> public key
 };
 
 }}
 
-/**
- * @name Configuration constants.
- */
-///@{
-static constexpr VirgilSymmetricCipher::Padding
-        kSymmetricCipher_Padding = VirgilSymmetricCipher::Padding::PKCS7;
-static constexpr VirgilSymmetricCipher::Algorithm
-        kSymmetricCipher_Algorithm = VirgilSymmetricCipher::Algorithm::AES_256_GCM;
-///@}
-
 VirgilCipherBase::VirgilCipherBase() : impl_(std::make_unique<Impl>()) {}
 
 VirgilCipherBase::VirgilCipherBase(VirgilCipherBase&& rhs) noexcept = default;
@@ -107,12 +117,44 @@ VirgilCipherBase& VirgilCipherBase::operator=(VirgilCipherBase&& rhs) noexcept =
 VirgilCipherBase::~VirgilCipherBase() noexcept = default;
 
 void VirgilCipherBase::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey) {
-    VirgilAsymmetricCipher::checkPublicKey(publicKey);
-    impl_->contentInfo.addKeyRecipient(recipientId, publicKey);
+    addKeyRecipient(recipientId, VirgilPublicKeyHandle(publicKey));
+}
+
+void VirgilCipherBase::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey) {
+    impl_->contentInfo.addKeyRecipient(recipientId, publicKey.getKey());
+    impl_->publicKeyHandles.emplace(publicKey.getKey(), publicKey);
+    impl_->keyRecipientPublicKeys[recipientId] = publicKey.getKey();
+}
+
+void VirgilCipherBase::addKeyRecipients(const VirgilRecipientSet& recipients) {
+    // Check all recipients first, so nothing is added if any of them is rejected.
+    for (const auto& recipient : recipients.keyRecipients_) {
+        if (keyRecipientExists(recipient.first)) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Recipient with given 'recipientId' already exists");
+        }
+    }
+    for (const auto& recipient : recipients.keyRecipients_) {
+        addKeyRecipient(recipient.first, recipient.second);
+    }
 }
 
 void VirgilCipherBase::removeKeyRecipient(const VirgilByteArray& recipientId) {
     impl_->contentInfo.removeKeyRecipient(recipientId);
+
+    auto recipientPublicKey = impl_->keyRecipientPublicKeys.find(recipientId);
+    if (recipientPublicKey == impl_->keyRecipientPublicKeys.end()) {
+        return;
+    }
+    const VirgilByteArray publicKey = std::move(recipientPublicKey->second);
+    impl_->keyRecipientPublicKeys.erase(recipientPublicKey);
+
+    // Parsed public key can be shared by several recipients.
+    for (const auto& keyRecipient : impl_->keyRecipientPublicKeys) {
+        if (keyRecipient.second == publicKey) {
+            return;
+        }
+    }
+    impl_->publicKeyHandles.erase(publicKey);
 }
 
 bool VirgilCipherBase::keyRecipientExists(const VirgilByteArray& recipientId) const {
@@ -133,6 +175,24 @@ bool VirgilCipherBase::passwordRecipientExists(const VirgilByteArray& password)
 
 void VirgilCipherBase::removeAllRecipients() {
     impl_->contentInfo.removeAllRecipients();
+    impl_->publicKeyHandles.clear();
+    impl_->keyRecipientPublicKeys.clear();
+}
+
+void VirgilCipherBase::setRecipientsThreadsNum(size_t threadsNum) {
+    impl_->recipientsThreadsNum = threadsNum;
+}
+
+size_t VirgilCipherBase::getRecipientsThreadsNum() const {
+    return impl_->recipientsThreadsNum;
+}
+
+void VirgilCipherBase::setContentEncryptionAlgorithm(VirgilSymmetricCipher::Algorithm algorithm) {
+    impl_->contentEncryptionAlgorithm = algorithm;
+}
+
+VirgilSymmetricCipher::Algorithm VirgilCipherBase::getContentEncryptionAlgorithm() const {
+    return impl_->contentEncryptionAlgorithm;
 }
 
 VirgilByteArray VirgilCipherBase::getContentInfo() const {
@@ -209,7 +269,7 @@ VirgilByteArray VirgilCipherBase::filterAndSetupContentInfo(const VirgilByteArra
 
 void VirgilCipherBase::initEncryption() {
 
-    impl_->symmetricCipher = VirgilSymmetricCipher(kSymmetricCipher_Algorithm);
+    impl_->symmetricCipher = VirgilSymmetricCipher(impl_->contentEncryptionAlgorithm);
     impl_->symmetricCipherKey = impl_->random.randomize(impl_->symmetricCipher.keyLength());
     auto symmetricCipherIV = impl_->random.randomize(impl_->symmetricCipher.ivSize());
     impl_->symmetricCipher.setEncryptionKey(impl_->symmetricCipherKey);
@@ -252,6 +312,9 @@ void VirgilCipherBase::accomplishInitDecryption() {
         contentEncryptionKey = impl_->contentInfo.decryptKeyRecipient(
                 impl_->recipientId,
                 [&, this](const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey) -> VirgilByteArray {
+                    if (impl_->privateKeyHandle) {
+                        return doDecryptWithKey(algorithm, encryptedKey, *impl_->privateKeyHandle);
+                    }
                     return doDecryptWithKey(algorithm, encryptedKey, impl_->privateKey, impl_->pwd);
                 }
         );
@@ -264,6 +327,7 @@ void VirgilCipherBase::accomplishInitDecryption() {
     impl_->symmetricCipher = VirgilSymmetricCipher();
     impl_->symmetricCipher.fromAsn1(impl_->contentInfo.getContentEncryptionAlgorithm());
     impl_->symmetricCipher.setDecryptionKey(contentEncryptionKey);
+    impl_->symmetricCipherKey = std::move(contentEncryptionKey);
 
     if (impl_->symmetricCipher.isSupportPadding()) {
         impl_->symmetricCipher.setPadding(kSymmetricCipher_Padding);
@@ -297,41 +361,49 @@ void VirgilCipherBase::initDecryptionWithKey(
 
     impl_->recipientId = recipientId;
     impl_->privateKey = privateKey;
+    impl_->privateKeyHandle.reset();
     impl_->pwd = privateKeyPassword;
     impl_->isInited = true;
 }
 
 
-void VirgilCipherBase::buildContentInfo() {
-    const auto& symmetricCipherKey = impl_->symmetricCipherKey;
-    auto& random = impl_->random;
-
-    impl_->contentInfo.encryptKeyRecipients(
-            [&symmetricCipherKey](const VirgilByteArray& publicKey) -> VirgilContentInfo::EncryptionResult {
-                VirgilAsymmetricCipher asymmetricCipher;
-                asymmetricCipher.setPublicKey(publicKey);
-                return { asymmetricCipher.toAsn1(), asymmetricCipher.encrypt(symmetricCipherKey) };
-            }
-    );
+void VirgilCipherBase::initDecryptionWithKey(
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
 
-    impl_->contentInfo.encryptPasswordRecipients(
-            [&symmetricCipherKey, &random](const VirgilByteArray& password) -> VirgilContentInfo::EncryptionResult {
-                const VirgilByteArray salt = random.randomize(16);
-                const size_t iterationCount = random.randomize(3072, 8192);
+    if (recipientId.empty()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not decrypt with empty 'recipientId'");
+    }
 
-                VirgilPBE pbe(VirgilPBE::Algorithm::PKCS5, salt, iterationCount);
+    impl_->recipientId = recipientId;
+    impl_->privateKeyHandle = std::make_shared<const VirgilPrivateKeyHandle>(privateKey);
+    impl_->isInited = true;
+}
 
-                return { pbe.toAsn1(), pbe.encrypt(symmetricCipherKey, password) };
-            }
-    );
 
-    impl_->contentInfo.setContentEncryptionAlgorithm(impl_->symmetricCipher.toAsn1());
+void VirgilCipherBase::buildContentInfo() {
+    const auto& symmetricCipherKey = impl_->symmetricCipherKey;
+    const auto& publicKeyHandles = impl_->publicKeyHandles;
+
+    VirgilContentInfoUtils::encryptRecipients(
+            impl_->contentInfo, impl_->symmetricCipher, symmetricCipherKey,
+            [&symmetricCipherKey, &publicKeyHandles](
+                    const VirgilByteArray& publicKey) -> VirgilContentInfo::EncryptionResult {
+                // Every key recipient is added with already parsed public key.
+                const auto publicKeyHandle = publicKeyHandles.find(publicKey);
+                if (publicKeyHandle == publicKeyHandles.end()) {
+                    throw make_error(VirgilCryptoError::InvalidState, "Public key of the key recipient is not parsed.");
+                }
+                return { publicKeyHandle->second.getAlgorithm(), publicKeyHandle->second.encrypt(symmetricCipherKey) };
+            },
+            impl_->random, impl_->recipientsThreadsNum
+    );
 }
 
 void VirgilCipherBase::clear() {
     impl_->isInited = false;
     impl_->symmetricCipher.clear();
     impl_->recipientId.clear();
+    impl_->privateKeyHandle.reset();
     impl_->contentInfoFilter.reset();
 
     VirgilByteArrayUtils::zeroize(impl_->symmetricCipherKey);
@@ -364,6 +436,27 @@ VirgilSymmetricCipher& VirgilCipherBase::getSymmetricCipher() {
 }
 
 
+VirgilSymmetricCipher VirgilCipherBase::cloneSymmetricCipher() const {
+    if (!isReadyForEncryption() && !isReadyForDecryption()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Symmetric cipher is not configured.");
+    }
+
+    VirgilSymmetricCipher symmetricCipher;
+    symmetricCipher.fromAsn1(impl_->symmetricCipher.toAsn1());
+    if (impl_->symmetricCipher.isEncryptionMode()) {
+        symmetricCipher.setEncryptionKey(impl_->symmetricCipherKey);
+    } else {
+        symmetricCipher.setDecryptionKey(impl_->symmetricCipherKey);
+    }
+
+    if (symmetricCipher.isSupportPadding()) {
+        symmetricCipher.setPadding(kSymmetricCipher_Padding);
+    }
+
+    return symmetricCipher;
+}
+
+
 VirgilByteArray VirgilCipherBase::doDecryptWithKey(
         const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
         const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword) const {
@@ -374,6 +467,14 @@ VirgilByteArray VirgilCipherBase::doDecryptWithKey(
 }
 
 
+VirgilByteArray VirgilCipherBase::doDecryptWithKey(
+        const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
+        const VirgilPrivateKeyHandle& privateKey) const {
+
+    return privateKey.decrypt(encryptedKey);
+}
+
+
 VirgilByteArray VirgilCipherBase::doDecryptWithPassword(
         const VirgilByteArray& encryptedKey, const VirgilByteArray& encryptionAlgorithm,
         const VirgilByteArray& password) const {
@@ -40,13 +40,18 @@
 #include <virgil/crypto/foundation/cms/VirgilCMSContent.h>
 #include <virgil/crypto/foundation/cms/VirgilCMSContentInfo.h>
 #include <virgil/crypto/foundation/cms/VirgilCMSEnvelopedData.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSKeyTransRecipient.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSPasswordRecipient.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
 #include "utils.h"
+#include "parallel.h"
+#include "VirgilCMSConstants.h"
 
 #include <algorithm>
 #include <set>
+#include <vector>
 
 
 using virgil::crypto::VirgilContentInfo;
@@ -64,20 +69,161 @@ using virgil::crypto::foundation::cms::VirgilCMSPasswordRecipient;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 
-
 namespace virgil { namespace crypto {
 
 /**
  * @brief Handle class fields.
+ *
+ * When content info is read, key transport recipients are validated, but not decoded,
+ * only their identifiers are indexed, so search of the recipient takes logarithmic time,
+ * and only found recipient is decoded.
+ * Indexed recipients are decoded all together only when content info is modified,
+ * and are decoded to the temporary structure when content info is written,
+ * so const methods never change the index.
  */
 class VirgilContentInfo::Impl {
+public:
+    /**
+     * @brief Location of the encoded key transport recipient within enveloped data.
+     */
+    struct KeyTransRecipientLocation {
+        size_t offset;
+        size_t size;
+    };
+
+    /**
+     * @brief Read enveloped data, and index key transport recipients instead of decoding them.
+     */
+    void indexEnvelopedData(VirgilByteArray envelopedData);
+
+    /**
+     * @brief Decode key transport recipient located at the given position within enveloped data.
+     */
+    VirgilCMSKeyTransRecipient decodeKeyTransRecipient(const KeyTransRecipientLocation& location) const;
+
+    /**
+     * @brief Decode all key transport recipients in the original order, including indexed ones.
+     */
+    std::vector<VirgilCMSKeyTransRecipient> decodeKeyTransRecipients() const;
+
+    /**
+     * @brief Decode all indexed key transport recipients, and drop index.
+     */
+    void decodeIndexedKeyTransRecipients();
+
 public:
     VirgilCMSContentInfo cmsContentInfo;
     VirgilCMSEnvelopedData cmsEnvelopedData;
     std::map<VirgilByteArray, VirgilByteArray> keyRecipients; ///< recipient id -> public key
     std::set<VirgilByteArray> passwordRecipients; ///< passwords
+    VirgilByteArray indexedEnvelopedData; ///< enveloped data that contains indexed key transport recipients
+    std::vector<KeyTransRecipientLocation> keyTransRecipientLocations; ///< indexed recipients in the original order
+    std::map<VirgilByteArray, size_t> keyTransRecipientIndex; ///< recipient id -> location index
 };
 
+void VirgilContentInfo::Impl::indexEnvelopedData(VirgilByteArray envelopedData) {
+    cmsEnvelopedData.keyTransRecipients.clear();
+    cmsEnvelopedData.passwordRecipients.clear();
+    keyTransRecipientLocations.clear();
+    keyTransRecipientIndex.clear();
+    indexedEnvelopedData.clear();
+
+    std::vector<KeyTransRecipientLocation> locations;
+    std::map<VirgilByteArray, size_t> index;
+
+    VirgilAsn1Reader asn1Reader(envelopedData);
+    (void) asn1Reader.readSequence();
+    (void) asn1Reader.readInteger(); // Ignore version
+    if (asn1Reader.readContextTag(kCMS_OriginatorInfoTag) > 0) {
+        (void) asn1Reader.readData(); // Ignore originatorInfo
+    }
+
+    const size_t setLen = asn1Reader.readSet();
+    const size_t setEnd = asn1Reader.getPosition() + setLen;
+    while (asn1Reader.getPosition() < setEnd) {
+        const size_t recipientOffset = asn1Reader.getPosition();
+
+        if (asn1Reader.readContextTag(kCMS_PasswordRecipientTag) > 0) {
+            VirgilCMSPasswordRecipient recipient;
+            recipient.fromAsn1(asn1Reader.readData());
+            cmsEnvelopedData.passwordRecipients.push_back(recipient);
+            continue;
+        }
+
+        bool unsupportedRecipientInfoDefined =
+                asn1Reader.readContextTag(kCMS_KeyAgreeRecipientTag) > 0 ||
+                        asn1Reader.readContextTag(kCMS_KEKRecipientTag) > 0 ||
+                        asn1Reader.readContextTag(kCMS_OtherRecipientTag) > 0;
+        if (unsupportedRecipientInfoDefined) {
+            throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Unsupported CMS RecipientInfo.");
+        }
+
+        const size_t recipientSize = asn1Reader.skipData();
+        asn1Reader.setPosition(recipientOffset);
+
+        // Same validation as VirgilCMSKeyTransRecipient::asn1Read(), but without copying of the fields.
+        (void) asn1Reader.readSequence();
+        if (asn1Reader.readInteger() != kCMS_KeyTransRecipientVersion) {
+            throw make_error(VirgilCryptoError::InvalidFormat,
+                    "KeyTransRecipientInfo structure is malformed. Incorrect CMS version number.");
+        }
+        if (asn1Reader.readContextTag(kCMS_SubjectKeyTag) == 0) {
+            throw make_error(VirgilCryptoError::InvalidFormat,
+                    "KeyTransRecipientInfo structure is malformed. Parameter 'rid' is not defined.");
+        }
+        VirgilByteArray recipientId = asn1Reader.readOctetString();
+        (void) asn1Reader.skipData(); // keyEncryptionAlgorithm
+        (void) asn1Reader.readOctetString(); // encryptedKey
+        if (asn1Reader.getPosition() > recipientOffset + recipientSize) {
+            throw make_error(VirgilCryptoError::InvalidFormat, "KeyTransRecipientInfo structure is malformed.");
+        }
+        // First recipient with the given identifier is used, the same as in the sequential search.
+        index.emplace(std::move(recipientId), locations.size());
+        locations.push_back({ recipientOffset, recipientSize });
+
+        asn1Reader.setPosition(recipientOffset + recipientSize);
+    }
+    cmsEnvelopedData.encryptedContent.fromAsn1(asn1Reader.readData());
+
+    keyTransRecipientLocations.swap(locations);
+    keyTransRecipientIndex.swap(index);
+    indexedEnvelopedData = std::move(envelopedData);
+}
+
+VirgilCMSKeyTransRecipient VirgilContentInfo::Impl::decodeKeyTransRecipient(
+        const KeyTransRecipientLocation& location) const {
+
+    const auto recipientBegin = indexedEnvelopedData.cbegin() + location.offset;
+    VirgilCMSKeyTransRecipient recipient;
+    recipient.fromAsn1(VirgilByteArray(recipientBegin, recipientBegin + location.size));
+    return recipient;
+}
+
+std::vector<VirgilCMSKeyTransRecipient> VirgilContentInfo::Impl::decodeKeyTransRecipients() const {
+    std::vector<VirgilCMSKeyTransRecipient> recipients;
+    recipients.reserve(keyTransRecipientLocations.size() + cmsEnvelopedData.keyTransRecipients.size());
+    for (const auto& location : keyTransRecipientLocations) {
+        recipients.push_back(decodeKeyTransRecipient(location));
+    }
+    recipients.insert(
+            recipients.end(),
+            cmsEnvelopedData.keyTransRecipients.cbegin(), cmsEnvelopedData.keyTransRecipients.cend());
+    return recipients;
+}
+
+void VirgilContentInfo::Impl::decodeIndexedKeyTransRecipients() {
+    if (keyTransRecipientLocations.empty()) {
+        return;
+    }
+
+    auto recipients = decodeKeyTransRecipients();
+    cmsEnvelopedData.keyTransRecipients.swap(recipients);
+
+    keyTransRecipientLocations.clear();
+    keyTransRecipientIndex.clear();
+    indexedEnvelopedData.clear();
+}
+
 }}
 
 VirgilContentInfo::VirgilContentInfo() : impl_(std::make_unique<VirgilContentInfo::Impl>()) {}
@@ -106,7 +252,11 @@ bool VirgilContentInfo::hasKeyRecipient(const VirgilByteArray& recipientId) cons
     if (impl_->keyRecipients.find(recipientId) != impl_->keyRecipients.end()) {
         return true;
     }
-    // 2. Search within CMS representation
+    // 2. Search within indexed CMS representation
+    if (impl_->keyTransRecipientIndex.find(recipientId) != impl_->keyTransRecipientIndex.end()) {
+        return true;
+    }
+    // 3. Search within CMS representation
     return std::find_if(
             impl_->cmsEnvelopedData.keyTransRecipients.cbegin(),
             impl_->cmsEnvelopedData.keyTransRecipients.cend(),
@@ -120,6 +270,7 @@ void VirgilContentInfo::removeKeyRecipient(const VirgilByteArray& recipientId) {
     // Remove from the RAW representation
     impl_->keyRecipients.erase(recipientId);
     // Remove from the CMS representation
+    impl_->decodeIndexedKeyTransRecipients();
     auto found = std::find_if(
             // Use non const iterators, it's cause an error for vector::erase() in gcc 4.8.5
             impl_->cmsEnvelopedData.keyTransRecipients.begin(),
@@ -138,6 +289,9 @@ void VirgilContentInfo::removeKeyRecipients() {
     impl_->keyRecipients.clear();
     // Remove from the CMS representation
     impl_->cmsEnvelopedData.keyTransRecipients.clear();
+    impl_->keyTransRecipientLocations.clear();
+    impl_->keyTransRecipientIndex.clear();
+    impl_->indexedEnvelopedData.clear();
 }
 
 void VirgilContentInfo::addPasswordRecipient(const VirgilByteArray& pwd) {
@@ -185,6 +339,11 @@ VirgilByteArray VirgilContentInfo::decryptKeyRecipient(const VirgilByteArray& re
     if (!decrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
+    auto indexed = impl_->keyTransRecipientIndex.find(recipientId);
+    if (indexed != impl_->keyTransRecipientIndex.end()) {
+        const auto keyRecipient = impl_->decodeKeyTransRecipient(impl_->keyTransRecipientLocations[indexed->second]);
+        return decrypt(keyRecipient.keyEncryptionAlgorithm, keyRecipient.encryptedKey);
+    }
     for (const auto& keyRecipient: impl_->cmsEnvelopedData.keyTransRecipients) {
         if (keyRecipient.recipientIdentifier == recipientId) {
             return decrypt(keyRecipient.keyEncryptionAlgorithm, keyRecipient.encryptedKey);
@@ -208,38 +367,59 @@ VirgilByteArray VirgilContentInfo::decryptPasswordRecipient(
     return VirgilByteArray();
 }
 
-void VirgilContentInfo::encryptKeyRecipients(std::function<EncryptionResult(const VirgilByteArray&)> encrypt) {
+void VirgilContentInfo::encryptKeyRecipients(
+        std::function<EncryptionResult(const VirgilByteArray&)> encrypt, size_t threadsNum) {
+
     if (!encrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
-    for (const auto& keyRecipient : impl_->keyRecipients) {
-        const auto& recipientId = keyRecipient.first;
-        const auto& publicKey = keyRecipient.second;
 
-        auto encryptionResult = encrypt(publicKey);
+    impl_->decodeIndexedKeyTransRecipients();
+
+    std::vector<std::map<VirgilByteArray, VirgilByteArray>::const_iterator> keyRecipients;
+    keyRecipients.reserve(impl_->keyRecipients.size());
+    for (auto it = impl_->keyRecipients.cbegin(); it != impl_->keyRecipients.cend(); ++it) {
+        keyRecipients.push_back(it);
+    }
+
+    std::vector<EncryptionResult> encryptionResults(keyRecipients.size());
+    internal::parallel_for(keyRecipients.size(), threadsNum, [&](size_t index) {
+        encryptionResults[index] = encrypt(keyRecipients[index]->second);
+    });
 
+    auto& keyTransRecipients = impl_->cmsEnvelopedData.keyTransRecipients;
+    keyTransRecipients.reserve(keyTransRecipients.size() + keyRecipients.size());
+    for (size_t i = 0; i < keyRecipients.size(); ++i) {
         VirgilCMSKeyTransRecipient recipient;
-        recipient.recipientIdentifier = recipientId;
-        recipient.keyEncryptionAlgorithm = encryptionResult.encryptionAlgorithm;
-        recipient.encryptedKey = encryptionResult.encryptedContent;
+        recipient.recipientIdentifier = keyRecipients[i]->first;
+        recipient.keyEncryptionAlgorithm = std::move(encryptionResults[i].encryptionAlgorithm);
+        recipient.encryptedKey = std::move(encryptionResults[i].encryptedContent);
 
-        impl_->cmsEnvelopedData.keyTransRecipients.push_back(recipient);
+        keyTransRecipients.push_back(std::move(recipient));
     }
     impl_->keyRecipients.clear();
 }
 
-void VirgilContentInfo::encryptPasswordRecipients(std::function<EncryptionResult(const VirgilByteArray&)> encrypt) {
+void VirgilContentInfo::encryptPasswordRecipients(
+        std::function<EncryptionResult(const VirgilByteArray&)> encrypt, size_t threadsNum) {
+
     if (!encrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
-    for (const auto& password : impl_->passwordRecipients) {
-        auto encryptionResult = encrypt(password);
 
+    const std::vector<VirgilByteArray> passwords(impl_->passwordRecipients.cbegin(), impl_->passwordRecipients.cend());
+
+    std::vector<EncryptionResult> encryptionResults(passwords.size());
+    internal::parallel_for(passwords.size(), threadsNum, [&](size_t index) {
+        encryptionResults[index] = encrypt(passwords[index]);
+    });
+
+    for (auto& encryptionResult : encryptionResults) {
         VirgilCMSPasswordRecipient recipient;
-        recipient.keyEncryptionAlgorithm = encryptionResult.encryptionAlgorithm;
-        recipient.encryptedKey = encryptionResult.encryptedContent;
+        recipient.keyEncryptionAlgorithm = std::move(encryptionResult.encryptionAlgorithm);
+        recipient.encryptedKey = std::move(encryptionResult.encryptedContent);
 
-        impl_->cmsEnvelopedData.passwordRecipients.push_back(recipient);
+        impl_->cmsEnvelopedData.passwordRecipients.push_back(std::move(recipient));
     }
     impl_->passwordRecipients.clear();
 }
@@ -257,15 +437,23 @@ size_t VirgilContentInfo::defineSize(const VirgilByteArray& contentInfoData) {
 }
 
 size_t VirgilContentInfo::asn1Write(VirgilAsn1Writer& asn1Writer, size_t childWrittenBytes) const {
-    impl_->cmsContentInfo.cmsContent.contentType = VirgilCMSContent::Type::EnvelopedData;
-    impl_->cmsContentInfo.cmsContent.content = impl_->cmsEnvelopedData.toAsn1();
-    return impl_->cmsContentInfo.asn1Write(asn1Writer, childWrittenBytes);
+    VirgilCMSContentInfo cmsContentInfo = impl_->cmsContentInfo;
+    cmsContentInfo.cmsContent.contentType = VirgilCMSContent::Type::EnvelopedData;
+    if (impl_->keyTransRecipientLocations.empty()) {
+        cmsContentInfo.cmsContent.content = impl_->cmsEnvelopedData.toAsn1();
+    } else {
+        VirgilCMSEnvelopedData cmsEnvelopedData = impl_->cmsEnvelopedData;
+        cmsEnvelopedData.keyTransRecipients = impl_->decodeKeyTransRecipients();
+        cmsContentInfo.cmsContent.content = cmsEnvelopedData.toAsn1();
+    }
+    return cmsContentInfo.asn1Write(asn1Writer, childWrittenBytes);
 }
 
 void VirgilContentInfo::asn1Read(VirgilAsn1Reader& asn1Reader) {
     impl_->cmsContentInfo.asn1Read(asn1Reader);
     if (impl_->cmsContentInfo.cmsContent.contentType == foundation::cms::VirgilCMSContent::Type::EnvelopedData) {
-        impl_->cmsEnvelopedData.fromAsn1(impl_->cmsContentInfo.cmsContent.content);
+        impl_->indexEnvelopedData(std::move(impl_->cmsContentInfo.cmsContent.content));
+        impl_->cmsContentInfo.cmsContent.content.clear();
     } else {
         throw make_error(VirgilCryptoError::InvalidFormat);
     }
@@ -276,6 +464,7 @@ bool VirgilContentInfo::isReadyForEncryption() {
 }
 
 bool VirgilContentInfo::isReadyForDecryption() {
-    return !impl_->cmsEnvelopedData.keyTransRecipients.empty() || !impl_->cmsEnvelopedData.passwordRecipients.empty();
+    return !impl_->cmsEnvelopedData.keyTransRecipients.empty() || !impl_->keyTransRecipientLocations.empty() ||
+           !impl_->cmsEnvelopedData.passwordRecipients.empty();
 }
 
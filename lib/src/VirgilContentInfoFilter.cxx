@@ -37,14 +37,14 @@
 #include "VirgilContentInfoFilter.h"
 
 
-#include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/VirgilContentInfo.h>
 
+#include <algorithm>
+
 #include "utils.h"
 
 using virgil::crypto::VirgilByteArray;
-using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilContentInfo;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::make_error;
@@ -87,6 +87,7 @@ VirgilContentInfoFilter::VirgilContentInfoFilter() : impl_(std::make_unique<Impl
 
 void VirgilContentInfoFilter::reset() {
     impl_->state = State::WaitingPreamble;
+    impl_->expectedContentInfoSize = 0;
     impl_->contentInfoData.clear();
     impl_->encryptedData.clear();
 }
@@ -129,38 +130,49 @@ void VirgilContentInfoFilter::filterData(const VirgilByteArray& encryptedData) {
         throw make_error(VirgilCryptoError::InvalidState, "VirgilContentInfoFilter::filterData()");
     }
 
-    // Append new data.
-    VirgilByteArrayUtils::append(impl_->contentInfoData, encryptedData);
-
-    // Check preamble size.
-    if (impl_->contentInfoData.size() < kContentInfoPreambleSize) {
-        return;
-    }
-
-    // Define content info first time.
+    // Copy to the content info buffer only bytes that can belong to it,
+    // the rest goes directly to the encrypted data, so every byte is copied once.
+    auto input = encryptedData.cbegin();
+    const auto inputEnd = encryptedData.cend();
+    const auto takeInput = [&](size_t expectedSize) {
+        if (impl_->contentInfoData.size() >= expectedSize) {
+            return;
+        }
+        const size_t takeSize = std::min(expectedSize - impl_->contentInfoData.size(),
+                static_cast<size_t>(inputEnd - input));
+        impl_->contentInfoData.insert(impl_->contentInfoData.end(), input, input + takeSize);
+        input += takeSize;
+    };
+
+    // Define content info size first time.
     if (impl_->expectedContentInfoSize == 0) {
+        // Check preamble size.
+        takeInput(kContentInfoPreambleSize);
+        if (impl_->contentInfoData.size() < kContentInfoPreambleSize) {
+            return;
+        }
+
         impl_->expectedContentInfoSize = VirgilContentInfo::defineSize(impl_->contentInfoData);
-    }
 
-    // If content info size still zero, then it is not a content info.
-    if (impl_->expectedContentInfoSize == 0) {
-        impl_->encryptedData.swap(impl_->contentInfoData);
-        impl_->state = State::NotFound;
-        return;
+        // If content info size still zero, then it is not a content info.
+        if (impl_->expectedContentInfoSize == 0) {
+            impl_->encryptedData.swap(impl_->contentInfoData);
+            impl_->encryptedData.insert(impl_->encryptedData.end(), input, inputEnd);
+            impl_->state = State::NotFound;
+            return;
+        }
+
+        impl_->contentInfoData.reserve(impl_->expectedContentInfoSize);
     }
 
     // Check if content info fully extracted.
+    takeInput(impl_->expectedContentInfoSize);
     if (impl_->contentInfoData.size() >= impl_->expectedContentInfoSize) {
-        size_t contentInfoDataSize = impl_->contentInfoData.size();
-        size_t encryptedDataSize = impl_->encryptedData.size();
-
         impl_->encryptedData.insert(impl_->encryptedData.end(),
                 impl_->contentInfoData.begin() + impl_->expectedContentInfoSize, impl_->contentInfoData.end());
         impl_->contentInfoData.resize(impl_->expectedContentInfoSize);
+        impl_->encryptedData.insert(impl_->encryptedData.end(), input, inputEnd);
         impl_->state = State::Found;
-
-        encryptedDataSize = impl_->encryptedData.size();
-        contentInfoDataSize = impl_->contentInfoData.size();
         return;
     }
 
@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_INTERNAL_CONTENT_INFO_UTILS_H
+#define VIRGIL_CRYPTO_INTERNAL_CONTENT_INFO_UTILS_H
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilContentInfo.h>
+#include <virgil/crypto/foundation/VirgilPBE.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+
+#include <functional>
+#include <mutex>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Shared steps of the content info creation for the ciphers.
+ */
+class VirgilContentInfoUtils {
+public:
+    /**
+     * @name Configuration constants.
+     */
+    ///@{
+    static constexpr foundation::VirgilSymmetricCipher::Algorithm
+            kSymmetricCipher_Algorithm = foundation::VirgilSymmetricCipher::Algorithm::AES_256_GCM;
+    static constexpr size_t kPBE_SaltSize = 16;
+    static constexpr size_t kPBE_IterationCountMin = 3072;
+    static constexpr size_t kPBE_IterationCountMax = 8192;
+    ///@}
+
+    /**
+     * @brief Create password based encryption with random salt and iteration count for the password recipient.
+     */
+    static foundation::VirgilPBE makePasswordRecipientPBE(foundation::VirgilRandom& random) {
+        const VirgilByteArray salt = random.randomize(kPBE_SaltSize);
+        const size_t iterationCount = random.randomize(kPBE_IterationCountMin, kPBE_IterationCountMax);
+        return foundation::VirgilPBE(foundation::VirgilPBE::Algorithm::PKCS5, salt, iterationCount);
+    }
+
+    /**
+     * @brief Result of the content encryption key encryption for the recipient.
+     */
+    using EncryptionResult = VirgilContentInfo::EncryptionResult;
+
+    /**
+     * @brief Encrypt content encryption key for all recipients of the content info,
+     *     and set content encryption algorithm.
+     *
+     * @param contentInfo - content info with added recipients.
+     * @param symmetricCipher - configured content encryption cipher.
+     * @param contentEncryptionKey - key to be encrypted for the recipients.
+     * @param encryptForKeyRecipient - encryption function for the key recipient,
+     *     it MUST be thread-safe if threadsNum is greater than 1.
+     * @param random - random used for password recipients, access to it is synchronized.
+     * @param threadsNum - maximum number of threads used to encrypt key for the recipients.
+     */
+    static void encryptRecipients(
+            VirgilContentInfo& contentInfo, const foundation::VirgilSymmetricCipher& symmetricCipher,
+            const VirgilByteArray& contentEncryptionKey,
+            const std::function<EncryptionResult(const VirgilByteArray& publicKey)>& encryptForKeyRecipient,
+            foundation::VirgilRandom& random, size_t threadsNum) {
+
+        contentInfo.encryptKeyRecipients(encryptForKeyRecipient, threadsNum);
+
+        std::mutex randomMutex;
+        contentInfo.encryptPasswordRecipients(
+                [&contentEncryptionKey, &random, &randomMutex](const VirgilByteArray& password) -> EncryptionResult {
+                    std::unique_lock<std::mutex> lock(randomMutex);
+                    foundation::VirgilPBE pbe = makePasswordRecipientPBE(random);
+                    lock.unlock();
+
+                    return { pbe.toAsn1(), pbe.encrypt(contentEncryptionKey, password) };
+                },
+                threadsNum
+        );
+
+        contentInfo.setContentEncryptionAlgorithm(symmetricCipher.toAsn1());
+    }
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_INTERNAL_CONTENT_INFO_UTILS_H */
@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_INTERNAL_CONTEXT_POOL_H
+#define VIRGIL_CRYPTO_INTERNAL_CONTEXT_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Thread-safe pool of the contexts that are not reentrant.
+ *
+ * Every concurrent operation takes its own context from the pool,
+ * new context is created on demand when the pool is empty.
+ *
+ * @tparam T - context type.
+ */
+template<typename T>
+class VirgilContextPool {
+public:
+    //! Default number of the idle contexts that are kept by the pool.
+    static constexpr size_t kCapacity_Default = 16;
+
+    /**
+     * @brief Create empty pool.
+     * @param factory - function that creates new context, it MUST be thread-safe.
+     * @param capacity - maximum number of the idle contexts kept by the pool, extra contexts are destroyed.
+     */
+    explicit VirgilContextPool(std::function<std::unique_ptr<T>()> factory, size_t capacity = kCapacity_Default)
+            : factory_(std::move(factory)), capacity_(capacity), contexts_(), mutex_() {}
+
+    /**
+     * @brief Take context from the pool, or create new one if the pool is empty.
+     */
+    std::unique_ptr<T> acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!contexts_.empty()) {
+                auto context = std::move(contexts_.back());
+                contexts_.pop_back();
+                return context;
+            }
+        }
+        return factory_();
+    }
+
+    /**
+     * @brief Return context to the pool, context is destroyed if the pool is full.
+     */
+    void release(std::unique_ptr<T> context) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (contexts_.size() < capacity_) {
+                contexts_.push_back(std::move(context));
+                return;
+            }
+        }
+        // Destroyed outside of the lock.
+        context.reset();
+    }
+
+    /**
+     * @brief Perform given operation with the context from the pool.
+     *
+     * Context is returned to the pool only on success, because failed operation may leave it in undefined state.
+     */
+    template<typename Operation>
+    auto perform(Operation&& operation) -> decltype(operation(std::declval<T&>())) {
+        auto context = acquire();
+        auto result = operation(*context);
+        release(std::move(context));
+        return result;
+    }
+
+private:
+    std::function<std::unique_ptr<T>()> factory_;
+    const size_t capacity_;
+    std::vector<std::unique_ptr<T>> contexts_;
+    std::mutex mutex_;
+};
+
+template<typename T>
+constexpr size_t VirgilContextPool<T>::kCapacity_Default;
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_INTERNAL_CONTEXT_POOL_H */
@@ -0,0 +1,168 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilCpuFeatures.h"
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using virgil::crypto::foundation::internal::VirgilCpuFeatures;
+
+namespace {
+
+struct cpu_features {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool aesNi = false;
+    bool shaNi = false;
+    bool avx2 = false;
+    bool avx512 = false;
+};
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = { 0 };
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (size_t i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+unsigned long long xgetbv() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0, edx = 0;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+cpu_features detect_cpu_features() noexcept {
+    constexpr unsigned kEdx1_Sse2 = 1u << 26;
+    constexpr unsigned kEcx1_Pclmulqdq = 1u << 1;
+    constexpr unsigned kEcx1_Ssse3 = 1u << 9;
+    constexpr unsigned kEcx1_Sse41 = 1u << 19;
+    constexpr unsigned kEcx1_AesNi = 1u << 25;
+    constexpr unsigned kEcx1_OsXsave = 1u << 27;
+    constexpr unsigned kEcx1_Avx = 1u << 28;
+    constexpr unsigned kEbx7_Avx2 = 1u << 5;
+    constexpr unsigned kEbx7_Avx512F = 1u << 16;
+    constexpr unsigned kEbx7_ShaNi = 1u << 29;
+    constexpr unsigned kEbx7_Avx512BW = 1u << 30;
+    constexpr unsigned long long kXcr0_Ymm = 0x06;
+    constexpr unsigned long long kXcr0_Zmm = 0xe0;
+
+    cpu_features features;
+    unsigned regs[4] = { 0 };
+    cpuid(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return features;
+    }
+    cpuid(1, 0, regs);
+    const unsigned ecx1 = regs[2];
+    const unsigned edx1 = regs[3];
+    unsigned ebx7 = 0;
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        ebx7 = regs[1];
+    }
+    unsigned long long xcr0 = 0;
+    if (ecx1 & kEcx1_OsXsave) {
+        xcr0 = xgetbv();
+    }
+    const bool hasYmm = (ecx1 & kEcx1_Avx) && (xcr0 & kXcr0_Ymm) == kXcr0_Ymm;
+    const bool hasZmm = hasYmm && (xcr0 & kXcr0_Zmm) == kXcr0_Zmm;
+
+    features.sse2 = (edx1 & kEdx1_Sse2) != 0;
+    features.ssse3 = (ecx1 & kEcx1_Ssse3) != 0;
+    features.aesNi = (ecx1 & (kEcx1_AesNi | kEcx1_Pclmulqdq | kEcx1_Ssse3)) ==
+            (kEcx1_AesNi | kEcx1_Pclmulqdq | kEcx1_Ssse3);
+    features.shaNi = (ebx7 & kEbx7_ShaNi) && (ecx1 & (kEcx1_Sse41 | kEcx1_Ssse3)) == (kEcx1_Sse41 | kEcx1_Ssse3);
+    features.avx2 = hasYmm && (ebx7 & kEbx7_Avx2);
+    features.avx512 = hasZmm && (ebx7 & (kEbx7_Avx512F | kEbx7_Avx512BW)) == (kEbx7_Avx512F | kEbx7_Avx512BW);
+    return features;
+}
+
+#else
+
+cpu_features detect_cpu_features() noexcept {
+    return cpu_features();
+}
+
+#endif /* VIRGIL_CRYPTO_X86_ENABLED */
+
+const cpu_features& get_cpu_features() noexcept {
+    static const cpu_features features = detect_cpu_features();
+    return features;
+}
+
+}
+
+bool VirgilCpuFeatures::hasSse2() noexcept {
+    return get_cpu_features().sse2;
+}
+
+bool VirgilCpuFeatures::hasSsse3() noexcept {
+    return get_cpu_features().ssse3;
+}
+
+bool VirgilCpuFeatures::hasAesNi() noexcept {
+    return get_cpu_features().aesNi;
+}
+
+bool VirgilCpuFeatures::hasShaNi() noexcept {
+    return get_cpu_features().shaNi;
+}
+
+bool VirgilCpuFeatures::hasAvx2() noexcept {
+    return get_cpu_features().avx2;
+}
+
+bool VirgilCpuFeatures::hasAvx512() noexcept {
+    return get_cpu_features().avx512;
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_CPU_FEATURES_H
+#define VIRGIL_CRYPTO_CPU_FEATURES_H
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VIRGIL_CRYPTO_X86_ENABLED 1
+#define VIRGIL_CRYPTO_X86_TARGET(features) __attribute__((target(features)))
+#elif defined(_M_X64) || defined(_M_IX86)
+#define VIRGIL_CRYPTO_X86_ENABLED 1
+#define VIRGIL_CRYPTO_X86_TARGET(features)
+#else
+#define VIRGIL_CRYPTO_X86_ENABLED 0
+#endif
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Runtime detection of the x86 instruction set extensions used by the accelerated primitives.
+ *
+ * Extensions that use extended registers are reported only if OS saves them on context switch.
+ * Features are detected once, all methods return false on other architectures.
+ */
+class VirgilCpuFeatures {
+public:
+    static bool hasSse2() noexcept;
+
+    static bool hasSsse3() noexcept;
+
+    //! AES-NI, PCLMULQDQ and SSSE3.
+    static bool hasAesNi() noexcept;
+
+    //! SHA extensions, SSE4.1 and SSSE3.
+    static bool hasShaNi() noexcept;
+
+    static bool hasAvx2() noexcept;
+
+    //! AVX-512 Foundation and Byte and Word instructions.
+    static bool hasAvx512() noexcept;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_CPU_FEATURES_H */
@@ -0,0 +1,843 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilEd25519BatchVerifier.h"
+
+#include <virgil/crypto/foundation/VirgilHash.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::internal::VirgilEd25519BatchVerifier;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilRandom;
+
+constexpr size_t VirgilEd25519BatchVerifier::kPublicKeySize;
+constexpr size_t VirgilEd25519BatchVerifier::kSignatureSize;
+
+/**
+ * @name Configuration constants
+ */
+///@{
+static constexpr size_t kRandomScalarSize = 16;
+static constexpr size_t kScalarBits = 253;
+static constexpr char kRandomPersonalInfo[] = "virgil_ed25519_batch_verifier";
+///@}
+
+namespace virgil { namespace crypto { namespace internal {
+
+//
+// Field arithmetic modulo p = 2^255 - 19, element is represented by five 51-bit limbs.
+//
+static constexpr uint64_t kMask51 = (uint64_t(1) << 51) - 1;
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 uint128;
+
+static inline uint128 mul64(uint64_t a, uint64_t b) {
+    return static_cast<uint128>(a) * b;
+}
+
+static inline uint128 add128(uint128 a, uint128 b) {
+    return a + b;
+}
+
+static inline uint128 add128(uint128 a, uint64_t b) {
+    return a + b;
+}
+
+static inline uint64_t lo51(uint128 a) {
+    return static_cast<uint64_t>(a) & kMask51;
+}
+
+static inline uint64_t shr51(uint128 a) {
+    return static_cast<uint64_t>(a >> 51);
+}
+#else
+struct uint128 {
+    uint64_t lo;
+    uint64_t hi;
+};
+
+static inline uint128 mul64(uint64_t a, uint64_t b) {
+    const uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+    const uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+    const uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    return uint128{(mid << 32) | (ll & 0xFFFFFFFF), hh + (lh >> 32) + (hl >> 32) + (mid >> 32)};
+}
+
+static inline uint128 add128(uint128 a, uint128 b) {
+    const uint64_t lo = a.lo + b.lo;
+    return uint128{lo, a.hi + b.hi + (lo < a.lo)};
+}
+
+static inline uint128 add128(uint128 a, uint64_t b) {
+    const uint64_t lo = a.lo + b;
+    return uint128{lo, a.hi + (lo < a.lo)};
+}
+
+static inline uint64_t lo51(uint128 a) {
+    return a.lo & kMask51;
+}
+
+static inline uint64_t shr51(uint128 a) {
+    return (a.lo >> 51) | (a.hi << 13);
+}
+#endif
+
+struct fe {
+    uint64_t v[5];
+};
+
+static constexpr fe kFe_Zero = {{0, 0, 0, 0, 0}};
+static constexpr fe kFe_One = {{1, 0, 0, 0, 0}};
+static constexpr fe kFe_D = {{
+        0x34dca135978a3ULL, 0x1a8283b156ebdULL, 0x5e7a26001c029ULL, 0x739c663a03cbbULL, 0x52036cee2b6ffULL}};
+static constexpr fe kFe_D2 = {{
+        0x69b9426b2f159ULL, 0x35050762add7aULL, 0x3cf44c0038052ULL, 0x6738cc7407977ULL, 0x2406d9dc56dffULL}};
+static constexpr fe kFe_SqrtM1 = {{
+        0x61b274a0ea0b0ULL, 0x0d5a5fc8f189dULL, 0x7ef5e9cbd0c60ULL, 0x78595a6804c9eULL, 0x2b8324804fc1dULL}};
+
+static inline void fe_carry(fe& h) {
+    uint64_t c;
+    c = h.v[0] >> 51; h.v[0] &= kMask51; h.v[1] += c;
+    c = h.v[1] >> 51; h.v[1] &= kMask51; h.v[2] += c;
+    c = h.v[2] >> 51; h.v[2] &= kMask51; h.v[3] += c;
+    c = h.v[3] >> 51; h.v[3] &= kMask51; h.v[4] += c;
+    c = h.v[4] >> 51; h.v[4] &= kMask51; h.v[0] += c * 19;
+}
+
+static inline void fe_add(fe& h, const fe& f, const fe& g) {
+    for (size_t i = 0; i < 5; ++i) {
+        h.v[i] = f.v[i] + g.v[i];
+    }
+    fe_carry(h);
+}
+
+static inline void fe_sub(fe& h, const fe& f, const fe& g) {
+    // Add 4 * p to keep limbs positive
+    h.v[0] = (f.v[0] + 0x1FFFFFFFFFFFB4ULL) - g.v[0];
+    for (size_t i = 1; i < 5; ++i) {
+        h.v[i] = (f.v[i] + 0x1FFFFFFFFFFFFCULL) - g.v[i];
+    }
+    fe_carry(h);
+}
+
+static inline void fe_neg(fe& h, const fe& f) {
+    fe_sub(h, kFe_Zero, f);
+}
+
+static inline void fe_mul(fe& h, const fe& f, const fe& g) {
+    const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    const uint64_t g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+    const uint64_t g1_19 = g1 * 19, g2_19 = g2 * 19, g3_19 = g3 * 19, g4_19 = g4 * 19;
+
+    uint128 r0 = add128(add128(mul64(f0, g0), mul64(f1, g4_19)),
+            add128(add128(mul64(f2, g3_19), mul64(f3, g2_19)), mul64(f4, g1_19)));
+    uint128 r1 = add128(add128(mul64(f0, g1), mul64(f1, g0)),
+            add128(add128(mul64(f2, g4_19), mul64(f3, g3_19)), mul64(f4, g2_19)));
+    uint128 r2 = add128(add128(mul64(f0, g2), mul64(f1, g1)),
+            add128(add128(mul64(f2, g0), mul64(f3, g4_19)), mul64(f4, g3_19)));
+    uint128 r3 = add128(add128(mul64(f0, g3), mul64(f1, g2)),
+            add128(add128(mul64(f2, g1), mul64(f3, g0)), mul64(f4, g4_19)));
+    uint128 r4 = add128(add128(mul64(f0, g4), mul64(f1, g3)),
+            add128(add128(mul64(f2, g2), mul64(f3, g1)), mul64(f4, g0)));
+
+    r1 = add128(r1, shr51(r0));
+    r2 = add128(r2, shr51(r1));
+    r3 = add128(r3, shr51(r2));
+    r4 = add128(r4, shr51(r3));
+    h.v[0] = lo51(r0) + shr51(r4) * 19;
+    h.v[1] = lo51(r1);
+    h.v[2] = lo51(r2);
+    h.v[3] = lo51(r3);
+    h.v[4] = lo51(r4);
+    h.v[1] += h.v[0] >> 51;
+    h.v[0] &= kMask51;
+}
+
+static inline void fe_sq(fe& h, const fe& f) {
+    fe_mul(h, f, f);
+}
+
+static void fe_sq_times(fe& h, const fe& f, size_t n) {
+    fe_sq(h, f);
+    for (size_t i = 1; i < n; ++i) {
+        fe_sq(h, h);
+    }
+}
+
+static inline uint64_t load_le64(const unsigned char* s) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        result |= static_cast<uint64_t>(s[i]) << (8 * i);
+    }
+    return result;
+}
+
+/**
+ * @brief Load field element ignoring the most significant bit.
+ */
+static void fe_from_bytes(fe& h, const unsigned char s[32]) {
+    h.v[0] = load_le64(s) & kMask51;
+    h.v[1] = (load_le64(s + 6) >> 3) & kMask51;
+    h.v[2] = (load_le64(s + 12) >> 6) & kMask51;
+    h.v[3] = (load_le64(s + 19) >> 1) & kMask51;
+    h.v[4] = (load_le64(s + 24) >> 12) & kMask51;
+}
+
+static void fe_to_bytes(unsigned char s[32], const fe& f) {
+    fe t = f;
+    fe_carry(t);
+    fe_carry(t);
+    // Now t is in [0, 2^255 - 1], make it fully reduced
+    t.v[0] += 19;
+    fe_carry(t);
+    t.v[0] += (uint64_t(1) << 51) - 19;
+    for (size_t i = 1; i < 5; ++i) {
+        t.v[i] += (uint64_t(1) << 51) - 1;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        t.v[i + 1] += t.v[i] >> 51;
+        t.v[i] &= kMask51;
+    }
+    t.v[4] &= kMask51;
+
+    const uint64_t w0 = t.v[0] | (t.v[1] << 51);
+    const uint64_t w1 = (t.v[1] >> 13) | (t.v[2] << 38);
+    const uint64_t w2 = (t.v[2] >> 26) | (t.v[3] << 25);
+    const uint64_t w3 = (t.v[3] >> 39) | (t.v[4] << 12);
+    const uint64_t words[4] = {w0, w1, w2, w3};
+    for (size_t i = 0; i < 32; ++i) {
+        s[i] = static_cast<unsigned char>(words[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+static bool fe_is_zero(const fe& f) {
+    unsigned char s[32];
+    fe_to_bytes(s, f);
+    unsigned char acc = 0;
+    for (size_t i = 0; i < 32; ++i) {
+        acc |= s[i];
+    }
+    return acc == 0;
+}
+
+static bool fe_is_negative(const fe& f) {
+    unsigned char s[32];
+    fe_to_bytes(s, f);
+    return (s[0] & 1) != 0;
+}
+
+/**
+ * @brief Return z^((p - 5) / 8) = z^(2^252 - 3).
+ */
+static void fe_pow22523(fe& out, const fe& z) {
+    fe t0, t1, t2;
+    fe_sq(t0, z);
+    fe_sq_times(t1, t0, 2);
+    fe_mul(t1, z, t1);
+    fe_mul(t0, t0, t1);
+    fe_sq(t0, t0);
+    fe_mul(t0, t1, t0);
+    fe_sq_times(t1, t0, 5);
+    fe_mul(t0, t1, t0);
+    fe_sq_times(t1, t0, 10);
+    fe_mul(t1, t1, t0);
+    fe_sq_times(t2, t1, 20);
+    fe_mul(t1, t2, t1);
+    fe_sq_times(t1, t1, 10);
+    fe_mul(t0, t1, t0);
+    fe_sq_times(t1, t0, 50);
+    fe_mul(t1, t1, t0);
+    fe_sq_times(t2, t1, 100);
+    fe_mul(t1, t2, t1);
+    fe_sq_times(t1, t1, 50);
+    fe_mul(t0, t1, t0);
+    fe_sq_times(t0, t0, 2);
+    fe_mul(out, t0, z);
+}
+
+//
+// Group arithmetic of the twisted Edwards curve -x^2 + y^2 = 1 + d * x^2 * y^2 in extended coordinates.
+//
+struct ge_p3 {
+    fe X, Y, Z, T;
+};
+
+struct ge_cached {
+    fe YplusX, YminusX, Z2, T2d;
+};
+
+static constexpr ge_p3 kGe_Identity = {{{0, 0, 0, 0, 0}}, {{1, 0, 0, 0, 0}}, {{1, 0, 0, 0, 0}}, {{0, 0, 0, 0, 0}}};
+static constexpr ge_p3 kGe_Base = {
+        {{0x62d608f25d51aULL, 0x412a4b4f6592aULL, 0x75b7171a4b31dULL, 0x1ff60527118feULL, 0x216936d3cd6e5ULL}},
+        {{0x6666666666658ULL, 0x4ccccccccccccULL, 0x1999999999999ULL, 0x3333333333333ULL, 0x6666666666666ULL}},
+        {{1, 0, 0, 0, 0}},
+        {{0x68ab3a5b7dda3ULL, 0x00eea2a5eadbbULL, 0x2af8df483c27eULL, 0x332b375274732ULL, 0x67875f0fd78b7ULL}}};
+
+static void ge_to_cached(ge_cached& r, const ge_p3& p) {
+    fe_add(r.YplusX, p.Y, p.X);
+    fe_sub(r.YminusX, p.Y, p.X);
+    fe_add(r.Z2, p.Z, p.Z);
+    fe_mul(r.T2d, p.T, kFe_D2);
+}
+
+static void ge_neg(ge_p3& r, const ge_p3& p) {
+    fe_neg(r.X, p.X);
+    r.Y = p.Y;
+    r.Z = p.Z;
+    fe_neg(r.T, p.T);
+}
+
+static void ge_neg(ge_cached& r, const ge_cached& p) {
+    r.YplusX = p.YminusX;
+    r.YminusX = p.YplusX;
+    r.Z2 = p.Z2;
+    fe_neg(r.T2d, p.T2d);
+}
+
+static void ge_add(ge_p3& r, const ge_p3& p, const ge_cached& q) {
+    fe a, b, c, d, e, f, g, h;
+    fe_sub(a, p.Y, p.X);
+    fe_mul(a, a, q.YminusX);
+    fe_add(b, p.Y, p.X);
+    fe_mul(b, b, q.YplusX);
+    fe_mul(c, p.T, q.T2d);
+    fe_mul(d, p.Z, q.Z2);
+    fe_sub(e, b, a);
+    fe_sub(f, d, c);
+    fe_add(g, d, c);
+    fe_add(h, b, a);
+    fe_mul(r.X, e, f);
+    fe_mul(r.Y, g, h);
+    fe_mul(r.T, e, h);
+    fe_mul(r.Z, f, g);
+}
+
+static void ge_dbl(ge_p3& r, const ge_p3& p) {
+    fe a, b, c, e, f, g, h;
+    fe_sq(a, p.X);
+    fe_sq(b, p.Y);
+    fe_sq(c, p.Z);
+    fe_add(c, c, c);
+    fe_add(e, p.X, p.Y);
+    fe_sq(e, e);
+    fe_add(h, a, b);
+    fe_sub(e, e, h);
+    fe_sub(g, b, a);
+    fe_sub(f, g, c);
+    fe_neg(h, h);
+    fe_mul(r.X, e, f);
+    fe_mul(r.Y, g, h);
+    fe_mul(r.T, e, h);
+    fe_mul(r.Z, f, g);
+}
+
+static bool ge_is_identity(const ge_p3& p) {
+    fe t;
+    fe_sub(t, p.Y, p.Z);
+    return fe_is_zero(p.X) && fe_is_zero(t);
+}
+
+/**
+ * @brief Check that encoded y-coordinate is less than p and x-coordinate sign is set only for non zero x.
+ */
+static bool ge_is_canonical(const unsigned char s[32]) {
+    if ((s[31] & 0x7F) == 0x7F && s[0] >= 0xED) {
+        bool allOnes = true;
+        for (size_t i = 1; i < 31; ++i) {
+            allOnes &= (s[i] == 0xFF);
+        }
+        if (allOnes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Decode point and negate it.
+ * @return false if encoding is invalid or non canonical.
+ */
+static bool ge_from_bytes_negate(ge_p3& h, const unsigned char s[32]) {
+    if (!ge_is_canonical(s)) {
+        return false;
+    }
+    fe u, v, v3, vxx, check;
+    fe_from_bytes(h.Y, s);
+    h.Z = kFe_One;
+    fe_sq(u, h.Y);
+    fe_mul(v, u, kFe_D);
+    fe_sub(u, u, h.Z);       // u = y^2 - 1
+    fe_add(v, v, h.Z);       // v = d * y^2 + 1
+
+    fe_sq(v3, v);
+    fe_mul(v3, v3, v);       // v3 = v^3
+    fe_sq(h.X, v3);
+    fe_mul(h.X, h.X, v);
+    fe_mul(h.X, h.X, u);     // x = u * v^7
+
+    fe_pow22523(h.X, h.X);   // x = (u * v^7)^((p - 5) / 8)
+    fe_mul(h.X, h.X, v3);
+    fe_mul(h.X, h.X, u);     // x = u * v^3 * (u * v^7)^((p - 5) / 8)
+
+    fe_sq(vxx, h.X);
+    fe_mul(vxx, vxx, v);
+    fe_sub(check, vxx, u);
+    if (!fe_is_zero(check)) {
+        fe_add(check, vxx, u);
+        if (!fe_is_zero(check)) {
+            return false;
+        }
+        fe_mul(h.X, h.X, kFe_SqrtM1);
+    }
+
+    const bool sign = (s[31] >> 7) != 0;
+    if (sign && fe_is_zero(h.X)) {
+        return false;
+    }
+    if (fe_is_negative(h.X) == sign) {
+        fe_neg(h.X, h.X);
+    }
+    fe_mul(h.T, h.X, h.Y);
+    return true;
+}
+
+//
+// Scalar arithmetic modulo group order L = 2^252 + 27742317777372353535851937790883648493.
+//
+typedef std::array<uint32_t, 8> sc;
+
+static constexpr uint32_t kSc_L[8] = {
+        0x5cf5d3edU, 0x5812631aU, 0xa2f79cd6U, 0x14def9deU, 0x00000000U, 0x00000000U, 0x00000000U, 0x10000000U};
+
+// mu = floor(2^512 / L), used by Barrett reduction
+static constexpr uint32_t kSc_Mu[9] = {
+        0x0a2c131bU, 0xed9ce5a3U, 0x086329a7U, 0x2106215dU, 0xffffffebU, 0xffffffffU, 0xffffffffU, 0xffffffffU,
+        0x0000000fU};
+
+static bool sc_less_than_l(const uint32_t* a, size_t len) {
+    for (size_t i = len; i > 8; --i) {
+        if (a[i - 1] != 0) {
+            return false;
+        }
+    }
+    for (size_t i = 8; i > 0; --i) {
+        if (a[i - 1] != kSc_L[i - 1]) {
+            return a[i - 1] < kSc_L[i - 1];
+        }
+    }
+    return false;
+}
+
+static void sc_sub_l(uint32_t* a, size_t len) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const int64_t diff = static_cast<int64_t>(a[i]) - (i < 8 ? kSc_L[i] : 0) + borrow;
+        a[i] = static_cast<uint32_t>(diff);
+        borrow = diff < 0 ? -1 : 0;
+    }
+}
+
+static void sc_from_bytes(sc& r, const unsigned char s[32]) {
+    for (size_t i = 0; i < 8; ++i) {
+        r[i] = static_cast<uint32_t>(s[4 * i]) | (static_cast<uint32_t>(s[4 * i + 1]) << 8) |
+               (static_cast<uint32_t>(s[4 * i + 2]) << 16) | (static_cast<uint32_t>(s[4 * i + 3]) << 24);
+    }
+}
+
+static bool sc_is_canonical(const unsigned char s[32]) {
+    sc a;
+    sc_from_bytes(a, s);
+    return sc_less_than_l(a.data(), a.size());
+}
+
+/**
+ * @brief Barrett reduction of the 512-bit value.
+ */
+static void sc_reduce(sc& r, const uint32_t x[16]) {
+    // q = ((x >> 224) * mu) >> 288
+    uint32_t q2[18] = {0};
+    for (size_t i = 0; i < 9; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 9; ++j) {
+            const uint64_t t = static_cast<uint64_t>(x[7 + i]) * kSc_Mu[j] + q2[i + j] + carry;
+            q2[i + j] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        q2[i + 9] = static_cast<uint32_t>(carry);
+    }
+    const uint32_t* q3 = q2 + 9;
+
+    // r = (x - q * L) mod 2^288
+    uint32_t qL[9] = {0};
+    for (size_t i = 0; i < 9; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; i + j < 9 && j < 8; ++j) {
+            const uint64_t t = static_cast<uint64_t>(q3[i]) * kSc_L[j] + qL[i + j] + carry;
+            qL[i + j] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (i + 8 < 9) {
+            qL[i + 8] += static_cast<uint32_t>(carry);
+        }
+    }
+    uint32_t rem[9];
+    int64_t borrow = 0;
+    for (size_t i = 0; i < 9; ++i) {
+        const int64_t diff = static_cast<int64_t>(x[i]) - qL[i] + borrow;
+        rem[i] = static_cast<uint32_t>(diff);
+        borrow = diff < 0 ? -1 : 0;
+    }
+    while (!sc_less_than_l(rem, 9)) {
+        sc_sub_l(rem, 9);
+    }
+    std::copy(rem, rem + 8, r.begin());
+}
+
+static void sc_reduce_bytes(sc& r, const unsigned char s[64]) {
+    uint32_t x[16];
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] = static_cast<uint32_t>(s[4 * i]) | (static_cast<uint32_t>(s[4 * i + 1]) << 8) |
+               (static_cast<uint32_t>(s[4 * i + 2]) << 16) | (static_cast<uint32_t>(s[4 * i + 3]) << 24);
+    }
+    sc_reduce(r, x);
+}
+
+static void sc_mul(sc& r, const sc& a, const sc& b) {
+    uint32_t x[16] = {0};
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            const uint64_t t = static_cast<uint64_t>(a[i]) * b[j] + x[i + j] + carry;
+            x[i + j] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        x[i + 8] = static_cast<uint32_t>(carry);
+    }
+    sc_reduce(r, x);
+}
+
+static void sc_add(sc& r, const sc& a, const sc& b) {
+    uint32_t x[9];
+    uint64_t carry = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        const uint64_t t = static_cast<uint64_t>(a[i]) + b[i] + carry;
+        x[i] = static_cast<uint32_t>(t);
+        carry = t >> 32;
+    }
+    x[8] = static_cast<uint32_t>(carry);
+    if (!sc_less_than_l(x, 9)) {
+        sc_sub_l(x, 9);
+    }
+    std::copy(x, x + 8, r.begin());
+}
+
+/**
+ * @brief Return window of the given width starting from the given bit.
+ */
+static uint32_t sc_window(const sc& a, size_t bit, size_t width) {
+    const size_t limb = bit / 32;
+    const size_t shift = bit % 32;
+    if (limb >= 8) {
+        return 0;
+    }
+    uint64_t value = a[limb];
+    if (limb + 1 < 8) {
+        value |= static_cast<uint64_t>(a[limb + 1]) << 32;
+    }
+    return static_cast<uint32_t>((value >> shift) & ((uint64_t(1) << width) - 1));
+}
+
+//
+// Multi-scalar multiplication.
+//
+
+/**
+ * @brief Choose window width of the bucket method for the given number of points.
+ */
+static size_t msm_window_width(size_t pointsNum) {
+    size_t bestWidth = 1;
+    size_t bestCost = static_cast<size_t>(-1);
+    for (size_t width = 1; width <= 16; ++width) {
+        const size_t windowsNum = (kScalarBits + 1 + width - 1) / width;
+        const size_t cost = windowsNum * (pointsNum + (size_t(1) << width));
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestWidth = width;
+        }
+    }
+    return bestWidth;
+}
+
+/**
+ * @brief Calculate sum(scalars[i] * points[i]) with the bucket method (Pippenger) and signed digits.
+ */
+static void ge_multi_scalar_mul(ge_p3& result, const std::vector<ge_p3>& points, const std::vector<sc>& scalars) {
+    const size_t pointsNum = points.size();
+    const size_t width = msm_window_width(pointsNum);
+    const size_t windowsNum = (kScalarBits + 1 + width - 1) / width;
+    const int32_t half = int32_t(1) << (width - 1);
+
+    // Recode scalars to the signed digits in [-2^(w-1), 2^(w-1)].
+    // Scalars are reduced (< 2^253), so windows cover at least one zero bit on top,
+    // and the top digit absorbs the last carry without leaving the range.
+    std::vector<int32_t> digits(pointsNum * windowsNum);
+    for (size_t i = 0; i < pointsNum; ++i) {
+        int32_t carry = 0;
+        for (size_t w = 0; w + 1 < windowsNum; ++w) {
+            int32_t digit = static_cast<int32_t>(sc_window(scalars[i], w * width, width)) + carry;
+            carry = (digit + half) >> width;
+            digit -= carry << width;
+            digits[i * windowsNum + w] = digit;
+        }
+        const int32_t topDigit =
+                static_cast<int32_t>(sc_window(scalars[i], (windowsNum - 1) * width, width)) + carry;
+        assert(topDigit <= half);
+        digits[i * windowsNum + windowsNum - 1] = topDigit;
+    }
+
+    std::vector<ge_cached> cached(pointsNum);
+    for (size_t i = 0; i < pointsNum; ++i) {
+        ge_to_cached(cached[i], points[i]);
+    }
+
+    std::vector<ge_p3> buckets(static_cast<size_t>(half));
+    std::vector<bool> bucketUsed(static_cast<size_t>(half));
+    bool resultUsed = false;
+    result = kGe_Identity;
+    for (size_t w = windowsNum; w > 0; --w) {
+        if (resultUsed) {
+            for (size_t i = 0; i < width; ++i) {
+                ge_dbl(result, result);
+            }
+        }
+
+        std::fill(bucketUsed.begin(), bucketUsed.end(), false);
+        for (size_t i = 0; i < pointsNum; ++i) {
+            const int32_t digit = digits[i * windowsNum + w - 1];
+            if (digit == 0) {
+                continue;
+            }
+            const size_t index = static_cast<size_t>(digit > 0 ? digit : -digit) - 1;
+            if (!bucketUsed[index]) {
+                if (digit > 0) {
+                    buckets[index] = points[i];
+                } else {
+                    ge_neg(buckets[index], points[i]);
+                }
+                bucketUsed[index] = true;
+            } else if (digit > 0) {
+                ge_add(buckets[index], buckets[index], cached[i]);
+            } else {
+                ge_cached negated;
+                ge_neg(negated, cached[i]);
+                ge_add(buckets[index], buckets[index], negated);
+            }
+        }
+
+        // sum(j * bucket[j]) = sum of the running sums
+        ge_p3 running = kGe_Identity, total = kGe_Identity;
+        bool runningUsed = false, totalUsed = false;
+        ge_cached tmp;
+        for (size_t j = buckets.size(); j > 0; --j) {
+            if (bucketUsed[j - 1]) {
+                if (runningUsed) {
+                    ge_to_cached(tmp, buckets[j - 1]);
+                    ge_add(running, running, tmp);
+                } else {
+                    running = buckets[j - 1];
+                    runningUsed = true;
+                }
+            }
+            if (runningUsed) {
+                if (totalUsed) {
+                    ge_to_cached(tmp, running);
+                    ge_add(total, total, tmp);
+                } else {
+                    total = running;
+                    totalUsed = true;
+                }
+            }
+        }
+
+        if (totalUsed) {
+            if (resultUsed) {
+                ge_to_cached(tmp, total);
+                ge_add(result, result, tmp);
+            } else {
+                result = total;
+                resultUsed = true;
+            }
+        }
+    }
+}
+
+}}}
+
+using virgil::crypto::internal::fe;
+using virgil::crypto::internal::ge_p3;
+using virgil::crypto::internal::sc;
+
+class VirgilEd25519BatchVerifier::Impl {
+public:
+    struct Item {
+        ge_p3 negR;
+        sc s;
+        sc k;
+        sc z;
+        size_t keyIndex;
+    };
+
+    Impl() : random(kRandomPersonalInfo), hash(VirgilHash::Algorithm::SHA512) {}
+
+    std::vector<Item> items;
+    std::vector<ge_p3> negKeys;
+    std::map<VirgilByteArray, size_t> keyIndices;
+    VirgilRandom random;
+    VirgilHash hash;
+};
+
+VirgilEd25519BatchVerifier::VirgilEd25519BatchVerifier() : impl_(new Impl()) {}
+
+VirgilEd25519BatchVerifier::~VirgilEd25519BatchVerifier() noexcept = default;
+
+bool VirgilEd25519BatchVerifier::add(
+        const VirgilByteArray& publicKey, const VirgilByteArray& signature, const VirgilByteArray& message) {
+
+    using namespace virgil::crypto::internal;
+
+    if (publicKey.size() != kPublicKeySize || signature.size() != kSignatureSize) {
+        return false;
+    }
+
+    const unsigned char* encodedR = signature.data();
+    const unsigned char* encodedS = signature.data() + 32;
+
+    Impl::Item item;
+    if (!sc_is_canonical(encodedS) || !ge_from_bytes_negate(item.negR, encodedR)) {
+        return false;
+    }
+    sc_from_bytes(item.s, encodedS);
+
+    auto keyIt = impl_->keyIndices.find(publicKey);
+    if (keyIt == impl_->keyIndices.end()) {
+        ge_p3 negKey;
+        if (!ge_from_bytes_negate(negKey, publicKey.data())) {
+            return false;
+        }
+        keyIt = impl_->keyIndices.emplace(publicKey, impl_->negKeys.size()).first;
+        impl_->negKeys.push_back(negKey);
+    }
+    item.keyIndex = keyIt->second;
+
+    impl_->hash.start();
+    impl_->hash.update(VirgilByteArray(encodedR, encodedR + 32));
+    impl_->hash.update(publicKey);
+    impl_->hash.update(message);
+    const VirgilByteArray k = impl_->hash.finish();
+    sc_reduce_bytes(item.k, k.data());
+
+    unsigned char z[32] = {0};
+    const VirgilByteArray random = impl_->random.randomize(kRandomScalarSize);
+    std::copy(random.begin(), random.end(), z);
+    sc_from_bytes(item.z, z);
+
+    impl_->items.push_back(item);
+    return true;
+}
+
+size_t VirgilEd25519BatchVerifier::size() const {
+    return impl_->items.size();
+}
+
+bool VirgilEd25519BatchVerifier::verify(size_t first, size_t count) const {
+    using namespace virgil::crypto::internal;
+
+    if (first > impl_->items.size() || count > impl_->items.size() - first) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    std::vector<ge_p3> points;
+    std::vector<sc> scalars;
+    points.reserve(2 * count + 1);
+    scalars.reserve(2 * count + 1);
+
+    // B * sum(z * s)
+    points.push_back(kGe_Base);
+    scalars.push_back(sc());
+
+    // -R * z, and -A * sum(z * k) for each unique key
+    std::vector<size_t> keySlots(impl_->negKeys.size(), static_cast<size_t>(-1));
+    for (size_t i = first; i < first + count; ++i) {
+        const Impl::Item& item = impl_->items[i];
+        sc t;
+        sc_mul(t, item.z, item.s);
+        sc_add(scalars.front(), scalars.front(), t);
+
+        points.push_back(item.negR);
+        scalars.push_back(item.z);
+
+        sc_mul(t, item.z, item.k);
+        size_t& slot = keySlots[item.keyIndex];
+        if (slot == static_cast<size_t>(-1)) {
+            slot = points.size();
+            points.push_back(impl_->negKeys[item.keyIndex]);
+            scalars.push_back(t);
+        } else {
+            sc_add(scalars[slot], scalars[slot], t);
+        }
+    }
+
+    ge_p3 result;
+    ge_multi_scalar_mul(result, points, scalars);
+    for (size_t i = 0; i < 3; ++i) {
+        ge_dbl(result, result);
+    }
+    return ge_is_identity(result);
+}
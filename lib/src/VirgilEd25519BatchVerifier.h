@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_ED25519_BATCH_VERIFIER_H
+#define VIRGIL_CRYPTO_ED25519_BATCH_VERIFIER_H
+
+#include <virgil/crypto/VirgilByteArray.h>
+
+#include <memory>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Randomized batch verification of the Ed25519 signatures.
+ *
+ * Signatures (R, s) of the messages M made with keys A are verified at once with the single
+ *     multi-scalar multiplication, where z are random 128-bit scalars and k = SHA512(R || A || M):
+ *
+ * @code
+ *     8 * ((sum(z * s) mod L) * B - sum(z * R) - sum((z * k mod L) * A)) == 0
+ * @endcode
+ *
+ * The same keys are merged, so a batch signed with a few keys costs almost one point per signature.
+ *
+ * @note Cofactored equation is used, so signatures deliberately crafted with small order components
+ *     may pass batch verification, but fail the single one.
+ */
+class VirgilEd25519BatchVerifier {
+public:
+    /**
+     * @name Configuration constants
+     */
+    ///@{
+    static constexpr size_t kPublicKeySize = 32;
+    static constexpr size_t kSignatureSize = 64;
+    ///@}
+
+    VirgilEd25519BatchVerifier();
+
+    ~VirgilEd25519BatchVerifier() noexcept;
+
+    /**
+     * @brief Add signature to the batch.
+     *
+     * @param publicKey - raw Ed25519 public key.
+     * @param signature - raw Ed25519 signature.
+     * @param message - signed message.
+     * @return false if signature or key has wrong size or non canonical encoding,
+     *     such signature is not added and SHOULD be verified individually.
+     */
+    bool add(const VirgilByteArray& publicKey, const VirgilByteArray& signature, const VirgilByteArray& message);
+
+    /**
+     * @brief Return number of the added signatures.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Verify added signatures with indices [first, first + count) at once.
+     * @return true if all signatures are valid, false if at least one of them is invalid.
+     */
+    bool verify(size_t first, size_t count) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_ED25519_BATCH_VERIFIER_H */
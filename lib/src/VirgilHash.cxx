@@ -47,12 +47,14 @@
 #include "utils.h"
 #include "mbedtls_context.h"
 #include "mbedtls_type_utils.h"
+#include "VirgilMultiBufferHash.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilCryptoException;
 
 using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::internal::VirgilMultiBufferHash;
 using virgil::crypto::foundation::asn1::VirgilAsn1Compatible;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
@@ -186,6 +188,19 @@ VirgilByteArray VirgilHash::hash(const VirgilByteArray& data) const {
     return digest;
 }
 
+std::vector<VirgilByteArray> VirgilHash::hashBatch(const std::vector<VirgilByteArray>& messages) const {
+    checkState();
+    if (messages.size() > 1 && VirgilMultiBufferHash::lanes(algorithm()) > 0) {
+        return VirgilMultiBufferHash::hash(algorithm(), messages);
+    }
+    std::vector<VirgilByteArray> digests;
+    digests.reserve(messages.size());
+    for (const auto& message : messages) {
+        digests.push_back(hash(message));
+    }
+    return digests;
+}
+
 void VirgilHash::hmacStart(const VirgilByteArray& key) {
     checkState();
     system_crypto_handler(
@@ -46,6 +46,7 @@
 
 #include "utils.h"
 #include "mbedtls_type_utils.h"
+#include "VirgilAcceleratedHash.h"
 
 
 using virgil::crypto::VirgilByteArray;
@@ -71,7 +72,7 @@ public:
 
     Impl(mbedtls_kdf_type_t kdf_type, mbedtls_md_type_t md_type) :
             kdf_info(mbedtls_kdf_info_from_type(kdf_type)),
-            md_info(mbedtls_md_info_from_type(md_type)) {
+            md_info(internal::VirgilAcceleratedHash::mdInfoFromType(md_type)) {
         if (kdf_info == nullptr) {
             throw make_error(VirgilCryptoError::UnsupportedAlgorithm, internal::to_string(kdf_type));
         }
@@ -82,7 +83,7 @@ public:
 
     Impl(const char* kdf_name, const char* md_name) :
             kdf_info(mbedtls_kdf_info_from_string(kdf_name)),
-            md_info(mbedtls_md_info_from_string(md_name)) {
+            md_info(internal::VirgilAcceleratedHash::mdInfoFromString(md_name)) {
         if (kdf_info == nullptr) {
             throw make_error(VirgilCryptoError::UnsupportedAlgorithm, kdf_name);
         }
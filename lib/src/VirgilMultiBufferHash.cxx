@@ -0,0 +1,539 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilMultiBufferHash.h"
+#include "VirgilCpuFeatures.h"
+#include "VirgilSha2Constants.h"
+#include "utils.h"
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+#include <immintrin.h>
+#endif
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::internal::VirgilMultiBufferHash;
+using virgil::crypto::foundation::internal::VirgilCpuFeatures;
+using virgil::crypto::internal::secure_zeroize;
+using virgil::crypto::foundation::internal::sha2::kSha224Init;
+using virgil::crypto::foundation::internal::sha2::kSha256Init;
+using virgil::crypto::foundation::internal::sha2::kSha384Init;
+using virgil::crypto::foundation::internal::sha2::kSha512Init;
+using virgil::crypto::foundation::internal::sha2::kSha256K;
+using virgil::crypto::foundation::internal::sha2::kSha512K;
+
+namespace {
+
+constexpr size_t kMaxLanes = 16;
+
+#if VIRGIL_CRYPTO_X86_ENABLED
+
+/**
+ * @brief SHA-2 compression is shared by all kernels.
+ *
+ * Kernel defines vector type VIRGIL_V_TYPE and operations VIRGIL_V_*, and the functions
+ * VIRGIL_SHA2_BSIG0/1, VIRGIL_SHA2_SSIG0/1 of the required word size.
+ * State is expected in the vectors s[8], message schedule in the vectors w[16], round constants in the array K.
+ */
+#define VIRGIL_SHA2_ROUND(a, b, c, d, e, f, g, h, i) \
+    do { \
+        const VIRGIL_V_TYPE t1 = VIRGIL_V_ADD(VIRGIL_V_ADD(h, VIRGIL_SHA2_BSIG1(e)), \
+                VIRGIL_V_ADD(VIRGIL_V_CH(e, f, g), VIRGIL_V_ADD(VIRGIL_V_SET1(K[t + i]), w[(t + i) & 15]))); \
+        d = VIRGIL_V_ADD(d, t1); \
+        h = VIRGIL_V_ADD(t1, VIRGIL_V_ADD(VIRGIL_SHA2_BSIG0(a), VIRGIL_V_MAJ(a, b, c))); \
+    } while (0)
+
+#define VIRGIL_SHA2_COMPRESS(rounds) \
+    do { \
+        VIRGIL_V_TYPE a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7]; \
+        for (size_t t = 0; t < rounds; t += 8) { \
+            if (t >= 16) { \
+                for (size_t i = t; i < t + 8; ++i) { \
+                    w[i & 15] = VIRGIL_V_ADD( \
+                            VIRGIL_V_ADD(VIRGIL_SHA2_SSIG1(w[(i - 2) & 15]), w[(i - 7) & 15]), \
+                            VIRGIL_V_ADD(VIRGIL_SHA2_SSIG0(w[(i - 15) & 15]), w[i & 15])); \
+                } \
+            } \
+            VIRGIL_SHA2_ROUND(a, b, c, d, e, f, g, h, 0); \
+            VIRGIL_SHA2_ROUND(h, a, b, c, d, e, f, g, 1); \
+            VIRGIL_SHA2_ROUND(g, h, a, b, c, d, e, f, 2); \
+            VIRGIL_SHA2_ROUND(f, g, h, a, b, c, d, e, 3); \
+            VIRGIL_SHA2_ROUND(e, f, g, h, a, b, c, d, 4); \
+            VIRGIL_SHA2_ROUND(d, e, f, g, h, a, b, c, 5); \
+            VIRGIL_SHA2_ROUND(c, d, e, f, g, h, a, b, 6); \
+            VIRGIL_SHA2_ROUND(b, c, d, e, f, g, h, a, 7); \
+        } \
+        s[0] = VIRGIL_V_ADD(s[0], a); s[1] = VIRGIL_V_ADD(s[1], b); \
+        s[2] = VIRGIL_V_ADD(s[2], c); s[3] = VIRGIL_V_ADD(s[3], d); \
+        s[4] = VIRGIL_V_ADD(s[4], e); s[5] = VIRGIL_V_ADD(s[5], f); \
+        s[6] = VIRGIL_V_ADD(s[6], g); s[7] = VIRGIL_V_ADD(s[7], h); \
+    } while (0)
+
+#define VIRGIL_SHA2_BSIG0_256(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 2), VIRGIL_V_ROTR(x, 13), VIRGIL_V_ROTR(x, 22))
+#define VIRGIL_SHA2_BSIG1_256(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 6), VIRGIL_V_ROTR(x, 11), VIRGIL_V_ROTR(x, 25))
+#define VIRGIL_SHA2_SSIG0_256(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 7), VIRGIL_V_ROTR(x, 18), VIRGIL_V_SHR(x, 3))
+#define VIRGIL_SHA2_SSIG1_256(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 17), VIRGIL_V_ROTR(x, 19), VIRGIL_V_SHR(x, 10))
+
+#define VIRGIL_SHA2_BSIG0_512(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 28), VIRGIL_V_ROTR(x, 34), VIRGIL_V_ROTR(x, 39))
+#define VIRGIL_SHA2_BSIG1_512(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 14), VIRGIL_V_ROTR(x, 18), VIRGIL_V_ROTR(x, 41))
+#define VIRGIL_SHA2_SSIG0_512(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 1), VIRGIL_V_ROTR(x, 8), VIRGIL_V_SHR(x, 7))
+#define VIRGIL_SHA2_SSIG1_512(x) VIRGIL_V_XOR3(VIRGIL_V_ROTR(x, 19), VIRGIL_V_ROTR(x, 61), VIRGIL_V_SHR(x, 6))
+
+/**
+ * @brief Load 32 bytes at the given offset of 8 blocks, and transpose them to 8 vectors of 32-bit words.
+ */
+#define VIRGIL_AVX2_LOAD_8X32(out, blocks, offset) \
+    do { \
+        const __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[0] + (offset))); \
+        const __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[1] + (offset))); \
+        const __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[2] + (offset))); \
+        const __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[3] + (offset))); \
+        const __m256i r4 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[4] + (offset))); \
+        const __m256i r5 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[5] + (offset))); \
+        const __m256i r6 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[6] + (offset))); \
+        const __m256i r7 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[7] + (offset))); \
+        const __m256i t0 = _mm256_unpacklo_epi32(r0, r1), t1 = _mm256_unpackhi_epi32(r0, r1); \
+        const __m256i t2 = _mm256_unpacklo_epi32(r2, r3), t3 = _mm256_unpackhi_epi32(r2, r3); \
+        const __m256i t4 = _mm256_unpacklo_epi32(r4, r5), t5 = _mm256_unpackhi_epi32(r4, r5); \
+        const __m256i t6 = _mm256_unpacklo_epi32(r6, r7), t7 = _mm256_unpackhi_epi32(r6, r7); \
+        const __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2); \
+        const __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3); \
+        const __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6); \
+        const __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7); \
+        (out)[0] = _mm256_permute2x128_si256(u0, u4, 0x20); (out)[4] = _mm256_permute2x128_si256(u0, u4, 0x31); \
+        (out)[1] = _mm256_permute2x128_si256(u1, u5, 0x20); (out)[5] = _mm256_permute2x128_si256(u1, u5, 0x31); \
+        (out)[2] = _mm256_permute2x128_si256(u2, u6, 0x20); (out)[6] = _mm256_permute2x128_si256(u2, u6, 0x31); \
+        (out)[3] = _mm256_permute2x128_si256(u3, u7, 0x20); (out)[7] = _mm256_permute2x128_si256(u3, u7, 0x31); \
+    } while (0)
+
+/**
+ * @brief Load 32 bytes at the given offset of 4 blocks, and transpose them to 4 vectors of 64-bit words.
+ */
+#define VIRGIL_AVX2_LOAD_4X64(out, blocks, offset) \
+    do { \
+        const __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[0] + (offset))); \
+        const __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[1] + (offset))); \
+        const __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[2] + (offset))); \
+        const __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((blocks)[3] + (offset))); \
+        const __m256i t0 = _mm256_unpacklo_epi64(r0, r1), t1 = _mm256_unpackhi_epi64(r0, r1); \
+        const __m256i t2 = _mm256_unpacklo_epi64(r2, r3), t3 = _mm256_unpackhi_epi64(r2, r3); \
+        (out)[0] = _mm256_permute2x128_si256(t0, t2, 0x20); (out)[2] = _mm256_permute2x128_si256(t0, t2, 0x31); \
+        (out)[1] = _mm256_permute2x128_si256(t1, t3, 0x20); (out)[3] = _mm256_permute2x128_si256(t1, t3, 0x31); \
+    } while (0)
+
+#define VIRGIL_AVX2_BSWAP32 \
+    _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, \
+                    12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3)
+
+#define VIRGIL_AVX2_BSWAP64 \
+    _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, \
+                    8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7)
+
+// AVX2 operations, shared by both word sizes.
+#define VIRGIL_V_TYPE __m256i
+#define VIRGIL_V_XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256(a, b), c)
+#define VIRGIL_V_CH(e, f, g) _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))
+#define VIRGIL_V_MAJ(a, b, c) _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)))
+
+// SHA-224/256: 8 lanes of 32-bit words.
+#define VIRGIL_V_ADD(a, b) _mm256_add_epi32(a, b)
+#define VIRGIL_V_SET1(k) _mm256_set1_epi32(static_cast<int>(k))
+#define VIRGIL_V_SHR(x, n) _mm256_srli_epi32(x, n)
+#define VIRGIL_V_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define VIRGIL_SHA2_BSIG0 VIRGIL_SHA2_BSIG0_256
+#define VIRGIL_SHA2_BSIG1 VIRGIL_SHA2_BSIG1_256
+#define VIRGIL_SHA2_SSIG0 VIRGIL_SHA2_SSIG0_256
+#define VIRGIL_SHA2_SSIG1 VIRGIL_SHA2_SSIG1_256
+
+VIRGIL_CRYPTO_X86_TARGET("avx2") void sha256_blocks_avx2(uint32_t* state, const unsigned char* const* blocks) {
+    const uint32_t* K = kSha256K;
+    const __m256i byteSwap = VIRGIL_AVX2_BSWAP32;
+    __m256i w[16];
+    VIRGIL_AVX2_LOAD_8X32(w, blocks, 0);
+    VIRGIL_AVX2_LOAD_8X32(w + 8, blocks, 32);
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = _mm256_shuffle_epi8(w[i], byteSwap);
+    }
+    __m256i s[8];
+    for (size_t i = 0; i < 8; ++i) {
+        s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 8 * i));
+    }
+    VIRGIL_SHA2_COMPRESS(64);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 8 * i), s[i]);
+    }
+}
+
+#undef VIRGIL_V_ADD
+#undef VIRGIL_V_SET1
+#undef VIRGIL_V_SHR
+#undef VIRGIL_V_ROTR
+#undef VIRGIL_SHA2_BSIG0
+#undef VIRGIL_SHA2_BSIG1
+#undef VIRGIL_SHA2_SSIG0
+#undef VIRGIL_SHA2_SSIG1
+
+// SHA-384/512: 4 lanes of 64-bit words.
+#define VIRGIL_V_ADD(a, b) _mm256_add_epi64(a, b)
+#define VIRGIL_V_SET1(k) _mm256_set1_epi64x(static_cast<long long>(k))
+#define VIRGIL_V_SHR(x, n) _mm256_srli_epi64(x, n)
+#define VIRGIL_V_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define VIRGIL_SHA2_BSIG0 VIRGIL_SHA2_BSIG0_512
+#define VIRGIL_SHA2_BSIG1 VIRGIL_SHA2_BSIG1_512
+#define VIRGIL_SHA2_SSIG0 VIRGIL_SHA2_SSIG0_512
+#define VIRGIL_SHA2_SSIG1 VIRGIL_SHA2_SSIG1_512
+
+VIRGIL_CRYPTO_X86_TARGET("avx2") void sha512_blocks_avx2(uint64_t* state, const unsigned char* const* blocks) {
+    const uint64_t* K = kSha512K;
+    const __m256i byteSwap = VIRGIL_AVX2_BSWAP64;
+    __m256i w[16];
+    for (size_t i = 0; i < 4; ++i) {
+        VIRGIL_AVX2_LOAD_4X64(w + 4 * i, blocks, 32 * i);
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = _mm256_shuffle_epi8(w[i], byteSwap);
+    }
+    __m256i s[8];
+    for (size_t i = 0; i < 8; ++i) {
+        s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 4 * i));
+    }
+    VIRGIL_SHA2_COMPRESS(80);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 4 * i), s[i]);
+    }
+}
+
+#undef VIRGIL_V_ADD
+#undef VIRGIL_V_SET1
+#undef VIRGIL_V_SHR
+#undef VIRGIL_V_ROTR
+#undef VIRGIL_SHA2_BSIG0
+#undef VIRGIL_SHA2_BSIG1
+#undef VIRGIL_SHA2_SSIG0
+#undef VIRGIL_SHA2_SSIG1
+#undef VIRGIL_V_TYPE
+#undef VIRGIL_V_XOR3
+#undef VIRGIL_V_CH
+#undef VIRGIL_V_MAJ
+
+// Unmasked AVX-512 intrinsics of GCC pass _mm512_undefined_epi32() as a merge source,
+// that is reported as (maybe) uninitialized at -O2 once inlined, so silence it for these kernels only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// AVX-512 operations, shared by both word sizes: native rotations and three-input logic.
+#define VIRGIL_V_TYPE __m512i
+#define VIRGIL_V_XOR3(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0x96)
+#define VIRGIL_V_CH(e, f, g) _mm512_ternarylogic_epi64(e, f, g, 0xca)
+#define VIRGIL_V_MAJ(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xe8)
+
+// SHA-224/256: 16 lanes of 32-bit words.
+#define VIRGIL_V_ADD(a, b) _mm512_add_epi32(a, b)
+#define VIRGIL_V_SET1(k) _mm512_set1_epi32(static_cast<int>(k))
+#define VIRGIL_V_SHR(x, n) _mm512_srli_epi32(x, n)
+#define VIRGIL_V_ROTR(x, n) _mm512_ror_epi32(x, n)
+#define VIRGIL_SHA2_BSIG0 VIRGIL_SHA2_BSIG0_256
+#define VIRGIL_SHA2_BSIG1 VIRGIL_SHA2_BSIG1_256
+#define VIRGIL_SHA2_SSIG0 VIRGIL_SHA2_SSIG0_256
+#define VIRGIL_SHA2_SSIG1 VIRGIL_SHA2_SSIG1_256
+
+VIRGIL_CRYPTO_X86_TARGET("avx2,avx512f,avx512bw")
+void sha256_blocks_avx512(uint32_t* state, const unsigned char* const* blocks) {
+    const uint32_t* K = kSha256K;
+    const __m256i byteSwap = VIRGIL_AVX2_BSWAP32;
+    __m256i low[16];
+    __m256i high[16];
+    VIRGIL_AVX2_LOAD_8X32(low, blocks, 0);
+    VIRGIL_AVX2_LOAD_8X32(low + 8, blocks, 32);
+    VIRGIL_AVX2_LOAD_8X32(high, blocks + 8, 0);
+    VIRGIL_AVX2_LOAD_8X32(high + 8, blocks + 8, 32);
+    __m512i w[16];
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_shuffle_epi8(low[i], byteSwap)),
+                _mm256_shuffle_epi8(high[i], byteSwap), 1);
+    }
+    __m512i s[8];
+    for (size_t i = 0; i < 8; ++i) {
+        s[i] = _mm512_loadu_si512(state + 16 * i);
+    }
+    VIRGIL_SHA2_COMPRESS(64);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm512_storeu_si512(state + 16 * i, s[i]);
+    }
+}
+
+#undef VIRGIL_V_ADD
+#undef VIRGIL_V_SET1
+#undef VIRGIL_V_SHR
+#undef VIRGIL_V_ROTR
+#undef VIRGIL_SHA2_BSIG0
+#undef VIRGIL_SHA2_BSIG1
+#undef VIRGIL_SHA2_SSIG0
+#undef VIRGIL_SHA2_SSIG1
+
+// SHA-384/512: 8 lanes of 64-bit words.
+#define VIRGIL_V_ADD(a, b) _mm512_add_epi64(a, b)
+#define VIRGIL_V_SET1(k) _mm512_set1_epi64(static_cast<long long>(k))
+#define VIRGIL_V_SHR(x, n) _mm512_srli_epi64(x, n)
+#define VIRGIL_V_ROTR(x, n) _mm512_ror_epi64(x, n)
+#define VIRGIL_SHA2_BSIG0 VIRGIL_SHA2_BSIG0_512
+#define VIRGIL_SHA2_BSIG1 VIRGIL_SHA2_BSIG1_512
+#define VIRGIL_SHA2_SSIG0 VIRGIL_SHA2_SSIG0_512
+#define VIRGIL_SHA2_SSIG1 VIRGIL_SHA2_SSIG1_512
+
+VIRGIL_CRYPTO_X86_TARGET("avx2,avx512f,avx512bw")
+void sha512_blocks_avx512(uint64_t* state, const unsigned char* const* blocks) {
+    const uint64_t* K = kSha512K;
+    const __m256i byteSwap = VIRGIL_AVX2_BSWAP64;
+    __m256i low[16];
+    __m256i high[16];
+    for (size_t i = 0; i < 4; ++i) {
+        VIRGIL_AVX2_LOAD_4X64(low + 4 * i, blocks, 32 * i);
+        VIRGIL_AVX2_LOAD_4X64(high + 4 * i, blocks + 4, 32 * i);
+    }
+    __m512i w[16];
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_shuffle_epi8(low[i], byteSwap)),
+                _mm256_shuffle_epi8(high[i], byteSwap), 1);
+    }
+    __m512i s[8];
+    for (size_t i = 0; i < 8; ++i) {
+        s[i] = _mm512_loadu_si512(state + 8 * i);
+    }
+    VIRGIL_SHA2_COMPRESS(80);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm512_storeu_si512(state + 8 * i, s[i]);
+    }
+}
+
+#undef VIRGIL_V_ADD
+#undef VIRGIL_V_SET1
+#undef VIRGIL_V_SHR
+#undef VIRGIL_V_ROTR
+#undef VIRGIL_SHA2_BSIG0
+#undef VIRGIL_SHA2_BSIG1
+#undef VIRGIL_SHA2_SSIG0
+#undef VIRGIL_SHA2_SSIG1
+#undef VIRGIL_V_TYPE
+#undef VIRGIL_V_XOR3
+#undef VIRGIL_V_CH
+#undef VIRGIL_V_MAJ
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif /* VIRGIL_CRYPTO_X86_ENABLED */
+
+/**
+ * @brief Kernel processes one block of each lane, state is stored word by word: state[word * lanes + lane].
+ */
+template<typename Word>
+struct multi_buffer_kernel {
+    void (* fn)(Word* state, const unsigned char* const* blocks);
+    size_t lanes;
+};
+
+multi_buffer_kernel<uint32_t> select_sha256_kernel() noexcept {
+#if VIRGIL_CRYPTO_X86_ENABLED
+    if (VirgilCpuFeatures::hasAvx512()) {
+        return { sha256_blocks_avx512, 16 };
+    }
+    if (VirgilCpuFeatures::hasAvx2()) {
+        return { sha256_blocks_avx2, 8 };
+    }
+#endif
+    return { nullptr, 0 };
+}
+
+multi_buffer_kernel<uint64_t> select_sha512_kernel() noexcept {
+#if VIRGIL_CRYPTO_X86_ENABLED
+    if (VirgilCpuFeatures::hasAvx512()) {
+        return { sha512_blocks_avx512, 8 };
+    }
+    if (VirgilCpuFeatures::hasAvx2()) {
+        return { sha512_blocks_avx2, 4 };
+    }
+#endif
+    return { nullptr, 0 };
+}
+
+const multi_buffer_kernel<uint32_t>& get_sha256_kernel() noexcept {
+    static const multi_buffer_kernel<uint32_t> kernel = select_sha256_kernel();
+    return kernel;
+}
+
+const multi_buffer_kernel<uint64_t>& get_sha512_kernel() noexcept {
+    static const multi_buffer_kernel<uint64_t> kernel = select_sha512_kernel();
+    return kernel;
+}
+
+template<typename Word>
+void hash_messages(
+        const multi_buffer_kernel<Word>& kernel, const Word (& init)[8], size_t digestSize,
+        const std::vector<VirgilByteArray>& messages, std::vector<VirgilByteArray>& digests) {
+
+    constexpr size_t kBlockSize = 16 * sizeof(Word);
+    constexpr size_t kLengthSize = 2 * sizeof(Word);
+    const size_t lanes = kernel.lanes;
+    if (lanes == 0) {
+        throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Multi-buffer hashing is not available.");
+    }
+
+    // Messages of the similar length are hashed together, so lanes are busy till the end of the group.
+    std::vector<size_t> order(messages.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&messages](size_t lhs, size_t rhs) {
+        return messages[lhs].size() < messages[rhs].size();
+    });
+
+    Word state[8 * kMaxLanes];
+    unsigned char tails[kMaxLanes][2 * kBlockSize];
+    const VirgilByteArray* laneMessages[kMaxLanes];
+    size_t fullBlocks[kMaxLanes];
+    size_t totalBlocks[kMaxLanes];
+    const unsigned char* blocks[kMaxLanes];
+
+    for (size_t first = 0; first < messages.size(); first += lanes) {
+        const size_t count = std::min(lanes, messages.size() - first);
+        size_t maxBlocks = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            // Unused lanes of the last group repeat the first message, their output is ignored.
+            const VirgilByteArray& message = messages[order[first + (lane < count ? lane : 0)]];
+            const size_t tailLen = message.size() % kBlockSize;
+            laneMessages[lane] = &message;
+            fullBlocks[lane] = message.size() / kBlockSize;
+            const size_t tailBlocks = (tailLen + 1 + kLengthSize > kBlockSize) ? 2 : 1;
+            totalBlocks[lane] = fullBlocks[lane] + tailBlocks;
+            maxBlocks = std::max(maxBlocks, totalBlocks[lane]);
+
+            unsigned char* tail = tails[lane];
+            std::memset(tail, 0, sizeof(tails[lane]));
+            if (tailLen > 0) {
+                std::memcpy(tail, message.data() + fullBlocks[lane] * kBlockSize, tailLen);
+            }
+            tail[tailLen] = 0x80;
+            const uint64_t bitLen = static_cast<uint64_t>(message.size()) << 3;
+            unsigned char* lengthEnd = tail + tailBlocks * kBlockSize;
+            for (size_t i = 0; i < 8; ++i) {
+                lengthEnd[-1 - static_cast<ptrdiff_t>(i)] = static_cast<unsigned char>(bitLen >> (8 * i));
+            }
+            if (kLengthSize > 8) {
+                lengthEnd[-9] = static_cast<unsigned char>(static_cast<uint64_t>(message.size()) >> 61);
+            }
+
+            for (size_t i = 0; i < 8; ++i) {
+                state[i * lanes + lane] = init[i];
+            }
+        }
+
+        for (size_t block = 0; block < maxBlocks; ++block) {
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                if (block < fullBlocks[lane]) {
+                    blocks[lane] = laneMessages[lane]->data() + block * kBlockSize;
+                } else {
+                    // Finished lanes process their last block again, the result is not used.
+                    const size_t tailBlock = std::min(block, totalBlocks[lane] - 1) - fullBlocks[lane];
+                    blocks[lane] = tails[lane] + tailBlock * kBlockSize;
+                }
+            }
+            kernel.fn(state, blocks);
+            for (size_t lane = 0; lane < count; ++lane) {
+                if (block + 1 != totalBlocks[lane]) {
+                    continue;
+                }
+                VirgilByteArray& digest = digests[order[first + lane]];
+                digest.resize(digestSize);
+                for (size_t i = 0; i < digestSize; ++i) {
+                    const Word word = state[(i / sizeof(Word)) * lanes + lane];
+                    digest[i] = static_cast<unsigned char>(word >> (8 * (sizeof(Word) - 1 - i % sizeof(Word))));
+                }
+            }
+        }
+    }
+
+    secure_zeroize(state, sizeof(state));
+    secure_zeroize(tails, sizeof(tails));
+}
+
+}
+
+size_t VirgilMultiBufferHash::lanes(VirgilHash::Algorithm algorithm) noexcept {
+    switch (algorithm) {
+        case VirgilHash::Algorithm::SHA224:
+        case VirgilHash::Algorithm::SHA256:
+            return get_sha256_kernel().lanes;
+        case VirgilHash::Algorithm::SHA384:
+        case VirgilHash::Algorithm::SHA512:
+            return get_sha512_kernel().lanes;
+        default:
+            return 0;
+    }
+}
+
+std::vector<VirgilByteArray> VirgilMultiBufferHash::hash(
+        VirgilHash::Algorithm algorithm, const std::vector<VirgilByteArray>& messages) {
+    std::vector<VirgilByteArray> digests(messages.size());
+    switch (algorithm) {
+        case VirgilHash::Algorithm::SHA224:
+            hash_messages(get_sha256_kernel(), kSha224Init, 28, messages, digests);
+            break;
+        case VirgilHash::Algorithm::SHA256:
+            hash_messages(get_sha256_kernel(), kSha256Init, 32, messages, digests);
+            break;
+        case VirgilHash::Algorithm::SHA384:
+            hash_messages(get_sha512_kernel(), kSha384Init, 48, messages, digests);
+            break;
+        case VirgilHash::Algorithm::SHA512:
+            hash_messages(get_sha512_kernel(), kSha512Init, 64, messages, digests);
+            break;
+        default:
+            break;
+    }
+    return digests;
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_MULTI_BUFFER_HASH_H
+#define VIRGIL_CRYPTO_MULTI_BUFFER_HASH_H
+
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief SHA-2 family over many independent messages at once.
+ *
+ * Each SIMD lane processes its own message: SHA-224/256 are computed 8 (AVX2) or 16 (AVX-512) at a time,
+ * SHA-384/512 are computed 4 (AVX2) or 8 (AVX-512) at a time.
+ * Messages are grouped by the length, so lanes of one group finish at the nearly same block.
+ *
+ * Output is identical to the one-by-one hashing.
+ */
+class VirgilMultiBufferHash {
+public:
+    /**
+     * @brief Return number of messages that are processed in parallel.
+     * @return 0 if given algorithm is not accelerated on the current CPU.
+     */
+    static size_t lanes(VirgilHash::Algorithm algorithm) noexcept;
+
+    /**
+     * @brief Return hash of each given message.
+     * @note Accelerated algorithm MUST be given, see lanes().
+     */
+    static std::vector<VirgilByteArray> hash(
+            VirgilHash::Algorithm algorithm, const std::vector<VirgilByteArray>& messages);
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_MULTI_BUFFER_HASH_H */
@@ -65,6 +65,13 @@
  * PKCS#9 OIDs
  */
 #define OID_PKCS9_AUTHENTICATED_DATA MBEDTLS_OID_PKCS9 "\x0F\x01\x02" ///< ct-authData ::= { pkcs-9 smime(16) ct(1) ct-authData(2) }
+#define OID_PKCS9_CHACHA20_POLY1305 MBEDTLS_OID_PKCS9 "\x10\x03\x12" ///< id-alg-AEADChaCha20Poly1305 ::= { pkcs-9 smime(16) alg(3) 18 }
+
+/**
+ * Virgil Security OIDs
+ */
+#define OID_VIRGIL MBEDTLS_OID_INTERNET "\x04\x01\x83\xAC\x1B" ///< virgil ::= { iso(1) org(3) dod(6) internet(1) private(4) enterprise(1) 54811 }
+#define OID_VIRGIL_TREE_HASH OID_VIRGIL "\x02\x01" ///< id-virgil-tree-hash ::= { virgil hash(2) tree(1) }
 
 /**
  * @brief Translate low-level oid to std::string
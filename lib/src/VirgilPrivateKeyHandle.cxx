@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+
+#include "utils.h"
+#include "VirgilContextPool.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilPrivateKeyHandle;
+
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+
+using virgil::crypto::internal::VirgilContextPool;
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Handle class fields.
+ *
+ * Parsed key context is not reentrant for decryption (blinding values, random generator state),
+ * so every concurrent decryption takes its own context from the pool.
+ * Contexts are created on demand from the already decrypted DER key, so the password based
+ * key derivation is performed only once.
+ *
+ * Signing does not modify the key context, so all signatures are made with one shared context.
+ */
+class VirgilPrivateKeyHandle::Impl {
+public:
+    Impl(const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword)
+            : plainPrivateKey(), signContext(),
+              pool([this]() {
+                  auto context = std::make_unique<VirgilAsymmetricCipher>();
+                  context->setPrivateKey(plainPrivateKey);
+                  return context;
+              }) {
+        auto context = std::make_unique<VirgilAsymmetricCipher>();
+        context->setPrivateKey(privateKey, privateKeyPassword);
+        plainPrivateKey = context->exportPrivateKeyToDER();
+        signContext = std::move(context);
+    }
+
+    ~Impl() noexcept {
+        VirgilByteArrayUtils::zeroize(plainPrivateKey);
+    }
+
+public:
+    VirgilByteArray plainPrivateKey;
+    std::unique_ptr<const VirgilAsymmetricCipher> signContext;
+    mutable VirgilContextPool<VirgilAsymmetricCipher> pool;
+};
+
+}}
+
+VirgilPrivateKeyHandle::VirgilPrivateKeyHandle(
+        const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword)
+        : impl_(std::make_shared<Impl>(privateKey, privateKeyPassword)) {}
+
+VirgilByteArray VirgilPrivateKeyHandle::decrypt(const VirgilByteArray& encryptedData) const {
+    return impl_->pool.perform([&encryptedData](VirgilAsymmetricCipher& context) {
+        return context.decrypt(encryptedData);
+    });
+}
+
+VirgilByteArray VirgilPrivateKeyHandle::sign(const VirgilByteArray& digest, int hashType) const {
+    return impl_->signContext->sign(digest, hashType);
+}
+
+VirgilPrivateKeyHandle::VirgilPrivateKeyHandle(const VirgilPrivateKeyHandle& rhs) = default;
+
+VirgilPrivateKeyHandle& VirgilPrivateKeyHandle::operator=(const VirgilPrivateKeyHandle& rhs) = default;
+
+VirgilPrivateKeyHandle::VirgilPrivateKeyHandle(VirgilPrivateKeyHandle&& rhs) noexcept = default;
+
+VirgilPrivateKeyHandle& VirgilPrivateKeyHandle::operator=(VirgilPrivateKeyHandle&& rhs) noexcept = default;
+
+VirgilPrivateKeyHandle::~VirgilPrivateKeyHandle() noexcept = default;
@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilPublicKeyCache.h>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "utils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::VirgilPublicKeyCache;
+using virgil::crypto::VirgilPublicKeyHandle;
+
+using virgil::crypto::foundation::VirgilHash;
+
+constexpr size_t VirgilPublicKeyCache::kDefaultCapacity;
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Cache class fields.
+ *
+ * Entries are ordered from the most recently used to the least recently used one,
+ *     and the index maps key digest to the entry.
+ * Key is parsed outside of the lock, so concurrent lookups are not blocked by the slow parsing.
+ */
+class VirgilPublicKeyCache::Impl {
+public:
+    using entry_type = std::pair<std::string, VirgilPublicKeyHandle>;
+    using entries_type = std::list<entry_type>;
+
+public:
+    explicit Impl(size_t capacity) : capacity(capacity), entries(), index(), hits(0), misses(0) {}
+
+    /**
+     * @brief Find entry and move it to the front.
+     * @note Mutex MUST be locked.
+     */
+    const VirgilPublicKeyHandle* find(const std::string& keyId, const VirgilByteArray& publicKey) {
+        auto it = index.find(keyId);
+        if (it == index.end() || it->second->second.getKey() != publicKey) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Add entry to the front and evict the least recently used entries.
+     * @note Mutex MUST be locked.
+     */
+    void insert(const std::string& keyId, const VirgilPublicKeyHandle& handle) {
+        auto it = index.find(keyId);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        entries.emplace_front(keyId, handle);
+        index[keyId] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+public:
+    const size_t capacity;
+    entries_type entries;
+    std::unordered_map<std::string, entries_type::iterator> index;
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    mutable std::mutex mutex;
+};
+
+}}
+
+static std::string make_key_id(const VirgilByteArray& publicKey) {
+    auto digest = VirgilHash(VirgilHash::Algorithm::SHA256).hash(publicKey);
+    return std::string(digest.cbegin(), digest.cend());
+}
+
+VirgilPublicKeyCache::VirgilPublicKeyCache(size_t capacity) : impl_() {
+    if (capacity == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Public key cache capacity can not be zero.");
+    }
+    impl_ = std::make_unique<Impl>(capacity);
+}
+
+VirgilPublicKeyHandle VirgilPublicKeyCache::get(const VirgilByteArray& publicKey) {
+    const auto keyId = make_key_id(publicKey);
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto handle = impl_->find(keyId, publicKey);
+        if (handle != nullptr) {
+            ++impl_->hits;
+            return *handle;
+        }
+    }
+    ++impl_->misses;
+    VirgilPublicKeyHandle handle(publicKey);
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->insert(keyId, handle);
+    return handle;
+}
+
+size_t VirgilPublicKeyCache::getCapacity() const {
+    return impl_->capacity;
+}
+
+size_t VirgilPublicKeyCache::size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->entries.size();
+}
+
+size_t VirgilPublicKeyCache::getHits() const {
+    return impl_->hits;
+}
+
+size_t VirgilPublicKeyCache::getMisses() const {
+    return impl_->misses;
+}
+
+void VirgilPublicKeyCache::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->index.clear();
+    impl_->entries.clear();
+}
+
+VirgilPublicKeyCache::~VirgilPublicKeyCache() noexcept = default;
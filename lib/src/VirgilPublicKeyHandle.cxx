@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+
+#include "utils.h"
+#include "VirgilContextPool.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilPublicKeyHandle;
+
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+
+using virgil::crypto::internal::VirgilContextPool;
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Handle class fields.
+ *
+ * Parsed key context is not reentrant for encryption (cached values, random generator state),
+ * so every concurrent encryption takes its own context from the pool.
+ * Contexts are created on demand from the DER key, that is cheaper to parse than PEM.
+ *
+ * Verification does not modify the key context, so all signatures are verified with one shared context.
+ */
+class VirgilPublicKeyHandle::Impl {
+public:
+    explicit Impl(const VirgilByteArray& publicKey)
+            : publicKey(publicKey), plainPublicKey(), algorithm(), verifyContext(),
+              pool([this]() {
+                  auto context = std::make_unique<VirgilAsymmetricCipher>();
+                  context->setPublicKey(plainPublicKey);
+                  return context;
+              }) {
+        auto context = std::make_unique<VirgilAsymmetricCipher>();
+        context->setPublicKey(publicKey);
+        plainPublicKey = context->exportPublicKeyToDER();
+        algorithm = context->toAsn1();
+        verifyContext = std::move(context);
+    }
+
+public:
+    VirgilByteArray publicKey;
+    VirgilByteArray plainPublicKey;
+    VirgilByteArray algorithm;
+    std::unique_ptr<const VirgilAsymmetricCipher> verifyContext;
+    mutable VirgilContextPool<VirgilAsymmetricCipher> pool;
+};
+
+}}
+
+VirgilPublicKeyHandle::VirgilPublicKeyHandle(const VirgilByteArray& publicKey)
+        : impl_(std::make_shared<Impl>(publicKey)) {}
+
+const VirgilByteArray& VirgilPublicKeyHandle::getKey() const {
+    return impl_->publicKey;
+}
+
+const VirgilByteArray& VirgilPublicKeyHandle::getAlgorithm() const {
+    return impl_->algorithm;
+}
+
+VirgilByteArray VirgilPublicKeyHandle::encrypt(const VirgilByteArray& data) const {
+    return impl_->pool.perform([&data](VirgilAsymmetricCipher& context) {
+        return context.encrypt(data);
+    });
+}
+
+bool VirgilPublicKeyHandle::verify(const VirgilByteArray& digest, const VirgilByteArray& sign, int hashType) const {
+    return impl_->verifyContext->verify(digest, sign, hashType);
+}
+
+VirgilPublicKeyHandle::VirgilPublicKeyHandle(const VirgilPublicKeyHandle& rhs) = default;
+
+VirgilPublicKeyHandle& VirgilPublicKeyHandle::operator=(const VirgilPublicKeyHandle& rhs) = default;
+
+VirgilPublicKeyHandle::VirgilPublicKeyHandle(VirgilPublicKeyHandle&& rhs) noexcept = default;
+
+VirgilPublicKeyHandle& VirgilPublicKeyHandle::operator=(VirgilPublicKeyHandle&& rhs) noexcept = default;
+
+VirgilPublicKeyHandle::~VirgilPublicKeyHandle() noexcept = default;
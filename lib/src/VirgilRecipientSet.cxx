@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilRecipientSet.h>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilRecipientSet;
+using virgil::crypto::make_error;
+
+VirgilRecipientSet::VirgilRecipientSet() : keyRecipients_() {}
+
+void VirgilRecipientSet::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey) {
+    addKeyRecipient(recipientId, VirgilPublicKeyHandle(publicKey));
+}
+
+void VirgilRecipientSet::addKeyRecipient(
+        const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey) {
+    if (recipientId.empty()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not add recipient with empty 'recipientId'");
+    }
+    if (!keyRecipients_.emplace(recipientId, publicKey).second) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Recipient with given 'recipientId' already exists");
+    }
+}
+
+void VirgilRecipientSet::removeKeyRecipient(const VirgilByteArray& recipientId) {
+    keyRecipients_.erase(recipientId);
+}
+
+bool VirgilRecipientSet::keyRecipientExists(const VirgilByteArray& recipientId) const {
+    return keyRecipients_.find(recipientId) != keyRecipients_.end();
+}
+
+size_t VirgilRecipientSet::size() const {
+    return keyRecipients_.size();
+}
@@ -0,0 +1,420 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilSecureAllocator.h>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include <mbedtls/platform.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include "utils.h"
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::VirgilSecureArena;
+using virgil::crypto::make_error;
+
+namespace virgil { namespace crypto { namespace internal {
+
+constexpr size_t kSecureBlockSizeMin = 16;
+constexpr size_t kSecureBlockClassesNum = 9;
+constexpr size_t kSecureBlockSizeMax = kSecureBlockSizeMin << (kSecureBlockClassesNum - 1);
+
+/**
+ * @name Region descriptor values.
+ *
+ * Descriptor of the slab region holds size class of its blocks plus one,
+ * descriptor of the first region of the large block holds number of its regions shifted left,
+ * descriptors of the other regions are left unused.
+ */
+///@{
+constexpr size_t kRegionUnused = 0;
+constexpr size_t kRegionLarge = 0xFF;
+constexpr size_t kRegionKindMask = 0xFF;
+constexpr size_t kRegionsNumShift = 8;
+///@}
+
+static size_t system_page_size() {
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+#else
+    const long pageSize = ::sysconf(_SC_PAGESIZE);
+    return pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+#endif
+}
+
+static size_t round_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static size_t block_class(size_t size) {
+    size_t sizeClass = 0;
+    for (size_t blockSize = kSecureBlockSizeMin; blockSize < size; blockSize <<= 1) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+/**
+ * @brief Reserve address space without committing memory.
+ * @return Range address or nullptr if address space can not be reserved.
+ */
+static void* reserve_range(size_t size) noexcept {
+#if defined(_WIN32)
+    return ::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* range = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return range == MAP_FAILED ? nullptr : range;
+#endif
+}
+
+/**
+ * @brief Commit zero filled memory within reserved range and try to lock it in RAM.
+ * @return false if memory can not be committed.
+ */
+static bool commit_range(void* ptr, size_t size, bool& locked) noexcept {
+#if defined(_WIN32)
+    if (::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+        return false;
+    }
+    locked = ::VirtualLock(ptr, size) != 0;
+#else
+    if (::mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+#if defined(MADV_DONTDUMP)
+    ::madvise(ptr, size, MADV_DONTDUMP);
+#endif
+    locked = ::mlock(ptr, size) == 0;
+#endif
+    return true;
+}
+
+/**
+ * @brief Release reserved range, committed memory is unlocked and released too.
+ */
+static void release_range(void* ptr, size_t size) noexcept {
+#if defined(_WIN32)
+    (void) size;
+    ::VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    ::munmap(ptr, size);
+#endif
+}
+
+}}}
+
+/**
+ * @brief Arena fields.
+ *
+ * Arena takes memory from the address range that is reserved once, so ownership of the block
+ * and its size class are defined by the block address without locks.
+ * Every size class has its own lock and free list, large blocks are pooled by the number of regions.
+ *
+ * Invariant: every block within the free lists is zero filled,
+ * so allocated blocks do not need to be cleared.
+ */
+class VirgilSecureArena::Impl {
+public:
+    struct SizeClass {
+        std::mutex mutex;
+        std::vector<void*> freeBlocks;
+        size_t carvedBlocks = 0;
+    };
+
+    Impl(size_t regionSize, size_t capacity)
+            : regionSize(internal::round_up(
+                    regionSize < internal::kSecureBlockSizeMax ? internal::kSecureBlockSizeMax : regionSize,
+                    internal::system_page_size())),
+              regionsNum(capacity / this->regionSize > 0 ? capacity / this->regionSize : 1),
+              regions(new std::atomic<size_t>[regionsNum]()),
+              base(static_cast<unsigned char*>(internal::reserve_range(this->regionSize * regionsNum))) {
+        if (base == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~Impl() noexcept {
+        for (size_t index = 0; index < nextRegion.load(); ++index) {
+            const size_t descriptor = regions[index].load(std::memory_order_acquire);
+            if (descriptor == internal::kRegionUnused) {
+                continue;
+            }
+            const size_t regionsInBlock = (descriptor & internal::kRegionKindMask) == internal::kRegionLarge ?
+                    descriptor >> internal::kRegionsNumShift : 1;
+            internal::secure_zeroize(base + index * regionSize, regionsInBlock * regionSize);
+            index += regionsInBlock - 1;
+        }
+        internal::release_range(base, regionSize * regionsNum);
+    }
+
+    /**
+     * @brief Commit given number of the next regions, and mark them with the given descriptor.
+     * @throw std::bad_alloc if arena capacity is exhausted or memory can not be committed.
+     */
+    unsigned char* commitRegions(size_t count, size_t descriptor) {
+        size_t index = nextRegion.load();
+        do {
+            if (regionsNum - index < count) {
+                throw std::bad_alloc();
+            }
+        } while (!nextRegion.compare_exchange_weak(index, index + count));
+        unsigned char* region = base + index * regionSize;
+        const size_t size = count * regionSize;
+        bool locked = false;
+        if (!internal::commit_range(region, size, locked)) {
+            throw std::bad_alloc();
+        }
+        regions[index].store(descriptor, std::memory_order_release);
+        reservedBytes += size;
+        systemAllocations += 1;
+        if (locked) {
+            lockedBytes += size;
+        } else {
+            lockFailures += 1;
+        }
+        return region;
+    }
+
+    void addUsed(size_t size) {
+        const size_t used = (usedBytes += size);
+        usedBlocks += 1;
+        allocations += 1;
+        size_t peak = peakUsedBytes.load();
+        while (used > peak && !peakUsedBytes.compare_exchange_weak(peak, used)) {}
+    }
+
+    void removeUsed(size_t size) {
+        usedBytes -= size;
+        usedBlocks -= 1;
+    }
+
+public:
+    const size_t regionSize;
+    const size_t regionsNum;
+    std::unique_ptr<std::atomic<size_t>[]> regions; ///< region descriptors
+    unsigned char* const base;
+    std::atomic<size_t> nextRegion{ 0 };
+    std::array<SizeClass, internal::kSecureBlockClassesNum> sizeClasses;
+    std::mutex largeBlocksMutex;
+    std::map<size_t, std::vector<void*>> largeFreeBlocks; ///< regions number -> free blocks
+    /**
+     * @name Statistics
+     */
+    ///@{
+    std::atomic<size_t> reservedBytes{ 0 };
+    std::atomic<size_t> lockedBytes{ 0 };
+    std::atomic<size_t> usedBytes{ 0 };
+    std::atomic<size_t> peakUsedBytes{ 0 };
+    std::atomic<size_t> usedBlocks{ 0 };
+    std::atomic<size_t> allocations{ 0 };
+    std::atomic<size_t> systemAllocations{ 0 };
+    std::atomic<size_t> lockFailures{ 0 };
+    ///@}
+};
+
+constexpr size_t VirgilSecureArena::kDefaultCapacity;
+
+VirgilSecureArena::VirgilSecureArena(size_t regionSize, size_t capacity)
+        : impl_(std::make_unique<Impl>(regionSize, capacity)) {}
+
+VirgilSecureArena::~VirgilSecureArena() noexcept = default;
+
+VirgilSecureArena& VirgilSecureArena::defaultArena() {
+    static VirgilSecureArena* arena = new VirgilSecureArena();
+    return *arena;
+}
+
+void* VirgilSecureArena::allocate(size_t size) {
+    if (size > internal::kSecureBlockSizeMax) {
+        const size_t regionsInBlock = (size - 1) / impl_->regionSize + 1;
+        if (regionsInBlock > impl_->regionsNum) {
+            throw std::bad_alloc();
+        }
+        const size_t blockSize = regionsInBlock * impl_->regionSize;
+        void* block = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(impl_->largeBlocksMutex);
+            auto freeBlocks = impl_->largeFreeBlocks.find(regionsInBlock);
+            if (freeBlocks != impl_->largeFreeBlocks.end() && !freeBlocks->second.empty()) {
+                block = freeBlocks->second.back();
+                freeBlocks->second.pop_back();
+            }
+        }
+        if (block == nullptr) {
+            block = impl_->commitRegions(
+                    regionsInBlock, (regionsInBlock << internal::kRegionsNumShift) | internal::kRegionLarge);
+        }
+        impl_->addUsed(blockSize);
+        return block;
+    }
+
+    const size_t sizeClassIndex = internal::block_class(size);
+    const size_t blockSize = internal::kSecureBlockSizeMin << sizeClassIndex;
+    auto& sizeClass = impl_->sizeClasses[sizeClassIndex];
+    void* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (sizeClass.freeBlocks.empty()) {
+            const size_t blocksNum = impl_->regionSize / blockSize;
+            sizeClass.freeBlocks.reserve(sizeClass.carvedBlocks + blocksNum);
+            auto region = impl_->commitRegions(1, sizeClassIndex + 1);
+            sizeClass.carvedBlocks += blocksNum;
+            for (size_t i = blocksNum; i > 0; --i) {
+                sizeClass.freeBlocks.push_back(region + (i - 1) * blockSize);
+            }
+        }
+        block = sizeClass.freeBlocks.back();
+        sizeClass.freeBlocks.pop_back();
+    }
+    impl_->addUsed(blockSize);
+    return block;
+}
+
+bool VirgilSecureArena::deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return true;
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto base = reinterpret_cast<std::uintptr_t>(impl_->base);
+    if (address < base || address - base >= impl_->regionsNum * impl_->regionSize) {
+        return false;
+    }
+    const size_t offset = address - base;
+    const size_t regionOffset = offset % impl_->regionSize;
+    const size_t descriptor = impl_->regions[offset / impl_->regionSize].load(std::memory_order_acquire);
+    const size_t kind = descriptor & internal::kRegionKindMask;
+    if (kind == internal::kRegionUnused) {
+        return false;
+    }
+
+    if (kind == internal::kRegionLarge) {
+        if (regionOffset != 0) {
+            return false;
+        }
+        const size_t regionsInBlock = descriptor >> internal::kRegionsNumShift;
+        const size_t blockSize = regionsInBlock * impl_->regionSize;
+        internal::secure_zeroize(ptr, blockSize);
+        try {
+            std::lock_guard<std::mutex> lock(impl_->largeBlocksMutex);
+            impl_->largeFreeBlocks[regionsInBlock].push_back(ptr);
+        } catch (...) {
+            // Block is zeroized, but can not be pooled, so it is kept until arena is destroyed.
+        }
+        impl_->removeUsed(blockSize);
+        return true;
+    }
+
+    const size_t sizeClassIndex = kind - 1;
+    const size_t blockSize = internal::kSecureBlockSizeMin << sizeClassIndex;
+    if (regionOffset % blockSize != 0) {
+        return false;
+    }
+    internal::secure_zeroize(ptr, blockSize);
+    {
+        auto& sizeClass = impl_->sizeClasses[sizeClassIndex];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        // Free list capacity covers all carved blocks of the class, so push_back does not throw.
+        sizeClass.freeBlocks.push_back(ptr);
+    }
+    impl_->removeUsed(blockSize);
+    return true;
+}
+
+VirgilSecureArena::Stats VirgilSecureArena::stats() const {
+    Stats stats;
+    stats.reservedBytes = impl_->reservedBytes;
+    stats.lockedBytes = impl_->lockedBytes;
+    stats.usedBytes = impl_->usedBytes;
+    stats.peakUsedBytes = impl_->peakUsedBytes;
+    stats.usedBlocks = impl_->usedBlocks;
+    stats.allocations = impl_->allocations;
+    stats.systemAllocations = impl_->systemAllocations;
+    stats.lockFailures = impl_->lockFailures;
+    return stats;
+}
+
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+
+static void* system_crypto_calloc(size_t num, size_t size) {
+    if (num != 0 && size > (std::numeric_limits<size_t>::max)() / num) {
+        return nullptr;
+    }
+    try {
+        return VirgilSecureArena::defaultArena().allocate(num * size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+static void system_crypto_free(void* ptr) {
+    // Blocks allocated before the arena was installed are returned to the standard allocator.
+    if (!VirgilSecureArena::defaultArena().deallocate(ptr)) {
+        std::free(ptr);
+    }
+}
+
+void VirgilSecureArena::installSystemCryptoAllocator() {
+    mbedtls_platform_set_calloc_free(system_crypto_calloc, system_crypto_free);
+}
+
+#else
+
+void VirgilSecureArena::installSystemCryptoAllocator() {
+    throw make_error(VirgilCryptoError::UnsupportedAlgorithm,
+            "Underlying crypto library was built without MBEDTLS_PLATFORM_MEMORY.");
+}
+
+#endif
@@ -46,6 +46,7 @@ using virgil::crypto::VirgilSeqCipher;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilPrivateKeyHandle;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 using virgil::crypto::make_error;
@@ -68,6 +69,13 @@ void VirgilSeqCipher::startDecryptionWithKey(
 }
 
 
+void VirgilSeqCipher::startDecryptionWithKey(
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    initDecryptionWithKey(recipientId, privateKey);
+}
+
+
 void VirgilSeqCipher::startDecryptionWithPassword(const VirgilByteArray& pwd) {
     initDecryptionWithPassword(pwd);
 }
@@ -99,6 +107,32 @@ VirgilByteArray VirgilSeqCipher::process(const VirgilByteArray& data) {
 }
 
 
+size_t VirgilSeqCipher::process(const unsigned char* data, size_t dataLen, unsigned char* output, size_t outputLen) {
+
+    if (!isInited()) {
+        throw make_error(VirgilCryptoError::InvalidState,
+            "VirgilSeqCipher::process() can not be called before any 'start' function is called.");
+    }
+
+    auto disposer = ScopeGuardOnException([this]() {
+        clear();
+    });
+
+    if (isReadyForEncryption() || isReadyForDecryption()) {
+        return getSymmetricCipher().update(data, dataLen, output, outputLen);
+
+    } else {
+        VirgilByteArray payload = filterAndSetupContentInfo(VirgilByteArray(data, data + dataLen), false);
+
+        if (isReadyForDecryption()) {
+            return getSymmetricCipher().update(payload.data(), payload.size(), output, outputLen);
+        }
+    }
+
+    return 0;
+}
+
+
 VirgilByteArray VirgilSeqCipher::finish() {
 
     auto disposer = ScopeGuard([this]() {
@@ -120,3 +154,28 @@ VirgilByteArray VirgilSeqCipher::finish() {
 
     throw make_error(VirgilCryptoError::InvalidState, "VirgilSeqCipher::finish()");
 }
+
+
+size_t VirgilSeqCipher::finish(unsigned char* output, size_t outputLen) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    if (isReadyForEncryption()) {
+        return getSymmetricCipher().finish(output, outputLen);
+
+    } else {
+        VirgilByteArray payload = filterAndSetupContentInfo(VirgilByteArray(), true);
+
+        if (isReadyForDecryption()) {
+            size_t writtenBytes = 0;
+            if (!payload.empty()) {
+                writtenBytes = getSymmetricCipher().update(payload.data(), payload.size(), output, outputLen);
+            }
+            return writtenBytes + getSymmetricCipher().finish(output + writtenBytes, outputLen - writtenBytes);
+        }
+    }
+
+    throw make_error(VirgilCryptoError::InvalidState, "VirgilSeqCipher::finish()");
+}
@@ -36,8 +36,13 @@
 
 #include <virgil/crypto/VirgilSeqSigner.h>
 
+#include <virgil/crypto/VirgilCryptoError.h>
+
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilSeqSigner;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
 
 using virgil::crypto::foundation::VirgilHash;
 
@@ -47,15 +52,22 @@ VirgilSeqSigner::VirgilSeqSigner (VirgilHash::Algorithm hashAlgorithm)
 
 
 void VirgilSeqSigner::startSigning() {
+    if (getTreeHashLeafSize() > 0) {
+        throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Tree hashing is not supported by VirgilSeqSigner.");
+    }
     hash_.start();
 }
 
 
 void VirgilSeqSigner::startVerifying(const VirgilByteArray& signature) {
-    unpackedSignature_ = unpackSignature(signature);
+    unpackedSignature_ = readSignature(signature);
+
+    if (unpackedSignature_.treeHashLeafSize > 0) {
+        throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Tree hashing is not supported by VirgilSeqSigner.");
+    }
 
-    if (getHashAlgorithm() != hash_.algorithm()) {
-        hash_ = VirgilHash(getHashAlgorithm());
+    if (unpackedSignature_.hashAlgorithm != hash_.algorithm()) {
+        hash_ = VirgilHash(unpackedSignature_.hashAlgorithm);
     }
 
     hash_.start();
@@ -79,6 +91,18 @@ VirgilByteArray VirgilSeqSigner::sign(const VirgilByteArray& privateKey, const V
 }
 
 
+VirgilByteArray VirgilSeqSigner::sign(const VirgilPrivateKeyHandle& privateKey) {
+    // Get digest
+    const auto digest = hash_.finish();
+
+    // Sign digest
+    const auto signature = signHash(digest, privateKey);
+
+    // Pack signature
+    return packSignature(signature);
+}
+
+
 bool VirgilSeqSigner::verify(const VirgilByteArray& publicKey) {
     // Get digest
     const auto digest = hash_.finish();
@@ -40,16 +40,33 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
+#include "VirgilEd25519BatchVerifier.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
 using virgil::crypto::VirgilSigner;
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::internal::VirgilEd25519BatchVerifier;
+
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
 
-using virgil::crypto::foundation::VirgilHash;
+/**
+ * @name Configuration constants
+ */
+///@{
+static constexpr size_t kBatchVerify_MinSplitSize = 4; ///< Smaller failed batch is verified sign by sign
+///@}
 
 VirgilByteArray VirgilSigner::sign(
         const VirgilByteArray& data, const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword) {
 
     // Calculate data digest
-    const auto digest = VirgilHash(getHashAlgorithm()).hash(data);
+    const auto digest = hashData(data);
 
     // Sign digest
     const auto signature = signHash(digest, privateKey, privateKeyPassword);
@@ -58,15 +75,115 @@ VirgilByteArray VirgilSigner::sign(
     return packSignature(signature);
 }
 
+VirgilByteArray VirgilSigner::sign(const VirgilByteArray& data, const VirgilPrivateKeyHandle& privateKey) const {
+    return packSignature(signHash(hashData(data), privateKey));
+}
+
 bool VirgilSigner::verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilByteArray& publicKey) {
 
     // Unpack signature
-    const auto signature = unpackSignature(sign); // MUST be before getHashAlgorithm()
+    const auto signature = readSignature(sign);
 
     // Calculate data digest
-    VirgilHash hash(getHashAlgorithm());
-    const auto digest = hash.hash(data);
+    const auto digest = hashData(data, signature);
 
     // Verify signature
     return verifyHash(digest, signature, publicKey);
 }
+
+bool VirgilSigner::verify(
+        const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey) const {
+
+    // Unpack signature
+    const auto signature = readSignature(sign);
+
+    // Calculate data digest
+    const auto digest = hashData(data, signature);
+
+    // Verify signature
+    return publicKey.verify(digest, signature.signature, signature.hashType);
+}
+
+std::vector<size_t> VirgilSigner::verifyBatch(const std::vector<BatchItem>& items) {
+    std::vector<size_t> failed;
+
+    // Verify item individually, malformed sign or public key means invalid item
+    auto verifyItem = [this, &items, &failed](size_t index, const VirgilByteArray* digest) {
+        try {
+            const auto signature = readSignature(items[index].sign);
+            const auto verified = digest != nullptr ?
+                    verifyHash(*digest, signature, items[index].publicKey) :
+                    verifyHash(hashData(items[index].data, signature), signature, items[index].publicKey);
+            if (!verified) {
+                failed.push_back(index);
+            }
+        } catch (...) {
+            failed.push_back(index);
+        }
+    };
+
+    // Collect Ed25519 signs, verify others
+    VirgilEd25519BatchVerifier batch;
+    std::vector<size_t> batchIndices;
+    std::vector<VirgilByteArray> batchDigests;
+    std::map<VirgilByteArray, VirgilByteArray> ed25519Keys; // public key -> raw key, empty if not Ed25519
+    VirgilAsymmetricCipher publicContext;
+    for (size_t index = 0; index < items.size(); ++index) {
+        const auto& item = items[index];
+        auto keyIt = ed25519Keys.find(item.publicKey);
+        if (keyIt == ed25519Keys.end()) {
+            VirgilByteArray rawKey;
+            try {
+                publicContext.setPublicKey(item.publicKey);
+                if (publicContext.getKeyType() == VirgilKeyPair::Type::FAST_EC_ED25519) {
+                    rawKey = publicContext.getPublicKeyBits();
+                }
+            } catch (...) {
+                // Will be handled by the individual verification
+            }
+            keyIt = ed25519Keys.emplace(item.publicKey, std::move(rawKey)).first;
+        }
+
+        if (keyIt->second.empty()) {
+            verifyItem(index, nullptr);
+            continue;
+        }
+
+        UnpackedSignature signature;
+        VirgilByteArray digest;
+        try {
+            signature = readSignature(item.sign);
+            digest = hashData(item.data, signature);
+        } catch (...) {
+            failed.push_back(index);
+            continue;
+        }
+        if (batch.add(keyIt->second, signature.signature, digest)) {
+            batchIndices.push_back(index);
+            batchDigests.push_back(std::move(digest));
+        } else {
+            verifyItem(index, &digest);
+        }
+    }
+
+    // Verify Ed25519 signs at once, split failed batch to find invalid signs
+    std::function<void(size_t, size_t)> verifyRange = [&](size_t first, size_t count) {
+        if (batch.verify(first, count)) {
+            return;
+        }
+        if (count < kBatchVerify_MinSplitSize) {
+            for (size_t i = first; i < first + count; ++i) {
+                verifyItem(batchIndices[i], &batchDigests[i]);
+            }
+            return;
+        }
+        verifyRange(first, count / 2);
+        verifyRange(first + count / 2, count - count / 2);
+    };
+    if (batch.size() > 0) {
+        verifyRange(0, batch.size());
+    }
+
+    std::sort(failed.begin(), failed.end());
+    return failed;
+}
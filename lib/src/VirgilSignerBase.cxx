@@ -36,18 +36,42 @@
 
 #include <virgil/crypto/VirgilSignerBase.h>
 
+#include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
+#include "VirgilOID.h"
+#include "VirgilTreeHash.h"
+
+#include <utility>
+
 using virgil::crypto::VirgilSignerBase;
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyCache;
+using virgil::crypto::internal::VirgilTreeHash;
 
 using virgil::crypto::foundation::VirgilHash;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 
+/**
+ * @name Configuration constants
+ */
+///@{
+static constexpr size_t kTreeHashLeafSize_Min = 1024; ///< Smaller leaves make verification too slow
+static constexpr size_t kTreeHashLeafSize_Max = 16 * 1024 * 1024; ///< Up to threadsNum leaves are held in memory
+///@}
+
+static bool is_tree_hash_leaf_size_valid(size_t leafSize) {
+    return leafSize >= kTreeHashLeafSize_Min && leafSize <= kTreeHashLeafSize_Max;
+}
+
 VirgilSignerBase::VirgilSignerBase(VirgilHash::Algorithm hashAlgorithm)
         : hash_(hashAlgorithm), pk_() {
 }
@@ -56,12 +80,95 @@ VirgilHash::Algorithm VirgilSignerBase::getHashAlgorithm() const {
     return hash_.algorithm();
 }
 
+void VirgilSignerBase::setTreeHashLeafSize(size_t leafSize) {
+    if (leafSize != 0 && !is_tree_hash_leaf_size_valid(leafSize)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Tree hash leaf size is out of the allowed range.");
+    }
+    treeHashLeafSize_ = leafSize;
+}
+
+size_t VirgilSignerBase::getTreeHashLeafSize() const {
+    return treeHashLeafSize_;
+}
+
+void VirgilSignerBase::setTreeHashThreadsNum(size_t threadsNum) {
+    treeHashThreadsNum_ = threadsNum;
+}
+
+size_t VirgilSignerBase::getTreeHashThreadsNum() const {
+    return treeHashThreadsNum_;
+}
+
+void VirgilSignerBase::setPublicKeyCache(std::shared_ptr<VirgilPublicKeyCache> publicKeyCache) {
+    publicKeyCache_ = std::move(publicKeyCache);
+}
+
+std::shared_ptr<VirgilPublicKeyCache> VirgilSignerBase::getPublicKeyCache() const {
+    return publicKeyCache_;
+}
+
+/**
+ * @brief Create tree hash, leaf size is checked, because it can be taken from the unpacked signature.
+ */
+static VirgilTreeHash make_tree_hash(VirgilHash::Algorithm hashAlgorithm, size_t leafSize, size_t threadsNum) {
+    if (!is_tree_hash_leaf_size_valid(leafSize)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Tree hash leaf size is out of the allowed range.");
+    }
+    return VirgilTreeHash(hashAlgorithm, leafSize, threadsNum);
+}
+
+static VirgilByteArray hash_data(
+        VirgilDataSource& source, VirgilHash::Algorithm hashAlgorithm, size_t treeHashLeafSize,
+        size_t treeHashThreadsNum) {
+
+    if (treeHashLeafSize > 0) {
+        return make_tree_hash(hashAlgorithm, treeHashLeafSize, treeHashThreadsNum).hash(source);
+    }
+    VirgilHash hash(hashAlgorithm);
+    hash.start();
+    while (source.hasData()) {
+        hash.update(source.read());
+    }
+    return hash.finish();
+}
+
+static VirgilByteArray hash_data(
+        const VirgilByteArray& data, VirgilHash::Algorithm hashAlgorithm, size_t treeHashLeafSize,
+        size_t treeHashThreadsNum) {
+
+    if (treeHashLeafSize > 0) {
+        return make_tree_hash(hashAlgorithm, treeHashLeafSize, treeHashThreadsNum).hash(data);
+    }
+    return VirgilHash(hashAlgorithm).hash(data);
+}
+
+VirgilByteArray VirgilSignerBase::hashData(VirgilDataSource& source) const {
+    return hash_data(source, getHashAlgorithm(), treeHashLeafSize_, treeHashThreadsNum_);
+}
+
+VirgilByteArray VirgilSignerBase::hashData(const VirgilByteArray& data) const {
+    return hash_data(data, getHashAlgorithm(), treeHashLeafSize_, treeHashThreadsNum_);
+}
+
+VirgilByteArray VirgilSignerBase::hashData(VirgilDataSource& source, const UnpackedSignature& signature) const {
+    return hash_data(source, signature.hashAlgorithm, signature.treeHashLeafSize, treeHashThreadsNum_);
+}
+
+VirgilByteArray VirgilSignerBase::hashData(const VirgilByteArray& data, const UnpackedSignature& signature) const {
+    return hash_data(data, signature.hashAlgorithm, signature.treeHashLeafSize, treeHashThreadsNum_);
+}
+
 VirgilByteArray VirgilSignerBase::signHash(
         const VirgilByteArray& digest, const VirgilByteArray& privateKey,
         const VirgilByteArray& privateKeyPassword) {
     return doSignHash(digest, privateKey, privateKeyPassword);
 }
 
+VirgilByteArray VirgilSignerBase::signHash(
+        const VirgilByteArray& digest, const VirgilPrivateKeyHandle& privateKey) const {
+    return privateKey.sign(digest, hash_.type());
+}
+
 bool VirgilSignerBase::verifyHash(
         const VirgilByteArray& digest, const VirgilByteArray& signature, const VirgilByteArray& publicKey) {
     return doVerifyHash(digest, signature, publicKey);
@@ -71,21 +178,61 @@ VirgilByteArray VirgilSignerBase::packSignature(const VirgilByteArray& signature
     VirgilAsn1Writer asn1Writer;
     size_t asn1Len = 0;
     asn1Len += asn1Writer.writeOctetString(signature);
-    asn1Len += VirgilHash(getHashAlgorithm()).asn1Write(asn1Writer);
+    if (treeHashLeafSize_ > 0) {
+        size_t algorithmLen = 0;
+        algorithmLen += asn1Writer.writeInteger(static_cast<int>(treeHashLeafSize_));
+        algorithmLen += VirgilHash(getHashAlgorithm()).asn1Write(asn1Writer);
+        algorithmLen += asn1Writer.writeSequence(algorithmLen);
+        algorithmLen += asn1Writer.writeOID(OID_TO_STD_STRING(OID_VIRGIL_TREE_HASH));
+        algorithmLen += asn1Writer.writeSequence(algorithmLen);
+        asn1Len += algorithmLen;
+    } else {
+        asn1Len += VirgilHash(getHashAlgorithm()).asn1Write(asn1Writer);
+    }
     (void) asn1Writer.writeSequence(asn1Len);
     return asn1Writer.finish();
 }
 
-VirgilByteArray VirgilSignerBase::unpackSignature(const VirgilByteArray& packedSignature) {
+static VirgilByteArray unpack_signature(
+        const VirgilByteArray& packedSignature, VirgilHash& hash, size_t& treeHashLeafSize) {
+
     VirgilAsn1Reader asn1Reader(packedSignature);
     asn1Reader.readSequence();
+    const size_t algorithmPosition = asn1Reader.getPosition();
+    asn1Reader.readSequence();
+    if (compareOID(asn1Reader.readOID(), OID_TO_STD_STRING(OID_VIRGIL_TREE_HASH))) {
+        asn1Reader.readSequence();
+        hash.asn1Read(asn1Reader);
+        const int leafSize = asn1Reader.readInteger();
+        if (leafSize <= 0 || !is_tree_hash_leaf_size_valid(static_cast<size_t>(leafSize))) {
+            throw make_error(VirgilCryptoError::InvalidFormat, "Tree hash leaf size is out of the allowed range.");
+        }
+        treeHashLeafSize = static_cast<size_t>(leafSize);
+    } else {
+        asn1Reader.setPosition(algorithmPosition);
+        hash.asn1Read(asn1Reader);
+        treeHashLeafSize = 0;
+    }
+    return asn1Reader.readOctetString();
+}
+
+VirgilByteArray VirgilSignerBase::unpackSignature(const VirgilByteArray& packedSignature) {
     VirgilHash hash;
-    hash.asn1Read(asn1Reader);
-    auto signature = asn1Reader.readOctetString();
+    size_t treeHashLeafSize = 0;
+    auto signature = unpack_signature(packedSignature, hash, treeHashLeafSize);
     hash_ = std::move(hash);
     return signature;
 }
 
+VirgilSignerBase::UnpackedSignature VirgilSignerBase::readSignature(const VirgilByteArray& packedSignature) const {
+    VirgilHash hash;
+    UnpackedSignature result;
+    result.signature = unpack_signature(packedSignature, hash, result.treeHashLeafSize);
+    result.hashAlgorithm = hash.algorithm();
+    result.hashType = hash.type();
+    return result;
+}
+
 VirgilByteArray VirgilSignerBase::doSignHash(
         const VirgilByteArray& digest, const VirgilByteArray& privateKey,
         const VirgilByteArray& privateKeyPassword) {
@@ -94,9 +241,20 @@ VirgilByteArray VirgilSignerBase::doSignHash(
     return pk_.sign(digest, hash_.type());
 }
 
+bool VirgilSignerBase::verifyHash(
+        const VirgilByteArray& digest, const UnpackedSignature& signature, const VirgilByteArray& publicKey) {
+    if (hash_.algorithm() != signature.hashAlgorithm) {
+        hash_ = VirgilHash(signature.hashAlgorithm);
+    }
+    return doVerifyHash(digest, signature.signature, publicKey);
+}
+
 bool VirgilSignerBase::doVerifyHash(
         const VirgilByteArray& digest, const VirgilByteArray& signature, const VirgilByteArray& publicKey) {
 
+    if (publicKeyCache_) {
+        return publicKeyCache_->get(publicKey).verify(digest, signature, hash_.type());
+    }
     pk_.setPublicKey(publicKey);
     return pk_.verify(digest, signature, hash_.type());
 }
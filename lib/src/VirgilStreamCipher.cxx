@@ -46,6 +46,7 @@ using virgil::crypto::VirgilStreamCipher;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilDataSource;
 using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilPrivateKeyHandle;
 
 using virgil::crypto::foundation::VirgilKDF;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
@@ -84,6 +85,16 @@ void VirgilStreamCipher::decryptWithKey(
 }
 
 
+void VirgilStreamCipher::decryptWithKey(
+        VirgilDataSource& source, VirgilDataSink& sink,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    initDecryptionWithKey(recipientId, privateKey);
+
+    decrypt(source, sink);
+}
+
+
 void VirgilStreamCipher::decryptWithPassword(
         VirgilDataSource& source, VirgilDataSink& sink,
         const VirgilByteArray& pwd) {
@@ -38,21 +38,16 @@
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
 using virgil::crypto::VirgilStreamSigner;
 
-using virgil::crypto::foundation::VirgilHash;
-
 VirgilByteArray VirgilStreamSigner::sign(
         VirgilDataSource& source, const VirgilByteArray& privateKey,
         const VirgilByteArray& privateKeyPassword) {
 
     // Calculate data digest
-    VirgilHash hash(getHashAlgorithm());
-    hash.start();
-    while (source.hasData()) {
-        hash.update(source.read());
-    }
-    const auto digest = hash.finish();
+    const auto digest = hashData(source);
 
     // Sign digest
     const auto signature = signHash(digest, privateKey, privateKeyPassword);
@@ -61,20 +56,32 @@ VirgilByteArray VirgilStreamSigner::sign(
     return packSignature(signature);
 }
 
+VirgilByteArray VirgilStreamSigner::sign(VirgilDataSource& source, const VirgilPrivateKeyHandle& privateKey) const {
+    return packSignature(signHash(hashData(source), privateKey));
+}
+
 bool VirgilStreamSigner::verify(
         VirgilDataSource& source, const VirgilByteArray& sign, const VirgilByteArray& publicKey) {
 
     // Unpack signature
-    const auto signature = unpackSignature(sign); // MUST be before getHashAlgorithm()
+    const auto signature = readSignature(sign);
 
     // Calculate data digest
-    VirgilHash hash(getHashAlgorithm());
-    hash.start();
-    while (source.hasData()) {
-        hash.update(source.read());
-    }
-    const auto digest = hash.finish();
+    const auto digest = hashData(source, signature);
 
     // Verify signature
     return verifyHash(digest, signature, publicKey);
 }
+
+bool VirgilStreamSigner::verify(
+        VirgilDataSource& source, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey) const {
+
+    // Unpack signature
+    const auto signature = readSignature(sign);
+
+    // Calculate data digest
+    const auto digest = hashData(source, signature);
+
+    // Verify signature
+    return publicKey.verify(digest, signature.signature, signature.hashType);
+}
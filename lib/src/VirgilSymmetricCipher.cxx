@@ -47,6 +47,9 @@
 #include "utils.h"
 #include "mbedtls_context.h"
 #include "VirgilTagFilter.h"
+#include "VirgilAesNiGcm.h"
+#include "VirgilChaCha20Poly1305.h"
+#include "VirgilOID.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
@@ -56,6 +59,8 @@ using virgil::crypto::foundation::asn1::VirgilAsn1Compatible;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 using virgil::crypto::foundation::internal::VirgilTagFilter;
+using virgil::crypto::foundation::internal::VirgilAesNiGcm;
+using virgil::crypto::foundation::internal::VirgilChaCha20Poly1305;
 
 
 namespace virgil { namespace crypto { namespace foundation { namespace internal {
@@ -72,20 +77,81 @@ public:
     VirgilByteArray iv;
     VirgilByteArray authData;
     VirgilTagFilter tagFilter;
+    VirgilSymmetricCipher::Padding padding = VirgilSymmetricCipher::Padding::PKCS7;
+    // Number of bytes that were passed to the mbedtls context, but not processed yet.
+    size_t unprocessedLen = 0;
+    // AES-GCM is processed by the accelerated implementation if CPU supports it,
+    // mbedtls context is still used for algorithm info and for other modes.
+    VirgilAesNiGcm aesNiGcm;
+    bool useAesNiGcm = false;
+    // ChaCha20-Poly1305 is not provided by mbedtls, so mbedtls context is left uninitialized for it.
+    VirgilChaCha20Poly1305 chachaPoly;
+    bool isChaChaPoly = false;
+    mbedtls_operation_t chachaPolyOperation = MBEDTLS_OPERATION_NONE;
+
+    void setup(const char* name) {
+        if (std::to_string(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305) == name) {
+            isChaChaPoly = true;
+        } else {
+            cipher_ctx.setup(name);
+        }
+    }
+
+    void setupChaChaPoly(const VirgilByteArray& key, mbedtls_operation_t operation) {
+        if (!chachaPoly.setKey(key.data(), key.size())) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Bad key for symmetric cipher.");
+        }
+        chachaPolyOperation = operation;
+    }
+
+    mbedtls_operation_t operation() const {
+        return isChaChaPoly ? chachaPolyOperation : mbedtls_cipher_get_operation(cipher_ctx.get());
+    }
+
+    void setupAesNiGcm(const VirgilByteArray& key) {
+        const auto type = mbedtls_cipher_get_type(cipher_ctx.get());
+        useAesNiGcm = (type == MBEDTLS_CIPHER_AES_128_GCM || type == MBEDTLS_CIPHER_AES_256_GCM) &&
+                aesNiGcm.setKey(key.data(), key.size() * 8);
+    }
+
+    bool checkAesNiGcmTag(const VirgilByteArray& tag) {
+        unsigned char expectedTag[16];
+        if (tag.size() != sizeof(expectedTag) || !aesNiGcm.finish(expectedTag, sizeof(expectedTag))) {
+            return false;
+        }
+        return isTagEqual(expectedTag, tag);
+    }
+
+    bool checkChaChaPolyTag(const VirgilByteArray& tag) {
+        unsigned char expectedTag[VirgilChaCha20Poly1305::kTagSize];
+        if (tag.size() != sizeof(expectedTag) || !chachaPoly.finish(expectedTag, sizeof(expectedTag))) {
+            return false;
+        }
+        return isTagEqual(expectedTag, tag);
+    }
+
+    static bool isTagEqual(const unsigned char* expectedTag, const VirgilByteArray& tag) {
+        // Constant time comparison.
+        unsigned char diff = 0;
+        for (size_t i = 0; i < tag.size(); ++i) {
+            diff |= expectedTag[i] ^ tag[i];
+        }
+        return diff == 0;
+    }
 };
 
 VirgilSymmetricCipher::VirgilSymmetricCipher() : impl_(std::make_unique<Impl>()) {}
 
 VirgilSymmetricCipher::VirgilSymmetricCipher(Algorithm algorithm) : impl_(std::make_unique<Impl>()) {
-    impl_->cipher_ctx.setup(std::to_string(algorithm).c_str());
+    impl_->setup(std::to_string(algorithm).c_str());
 }
 
 VirgilSymmetricCipher::VirgilSymmetricCipher(const std::string& name) : impl_(std::make_unique<Impl>()) {
-    impl_->cipher_ctx.setup(name.c_str());
+    impl_->setup(name.c_str());
 }
 
 VirgilSymmetricCipher::VirgilSymmetricCipher(const char* name) : impl_(std::make_unique<Impl>()) {
-    impl_->cipher_ctx.setup(name);
+    impl_->setup(name);
 }
 
 VirgilSymmetricCipher::VirgilSymmetricCipher(VirgilSymmetricCipher&&) noexcept = default;
@@ -96,26 +162,38 @@ VirgilSymmetricCipher::~VirgilSymmetricCipher() noexcept = default;
 
 
 bool VirgilSymmetricCipher::isInited() const {
-    return impl_->cipher_ctx.get()->cipher_info != nullptr;
+    return impl_->isChaChaPoly || impl_->cipher_ctx.get()->cipher_info != nullptr;
 }
 
 std::string VirgilSymmetricCipher::name() const {
     checkState();
+    if (impl_->isChaChaPoly) {
+        return std::to_string(Algorithm::CHACHA20_POLY1305);
+    }
     return mbedtls_cipher_get_name(impl_->cipher_ctx.get());
 }
 
 size_t VirgilSymmetricCipher::blockSize() const {
     checkState();
+    if (impl_->isChaChaPoly) {
+        return 1;
+    }
     return mbedtls_cipher_get_block_size(impl_->cipher_ctx.get());
 }
 
 size_t VirgilSymmetricCipher::ivSize() const {
     checkState();
+    if (impl_->isChaChaPoly) {
+        return VirgilChaCha20Poly1305::kNonceSize;
+    }
     return (size_t) mbedtls_cipher_get_iv_size(impl_->cipher_ctx.get());
 }
 
 size_t VirgilSymmetricCipher::keySize() const {
     checkState();
+    if (impl_->isChaChaPoly) {
+        return VirgilChaCha20Poly1305::kKeySize * 8;
+    }
     return (size_t) mbedtls_cipher_get_key_bitlen(impl_->cipher_ctx.get());
 }
 
@@ -125,6 +203,9 @@ size_t VirgilSymmetricCipher::keyLength() const {
 
 size_t VirgilSymmetricCipher::authTagLength() const {
     checkState();
+    if (impl_->isChaChaPoly) {
+        return VirgilChaCha20Poly1305::kTagSize;
+    }
     switch (mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get())) {
         case MBEDTLS_MODE_GCM:
             return 16;
@@ -135,22 +216,31 @@ size_t VirgilSymmetricCipher::authTagLength() const {
 
 bool VirgilSymmetricCipher::isEncryptionMode() const {
     checkState();
-    return mbedtls_cipher_get_operation(impl_->cipher_ctx.get()) == MBEDTLS_ENCRYPT;
+    return impl_->operation() == MBEDTLS_ENCRYPT;
 }
 
 bool VirgilSymmetricCipher::isDecryptionMode() const {
     checkState();
-    return mbedtls_cipher_get_operation(impl_->cipher_ctx.get()) == MBEDTLS_DECRYPT;
+    return impl_->operation() == MBEDTLS_DECRYPT;
 }
 
 bool VirgilSymmetricCipher::isAuthMode() const {
     checkState();
-    return mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_GCM;
+    return impl_->isChaChaPoly || mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_GCM;
 }
 
 bool VirgilSymmetricCipher::isSupportPadding() const {
     checkState();
-    return mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_CBC;
+    return !impl_->isChaChaPoly && mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_CBC;
+}
+
+size_t VirgilSymmetricCipher::defineEncryptedSize(size_t dataSize) const {
+    size_t encryptedSize = dataSize;
+    if (isSupportPadding() && impl_->padding != Padding::None) {
+        // Padding always adds at least one byte, so full block is added to the aligned data.
+        encryptedSize = (dataSize / blockSize() + 1) * blockSize();
+    }
+    return encryptedSize + authTagLength();
 }
 
 VirgilByteArray VirgilSymmetricCipher::iv() const {
@@ -160,6 +250,10 @@ VirgilByteArray VirgilSymmetricCipher::iv() const {
 
 void VirgilSymmetricCipher::setEncryptionKey(const VirgilByteArray& key) {
     checkState();
+    if (impl_->isChaChaPoly) {
+        impl_->setupChaChaPoly(key, MBEDTLS_ENCRYPT);
+        return;
+    }
     system_crypto_handler(
             mbedtls_cipher_setkey(impl_->cipher_ctx.get(), key.data(), key.size() * 8, MBEDTLS_ENCRYPT),
             [](int) {
@@ -167,10 +261,15 @@ void VirgilSymmetricCipher::setEncryptionKey(const VirgilByteArray& key) {
                         make_error(VirgilCryptoError::InvalidArgument, "Bad key for symmetric encryption."));
             }
     );
+    impl_->setupAesNiGcm(key);
 }
 
 void VirgilSymmetricCipher::setDecryptionKey(const VirgilByteArray& key) {
     checkState();
+    if (impl_->isChaChaPoly) {
+        impl_->setupChaChaPoly(key, MBEDTLS_DECRYPT);
+        return;
+    }
     system_crypto_handler(
             mbedtls_cipher_setkey(impl_->cipher_ctx.get(), key.data(), key.size() * 8, MBEDTLS_DECRYPT),
             [](int) {
@@ -178,18 +277,30 @@ void VirgilSymmetricCipher::setDecryptionKey(const VirgilByteArray& key) {
                         make_error(VirgilCryptoError::InvalidArgument, "Bad key for symmetric decryption."));
             }
     );
+    impl_->setupAesNiGcm(key);
 }
 
 void VirgilSymmetricCipher::setPadding(VirgilSymmetricCipher::Padding padding) {
     checkState();
+    if (impl_->isChaChaPoly) {
+        throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Padding is not supported by ChaCha20-Poly1305.");
+    }
     system_crypto_handler(
             mbedtls_cipher_set_padding_mode(impl_->cipher_ctx.get(), internal::convert_padding(padding)),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); }
     );
+    impl_->padding = padding;
 }
 
 void VirgilSymmetricCipher::setIV(const VirgilByteArray& iv) {
     checkState();
+    if (impl_->isChaChaPoly) {
+        if (iv.size() != VirgilChaCha20Poly1305::kNonceSize) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Bad input vector for symmetric cipher.");
+        }
+        impl_->iv = iv;
+        return;
+    }
     system_crypto_handler(
             mbedtls_cipher_set_iv(impl_->cipher_ctx.get(), iv.data(), iv.size()),
             [](int) {
@@ -207,11 +318,34 @@ void VirgilSymmetricCipher::setAuthData(const virgil::crypto::VirgilByteArray& a
 
 void VirgilSymmetricCipher::reset() {
     checkState();
+    if (impl_->isChaChaPoly) {
+        const bool isStarted = impl_->chachaPolyOperation != MBEDTLS_OPERATION_NONE && impl_->chachaPoly.start(
+                impl_->iv.data(), impl_->iv.size(), impl_->authData.data(), impl_->authData.size(),
+                isEncryptionMode());
+        if (!isStarted) {
+            throw make_error(VirgilCryptoError::InvalidState, "Key or input vector for symmetric cipher is not set.");
+        }
+        if (isDecryptionMode()) {
+            impl_->tagFilter.reset(authTagLength());
+        }
+        return;
+    }
     system_crypto_handler(
             mbedtls_cipher_reset(impl_->cipher_ctx.get()),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
-    if (mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_GCM) {
+    impl_->unprocessedLen = 0;
+    if (impl_->useAesNiGcm) {
+        const bool isStarted = impl_->aesNiGcm.start(
+                impl_->iv.data(), impl_->iv.size(), impl_->authData.data(), impl_->authData.size(),
+                isEncryptionMode());
+        if (!isStarted) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Bad input vector for symmetric cipher.");
+        }
+        if (isDecryptionMode()) {
+            impl_->tagFilter.reset(blockSize());
+        }
+    } else if (mbedtls_cipher_get_cipher_mode(impl_->cipher_ctx.get()) == MBEDTLS_MODE_GCM) {
         system_crypto_handler(
                 mbedtls_cipher_update_ad(impl_->cipher_ctx.get(), impl_->authData.data(), impl_->authData.size()),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidArgument)); }
@@ -226,9 +360,15 @@ void VirgilSymmetricCipher::reset() {
 void VirgilSymmetricCipher::clear() {
     auto cipher_type = mbedtls_cipher_get_type(impl_->cipher_ctx.get());
     impl_->cipher_ctx.clear();
+    impl_->aesNiGcm.clear();
+    impl_->useAesNiGcm = false;
+    impl_->chachaPoly.clear();
+    impl_->chachaPolyOperation = MBEDTLS_OPERATION_NONE;
     impl_->iv.clear();
     impl_->authData.clear();
     impl_->tagFilter.reset(0);
+    impl_->padding = Padding::PKCS7;
+    impl_->unprocessedLen = 0;
     // Restore algorithm type
     if (cipher_type != MBEDTLS_CIPHER_NONE) {
         impl_->cipher_ctx.setup(cipher_type);
@@ -250,59 +390,122 @@ VirgilByteArray VirgilSymmetricCipher::crypt(const VirgilByteArray& input, const
 }
 
 VirgilByteArray VirgilSymmetricCipher::update(const VirgilByteArray& input) {
+    VirgilByteArray result(input.size() + blockSize());
+    size_t writtenBytes = update(input.data(), input.size(), result.data(), result.size());
+    result.resize(writtenBytes);
+    return result;
+}
+
+size_t VirgilSymmetricCipher::update(
+        const unsigned char* input, size_t inputLen, unsigned char* output, size_t outputLen) {
     checkState();
-    size_t writtenBytes = 0;
-    size_t bufLen = input.size() + this->blockSize();
-    VirgilByteArray result(bufLen);
+    size_t requiredOutputLen = inputLen;
+    if (isSupportPadding()) {
+        // Only full blocks are processed, the rest is kept within the context until the next call.
+        const size_t processedLen = impl_->unprocessedLen + inputLen;
+        requiredOutputLen = processedLen - processedLen % blockSize();
+    }
+    if (outputLen < requiredOutputLen) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output buffer is too small for symmetric cipher update.");
+    }
 
+    const unsigned char* data = input;
+    size_t dataLen = inputLen;
     if (isDecryptionMode() && isAuthMode()) {
-        impl_->tagFilter.process(input);
-        if (impl_->tagFilter.hasData()) {
-            VirgilByteArray data = impl_->tagFilter.popData();
-            system_crypto_handler(
-                    mbedtls_cipher_update(impl_->cipher_ctx.get(), data.data(), data.size(), result.data(),
-                            &writtenBytes),
-                    [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
-            );
+        // Decrypt filtered data in place, tag is held by the filter until finish().
+        data = output;
+        dataLen = impl_->tagFilter.process(input, inputLen, output);
+        if (dataLen == 0) {
+            return 0;
         }
-    } else {
-        system_crypto_handler(
-                mbedtls_cipher_update(impl_->cipher_ctx.get(), input.data(), input.size(), result.data(),
-                        &writtenBytes),
-                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
-        );
     }
 
+    if (impl_->useAesNiGcm) {
+        if (!impl_->aesNiGcm.update(data, dataLen, output)) {
+            throw make_error(VirgilCryptoError::InvalidState, "Data is too long for symmetric cipher.");
+        }
+        return dataLen;
+    }
+
+    if (impl_->isChaChaPoly) {
+        if (!impl_->chachaPoly.update(data, dataLen, output)) {
+            throw make_error(VirgilCryptoError::InvalidState, "Data is too long for symmetric cipher.");
+        }
+        return dataLen;
+    }
+
+    size_t writtenBytes = 0;
+    system_crypto_handler(
+            mbedtls_cipher_update(impl_->cipher_ctx.get(), data, dataLen, output, &writtenBytes),
+            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
+    );
+    // Every byte that was not written is kept within the context.
+    impl_->unprocessedLen = impl_->unprocessedLen + dataLen - writtenBytes;
+    return writtenBytes;
+}
+
+VirgilByteArray VirgilSymmetricCipher::finish() {
+    VirgilByteArray result(blockSize() + authTagLength());
+    size_t writtenBytes = finish(result.data(), result.size());
     result.resize(writtenBytes);
     return result;
 }
 
-VirgilByteArray VirgilSymmetricCipher::finish() {
+size_t VirgilSymmetricCipher::finish(unsigned char* output, size_t outputLen) {
     checkState();
+    const size_t requiredOutputLen = (isSupportPadding() ? blockSize() : 0) +
+            (isAuthMode() && isEncryptionMode() ? authTagLength() : 0);
+    if (outputLen < requiredOutputLen) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output buffer is too small for symmetric cipher finish.");
+    }
+
+    if (impl_->useAesNiGcm) {
+        if (isEncryptionMode()) {
+            impl_->aesNiGcm.finish(output, authTagLength());
+            return authTagLength();
+        }
+        if (!impl_->checkAesNiGcmTag(impl_->tagFilter.tag())) {
+            throw make_error(VirgilCryptoError::InvalidAuth);
+        }
+        return 0;
+    }
+
+    if (impl_->isChaChaPoly) {
+        if (isEncryptionMode()) {
+            impl_->chachaPoly.finish(output, authTagLength());
+            return authTagLength();
+        }
+        if (!impl_->checkChaChaPolyTag(impl_->tagFilter.tag())) {
+            throw make_error(VirgilCryptoError::InvalidAuth);
+        }
+        return 0;
+    }
+
     size_t writtenBytes = 0;
-    VirgilByteArray result(blockSize());
     system_crypto_handler(
-            mbedtls_cipher_finish(impl_->cipher_ctx.get(), result.data(), &writtenBytes),
+            mbedtls_cipher_finish(impl_->cipher_ctx.get(), output, &writtenBytes),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
-    result.resize(writtenBytes);
+    impl_->unprocessedLen = 0;
     if (isAuthMode()) {
         if (isEncryptionMode()) {
-            VirgilByteArray tag(authTagLength());
             system_crypto_handler(
-                    mbedtls_cipher_write_tag(impl_->cipher_ctx.get(), tag.data(), tag.size()),
+                    mbedtls_cipher_write_tag(impl_->cipher_ctx.get(), output + writtenBytes, authTagLength()),
                     [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
             );
-            result.insert(result.end(), tag.begin(), tag.end());
+            writtenBytes += authTagLength();
         } else if (isDecryptionMode()) {
-            VirgilByteArray tag = impl_->tagFilter.tag();
+            const VirgilByteArray& tag = impl_->tagFilter.tag();
+            if (tag.size() != authTagLength()) {
+                throw make_error(VirgilCryptoError::InvalidAuth);
+            }
             system_crypto_handler(
                     mbedtls_cipher_check_tag(impl_->cipher_ctx.get(), tag.data(), tag.size()),
                     [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidAuth)); }
             );
         }
     }
-    return result;
+    return writtenBytes;
 }
 
 void VirgilSymmetricCipher::checkState() const {
@@ -315,10 +518,15 @@ size_t VirgilSymmetricCipher::asn1Write(VirgilAsn1Writer& asn1Writer, size_t chi
     checkState();
     const char* oid = 0;
     size_t oidLen;
-    system_crypto_handler(
-            mbedtls_oid_get_oid_by_cipher_alg(mbedtls_cipher_get_type(impl_->cipher_ctx.get()), &oid, &oidLen),
-            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); }
-    );
+    if (impl_->isChaChaPoly) {
+        oid = OID_PKCS9_CHACHA20_POLY1305;
+        oidLen = MBEDTLS_OID_SIZE(OID_PKCS9_CHACHA20_POLY1305);
+    } else {
+        system_crypto_handler(
+                mbedtls_oid_get_oid_by_cipher_alg(mbedtls_cipher_get_type(impl_->cipher_ctx.get()), &oid, &oidLen),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); }
+        );
+    }
     size_t len = 0;
     len += asn1Writer.writeOctetString(impl_->iv);
     len += asn1Writer.writeOID(std::string(oid, oidLen));
@@ -329,7 +537,16 @@ size_t VirgilSymmetricCipher::asn1Write(VirgilAsn1Writer& asn1Writer, size_t chi
 void VirgilSymmetricCipher::asn1Read(VirgilAsn1Reader& asn1Reader) {
     asn1Reader.readSequence();
 
-    VirgilByteArray oid = VirgilByteArrayUtils::stringToBytes(asn1Reader.readOID());
+    const std::string oidString = asn1Reader.readOID();
+    if (compareOID(oidString, OID_TO_STD_STRING(OID_PKCS9_CHACHA20_POLY1305))) {
+        clear();
+        impl_->cipher_ctx.clear();
+        impl_->isChaChaPoly = true;
+        setIV(asn1Reader.readOctetString());
+        return;
+    }
+
+    VirgilByteArray oid = VirgilByteArrayUtils::stringToBytes(oidString);
     mbedtls_asn1_buf oidAsn1Buf;
     oidAsn1Buf.p = oid.data();
     oidAsn1Buf.len = oid.size();
@@ -341,6 +558,7 @@ void VirgilSymmetricCipher::asn1Read(VirgilAsn1Reader& asn1Reader) {
     );
 
     clear();
+    impl_->isChaChaPoly = false;
     impl_->cipher_ctx.setup(type);
     setIV(asn1Reader.readOctetString());
 }
@@ -355,6 +573,8 @@ std::string std::to_string(virgil::crypto::foundation::VirgilSymmetricCipher::Al
             return "AES-256-CBC";
         case VirgilSymmetricCipher::Algorithm::AES_256_GCM:
             return "AES-256-GCM";
+        case VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305:
+            return "CHACHA20-POLY1305";
     }
 }
 
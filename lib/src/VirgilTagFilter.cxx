@@ -36,6 +36,8 @@
 
 #include "VirgilTagFilter.h"
 
+#include <algorithm>
+
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::foundation::internal::VirgilTagFilter;
 
@@ -47,18 +49,34 @@ void VirgilTagFilter::reset(size_t tagLen) {
     tagLen_ = tagLen;
     data_.clear();
     tag_.clear();
+    tag_.reserve(tagLen_);
 }
 
 void VirgilTagFilter::process(const VirgilByteArray& data) {
-    tag_.insert(tag_.end(), data.begin(), data.end());
+    const size_t offset = data_.size();
+    data_.resize(offset + data.size());
+    const size_t writtenBytes = process(data.data(), data.size(), data_.data() + offset);
+    data_.resize(offset + writtenBytes);
+}
 
-    std::ptrdiff_t tagSurplusLen = tag_.size() - tagLen_;
-    if (tagSurplusLen > 0) {
-        auto tagSurplusBegin = tag_.begin();
-        auto tagSurplusEnd = tagSurplusBegin + tagSurplusLen;
-        data_.insert(data_.end(), tagSurplusBegin, tagSurplusEnd);
-        tag_.erase(tagSurplusBegin, tagSurplusEnd);
+size_t VirgilTagFilter::process(const unsigned char* data, size_t dataLen, unsigned char* out) {
+    const size_t totalLen = tag_.size() + dataLen;
+    if (totalLen <= tagLen_) {
+        tag_.insert(tag_.end(), data, data + dataLen);
+        return 0;
     }
+
+    const size_t releaseLen = totalLen - tagLen_;
+    const size_t releaseFromTagLen = std::min(releaseLen, tag_.size());
+    const size_t releaseFromDataLen = releaseLen - releaseFromTagLen;
+
+    out = std::copy(tag_.begin(), tag_.begin() + releaseFromTagLen, out);
+    std::copy(data, data + releaseFromDataLen, out);
+
+    tag_.erase(tag_.begin(), tag_.begin() + releaseFromTagLen);
+    tag_.insert(tag_.end(), data + releaseFromDataLen, data + dataLen);
+
+    return releaseLen;
 }
 
 bool VirgilTagFilter::hasData() const {
@@ -71,6 +89,6 @@ VirgilByteArray VirgilTagFilter::popData() {
     return result;
 }
 
-VirgilByteArray VirgilTagFilter::tag() const {
+const VirgilByteArray& VirgilTagFilter::tag() const {
     return tag_;
 }
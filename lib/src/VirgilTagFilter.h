@@ -67,6 +67,19 @@ public:
      */
     void process(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Filter given data and write bytes that are not part of the tag to the output.
+     *
+     * Bytes held from the previous calls are written first, last tagLen bytes are held back.
+     *
+     * @param data - data to be filtered.
+     * @param dataLen - data length.
+     * @param out - output buffer, MUST have room for dataLen bytes and MUST NOT overlap with data.
+     * @return Number of bytes written to the output.
+     * @note This method does not allocate memory after reset().
+     */
+    size_t process(const unsigned char* data, size_t dataLen, unsigned char* out);
+
     /**
      * @brief Return if data exist after filtration.
      */
@@ -82,7 +95,7 @@ public:
      * @note MUST be called after method finish().
      * @return Tag or empty byte array.
      */
-    virgil::crypto::VirgilByteArray tag() const;
+    const virgil::crypto::VirgilByteArray& tag() const;
 
 private:
     size_t tagLen_;
@@ -0,0 +1,214 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilTreeHash.h"
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::make_error;
+using virgil::crypto::internal::VirgilTreeHash;
+using virgil::crypto::foundation::VirgilHash;
+
+/**
+ * @name Configuration constants
+ */
+///@{
+static constexpr unsigned char kTreeHashPrefix_Leaf = 0x00;
+static constexpr unsigned char kTreeHashPrefix_Node = 0x01;
+///@}
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Read at most leafSize bytes to the leaf, bytes left from the previous source read are taken first.
+ */
+static void read_leaf(
+        VirgilDataSource& source, VirgilByteArray& pending, size_t& pendingOffset, size_t leafSize,
+        VirgilByteArray& leaf) {
+
+    leaf.clear();
+    while (leaf.size() < leafSize) {
+        if (pendingOffset == pending.size()) {
+            if (!source.hasData()) {
+                return;
+            }
+            pending = source.read();
+            pendingOffset = 0;
+            continue;
+        }
+        const size_t size = std::min(leafSize - leaf.size(), pending.size() - pendingOffset);
+        leaf.insert(leaf.end(), pending.begin() + pendingOffset, pending.begin() + pendingOffset + size);
+        pendingOffset += size;
+    }
+}
+
+/**
+ * @brief Provide in-memory data by leaves.
+ */
+class leaf_data_source : public VirgilDataSource {
+public:
+    leaf_data_source(const VirgilByteArray& data, size_t leafSize) : data_(data), leafSize_(leafSize) {}
+
+    bool hasData() override {
+        return offset_ < data_.size();
+    }
+
+    VirgilByteArray read() override {
+        const size_t size = std::min(leafSize_, data_.size() - offset_);
+        VirgilByteArray leaf(data_.begin() + offset_, data_.begin() + offset_ + size);
+        offset_ += size;
+        return leaf;
+    }
+
+private:
+    const VirgilByteArray& data_;
+    const size_t leafSize_;
+    size_t offset_ = 0;
+};
+
+/**
+ * @brief Combine node hashes as soon as they arrive, so only one node per tree level is kept.
+ *
+ * Nodes of the same level are combined immediately, the rest are combined from right to left
+ * when all leaves are added, it gives the same root as combining the tree level by level,
+ * where the last node of the level without a pair is promoted to the next level.
+ */
+class node_stack {
+public:
+    explicit node_stack(VirgilHash& hash) : hash_(hash), nodePrefix_(1, kTreeHashPrefix_Node) {}
+
+    void push(VirgilByteArray leafHash) {
+        nodes_.emplace_back(0, std::move(leafHash));
+        while (nodes_.size() > 1 && nodes_[nodes_.size() - 2].first == nodes_.back().first) {
+            combine_last();
+        }
+    }
+
+    VirgilByteArray root() {
+        while (nodes_.size() > 1) {
+            combine_last();
+        }
+        return std::move(nodes_.front().second);
+    }
+
+private:
+    void combine_last() {
+        auto right = std::move(nodes_.back());
+        nodes_.pop_back();
+        auto& left = nodes_.back();
+        hash_.start();
+        hash_.update(nodePrefix_);
+        hash_.update(left.second);
+        hash_.update(right.second);
+        left.first += 1;
+        left.second = hash_.finish();
+    }
+
+private:
+    VirgilHash& hash_;
+    const VirgilByteArray nodePrefix_;
+    std::vector<std::pair<size_t, VirgilByteArray>> nodes_; // (level, hash)
+};
+
+}}}
+
+VirgilTreeHash::VirgilTreeHash(VirgilHash::Algorithm hashAlgorithm, size_t leafSize, size_t threadsNum)
+        : hashAlgorithm_(hashAlgorithm), leafSize_(leafSize), threadsNum_(threadsNum) {
+    if (leafSize_ == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Tree hash leaf size must be positive.");
+    }
+}
+
+VirgilByteArray VirgilTreeHash::hash(VirgilDataSource& source) const {
+    const size_t batchSize = std::max(threadsNum_, size_t(1));
+    const VirgilByteArray leafPrefix(1, kTreeHashPrefix_Leaf);
+
+    // Each leaf of the batch is hashed by its own hash object.
+    std::vector<VirgilHash> hashes(batchSize, VirgilHash(hashAlgorithm_));
+    std::vector<VirgilByteArray> leaves(batchSize);
+    std::vector<VirgilByteArray> leafHashes(batchSize);
+    internal::node_stack nodes(hashes.front());
+    bool hasLeaves = false;
+
+    VirgilByteArray pending;
+    size_t pendingOffset = 0;
+    bool isEnd = false;
+    while (!isEnd) {
+        // Collect the batch of leaves, only the last leaf can be shorter, and it is empty only for empty data.
+        size_t leavesNum = 0;
+        while (leavesNum < batchSize) {
+            auto& leaf = leaves[leavesNum];
+            internal::read_leaf(source, pending, pendingOffset, leafSize_, leaf);
+            if (leaf.size() < leafSize_) {
+                isEnd = true;
+                if (!leaf.empty() || (!hasLeaves && leavesNum == 0)) {
+                    ++leavesNum;
+                }
+                break;
+            }
+            ++leavesNum;
+        }
+
+        // Hash leaves
+        internal::parallel_for(leavesNum, batchSize, [&](size_t index) {
+            auto& hash = hashes[index];
+            hash.start();
+            hash.update(leafPrefix);
+            hash.update(leaves[index]);
+            leafHashes[index] = hash.finish();
+        });
+        for (size_t index = 0; index < leavesNum; ++index) {
+            nodes.push(std::move(leafHashes[index]));
+        }
+        hasLeaves = hasLeaves || leavesNum > 0;
+    }
+
+    return nodes.root();
+}
+
+VirgilByteArray VirgilTreeHash::hash(const VirgilByteArray& data) const {
+    internal::leaf_data_source source(data, leafSize_);
+    return hash(source);
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_TREE_HASH_H
+#define VIRGIL_CRYPTO_TREE_HASH_H
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilDataSource.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Merkle tree hash of the data split to the leaves of the fixed size.
+ *
+ * @code
+ *     leafHash = Hash(0x00 || leaf)
+ *     nodeHash = Hash(0x01 || leftChildHash || rightChildHash)
+ * @endcode
+ *
+ * Leaves are hashed concurrently, the last node of the level without a pair is promoted to the next level.
+ * Nodes are combined as soon as leaf hashes arrive, so memory usage does not depend on the data size.
+ * Empty data is hashed as a single empty leaf.
+ */
+class VirgilTreeHash {
+public:
+    /**
+     * @param hashAlgorithm - hash algorithm of the leaves and nodes.
+     * @param leafSize - size of the leaf in bytes, MUST be positive.
+     * @param threadsNum - maximum number of threads used to hash leaves, 0 or 1 means sequential processing.
+     */
+    VirgilTreeHash(foundation::VirgilHash::Algorithm hashAlgorithm, size_t leafSize, size_t threadsNum);
+
+    /**
+     * @brief Return tree root hash of the data provided by the source.
+     *
+     * At most threadsNum leaves are read from the source at once.
+     */
+    VirgilByteArray hash(VirgilDataSource& source) const;
+
+    /**
+     * @brief Return tree root hash of the given data.
+     */
+    VirgilByteArray hash(const VirgilByteArray& data) const;
+
+private:
+    foundation::VirgilHash::Algorithm hashAlgorithm_;
+    size_t leafSize_;
+    size_t threadsNum_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_TREE_HASH_H */
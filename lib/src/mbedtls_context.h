@@ -37,7 +37,11 @@
 #ifndef VIRGIL_CRYPTO_MBEDTLS_CONTEXT_H
 #define VIRGIL_CRYPTO_MBEDTLS_CONTEXT_H
 
+#include <mbedtls/platform.h>
+
+#include <cstddef>
 #include <memory>
+#include <new>
 #include "utils.h"
 
 namespace virgil { namespace crypto { namespace foundation { namespace internal {
@@ -45,25 +49,114 @@ namespace virgil { namespace crypto { namespace foundation { namespace internal
 template<typename T>
 class mbedtls_context_policy;
 
+/**
+ * @brief Per-thread cache of the context storage.
+ *
+ * Contexts are created and destroyed for every hash, cipher and key operation,
+ * so released storage is kept in a small per-thread free list and handed out again
+ * instead of going to the heap allocator.
+ * Storage itself is allocated with mbedtls_calloc(), so it is served by the same allocator
+ * as the memory that mbedtls allocates internally.
+ *
+ * @note Storage is returned to the cache only after Policy::free_ctx() was called,
+ *       so it never holds key material.
+ */
+template<typename T>
+class mbedtls_context_storage {
+public:
+    static constexpr size_t kCapacity = 8;
+
+    struct deleter {
+        void operator()(T* ctx) const noexcept {
+            release(ctx);
+        }
+    };
+
+    static T* acquire() {
+        cache_type& cache = local_cache();
+        if (cache.size > 0) {
+            return cache.slots[--cache.size];
+        }
+        void* storage = mbedtls_calloc(1, sizeof(T));
+        if (storage == nullptr) {
+            throw std::bad_alloc();
+        }
+        return new(storage) T();
+    }
+
+    static void release(T* ctx) noexcept {
+        if (ctx == nullptr) {
+            return;
+        }
+        cache_type& cache = local_cache();
+        if (!cache.closed && cache.size < kCapacity) {
+            cache.slots[cache.size++] = ctx;
+        } else {
+            destroy(ctx);
+        }
+    }
+
+private:
+    struct cache_type {
+        T* slots[kCapacity];
+        size_t size;
+        bool closed;
+    };
+
+    struct cache_guard {
+        ~cache_guard() noexcept {
+            cache_type& cache = raw_cache();
+            cache.closed = true;
+            while (cache.size > 0) {
+                destroy(cache.slots[--cache.size]);
+            }
+        }
+    };
+
+    static void destroy(T* ctx) noexcept {
+        ctx->~T();
+        mbedtls_free(ctx);
+    }
+
+    // Trivially destructible, so it stays accessible while other thread locals are destroyed.
+    // Cache is per-thread regardless of VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, because callers can use threads anyway.
+    static cache_type& raw_cache() noexcept {
+        static thread_local cache_type cache;
+        return cache;
+    }
+
+    static cache_type& local_cache() noexcept {
+        static thread_local cache_guard guard;
+        (void) guard;
+        return raw_cache();
+    }
+};
+
 template<typename T, typename Policy = mbedtls_context_policy<T>>
 class mbedtls_context {
 public:
-    mbedtls_context() noexcept : ctx_(std::make_unique<T>()) {
+    mbedtls_context() noexcept : ctx_(mbedtls_context_storage<T>::acquire()) {
         Policy::init_ctx(ctx_.get());
     }
 
     template<typename... Args>
-    mbedtls_context(Args&& ...args) : ctx_(std::make_unique<T>()) {
+    mbedtls_context(Args&& ...args) : ctx_(mbedtls_context_storage<T>::acquire()) {
         Policy::init_ctx(ctx_.get(), std::forward(args)...);
     }
 
     ~mbedtls_context() noexcept {
-        Policy::free_ctx(ctx_.get());
+        if (ctx_) {
+            Policy::free_ctx(ctx_.get());
+        }
     }
 
     mbedtls_context<T, Policy>& clear() {
-        Policy::free_ctx(ctx_.get());
-        ctx_ = std::make_unique<T>();
+        // Context is re-initialized in place, so underlying storage is not reallocated.
+        if (ctx_) {
+            Policy::free_ctx(ctx_.get());
+        } else {
+            ctx_.reset(mbedtls_context_storage<T>::acquire());
+        }
         Policy::init_ctx(ctx_.get());
         return *this;
     };
@@ -80,10 +173,19 @@ public:
 public:
     mbedtls_context(mbedtls_context&& rhs) = default;
 
-    mbedtls_context& operator=(mbedtls_context&& rhs) = default;
+    mbedtls_context& operator=(mbedtls_context&& rhs) noexcept {
+        // Replaced context must be freed before its storage goes back to the cache.
+        if (this != &rhs) {
+            if (ctx_) {
+                Policy::free_ctx(ctx_.get());
+            }
+            ctx_ = std::move(rhs.ctx_);
+        }
+        return *this;
+    }
 
 private:
-    std::unique_ptr<T> ctx_;
+    std::unique_ptr<T, typename mbedtls_context_storage<T>::deleter> ctx_;
 };
 
 }}}}
@@ -42,11 +42,14 @@
 #include <mbedtls/ecdh.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/pk.h>
+#include <mbedtls/rsa.h>
 #include <mbedtls/md.h>
 #include <mbedtls/cipher.h>
 
 #include <virgil/crypto/foundation/VirgilSystemCryptoError.h>
 #include "mbedtls_type_utils.h"
+#include "mbedtls_ecp_tables.h"
+#include "VirgilAcceleratedHash.h"
 
 #include <array>
 
@@ -62,6 +65,8 @@ public:
     }
 
     static void free_ctx(context_type* ctx) {
+        // Shared table MUST not be freed with the group
+        pk_detach_shared_ecp_table(ctx);
         mbedtls_pk_free(ctx);
     }
 
@@ -78,6 +83,19 @@ public:
     }
 };
 
+template<>
+class mbedtls_context_policy<mbedtls_rsa_context> {
+    using context_type = mbedtls_rsa_context;
+public:
+    static void init_ctx(context_type* ctx) {
+        mbedtls_rsa_init(ctx, MBEDTLS_RSA_PKCS_V15, 0);
+    }
+
+    static void free_ctx(context_type* ctx) {
+        mbedtls_rsa_free(ctx);
+    }
+};
+
 template<>
 class mbedtls_context_policy<mbedtls_ctr_drbg_context> {
     using context_type = mbedtls_ctr_drbg_context;
@@ -167,7 +185,7 @@ public:
 
     template<typename Type, typename... Args>
     static void setup_ctx(context_type* ctx, Type type, Args ...args) {
-        const info_type* info = mbedtls_md_info_from_type(type);
+        const info_type* info = VirgilAcceleratedHash::mdInfoFromType(type);
         if (info == NULL) {
             throw make_error(VirgilCryptoError::UnsupportedAlgorithm, internal::to_string(type));
         }
@@ -179,7 +197,7 @@ public:
 
     template<typename... Args>
     static void setup_ctx(context_type* ctx, const char* name, Args ...args) {
-        const info_type* info = mbedtls_md_info_from_string(name);
+        const info_type* info = VirgilAcceleratedHash::mdInfoFromString(name);
         if (info == NULL) {
             throw make_error(VirgilCryptoError::UnsupportedAlgorithm, name);
         }
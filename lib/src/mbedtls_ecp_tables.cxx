@@ -0,0 +1,147 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "mbedtls_ecp_tables.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @name Configuration constants
+ */
+///@{
+static constexpr size_t kEcpGroupIdMax = 32; ///< Upper bound of the mbedtls_ecp_group_id values
+///@}
+
+/**
+ * @brief Shared table of the curve, published once and never changed.
+ */
+struct ecp_shared_table {
+    std::atomic<mbedtls_ecp_point*> points;
+    size_t size;
+    bool isBuilt;
+};
+
+static ecp_shared_table g_ecp_tables[kEcpGroupIdMax];
+
+static std::mutex g_ecp_tables_mutex;
+
+static bool is_short_weierstrass(const mbedtls_ecp_group* grp) {
+    // The same check is used by MbedTLS, Montgomery curves do not define y-coordinate of the generator
+    return grp->G.X.p != nullptr && grp->G.Y.p != nullptr;
+}
+
+/**
+ * @brief Build generator table with MbedTLS itself, so table layout matches the one expected by the comb method.
+ */
+static void build_table(mbedtls_ecp_group_id id, ecp_shared_table& table) {
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point R;
+    mbedtls_mpi one;
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&R);
+    mbedtls_mpi_init(&one);
+
+    if (mbedtls_ecp_group_load(&grp, id) == 0 && is_short_weierstrass(&grp) &&
+        mbedtls_mpi_lset(&one, 1) == 0 &&
+        mbedtls_ecp_mul(&grp, &R, &one, &grp.G, nullptr, nullptr) == 0 &&
+        grp.T != nullptr) {
+
+        table.size = grp.T_size;
+        table.points.store(grp.T, std::memory_order_release);
+        grp.T = nullptr;
+        grp.T_size = 0;
+    }
+
+    mbedtls_mpi_free(&one);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_group_free(&grp);
+}
+
+void ecp_group_attach_shared_table(mbedtls_ecp_group* grp) {
+    const size_t index = static_cast<size_t>(grp->id);
+    if (index >= kEcpGroupIdMax || grp->T != nullptr || !is_short_weierstrass(grp)) {
+        return;
+    }
+
+    ecp_shared_table& table = g_ecp_tables[index];
+    mbedtls_ecp_point* points = table.points.load(std::memory_order_acquire);
+    if (points == nullptr) {
+        std::lock_guard<std::mutex> lock(g_ecp_tables_mutex);
+        if (!table.isBuilt) {
+            build_table(grp->id, table);
+            table.isBuilt = true;
+        }
+        points = table.points.load(std::memory_order_acquire);
+    }
+
+    if (points != nullptr) {
+        grp->T = points;
+        grp->T_size = table.size;
+    }
+}
+
+void ecp_group_detach_shared_table(mbedtls_ecp_group* grp) noexcept {
+    const size_t index = static_cast<size_t>(grp->id);
+    if (index >= kEcpGroupIdMax || grp->T == nullptr) {
+        return;
+    }
+    if (grp->T == g_ecp_tables[index].points.load(std::memory_order_acquire)) {
+        grp->T = nullptr;
+        grp->T_size = 0;
+    }
+}
+
+static bool has_ecp_keypair(const mbedtls_pk_context* ctx) {
+    const auto pk_type = mbedtls_pk_get_type(ctx);
+    return pk_type == MBEDTLS_PK_ECKEY || pk_type == MBEDTLS_PK_ECKEY_DH || pk_type == MBEDTLS_PK_ECDSA;
+}
+
+void pk_attach_shared_ecp_table(mbedtls_pk_context* ctx) {
+    if (has_ecp_keypair(ctx)) {
+        ecp_group_attach_shared_table(&mbedtls_pk_ec(*ctx)->grp);
+    }
+}
+
+void pk_detach_shared_ecp_table(mbedtls_pk_context* ctx) noexcept {
+    if (has_ecp_keypair(ctx)) {
+        ecp_group_detach_shared_table(&mbedtls_pk_ec(*ctx)->grp);
+    }
+}
+
+}}}}
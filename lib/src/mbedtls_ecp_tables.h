@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_MBEDTLS_ECP_TABLES_H
+#define VIRGIL_CRYPTO_MBEDTLS_ECP_TABLES_H
+
+#include <mbedtls/ecp.h>
+#include <mbedtls/pk.h>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Process-wide precomputed tables of the curve generators.
+ *
+ * MbedTLS computes comb table of the generator on the first fixed-base multiplication,
+ *     and keeps it within the group until the group is freed,
+ *     so every parsed or generated key spends time to rebuild the same table.
+ * Tables are built once per curve and attached to the groups read-only,
+ *     so key generation, signing and verification use them immediately.
+ *
+ * @note Attached table MUST be detached before the group is freed or reloaded,
+ *     this is done by the mbedtls_context<mbedtls_pk_context> policy.
+ */
+
+/**
+ * @brief Attach shared table to the group of short Weierstrass curve, if group has no table yet.
+ * @note Tables are never freed, because they can be used by the contexts destroyed during process exit.
+ */
+void ecp_group_attach_shared_table(mbedtls_ecp_group* grp);
+
+/**
+ * @brief Detach shared table from the group, if it was attached.
+ */
+void ecp_group_detach_shared_table(mbedtls_ecp_group* grp) noexcept;
+
+/**
+ * @brief Attach shared table to the group of the EC key, other keys are ignored.
+ */
+void pk_attach_shared_ecp_table(mbedtls_pk_context* ctx);
+
+/**
+ * @brief Detach shared table from the group of the EC key, other keys are ignored.
+ */
+void pk_detach_shared_ecp_table(mbedtls_pk_context* ctx) noexcept;
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_MBEDTLS_ECP_TABLES_H */
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_INTERNAL_PARALLEL_H
+#define VIRGIL_CRYPTO_INTERNAL_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Call given function for each index in the range [0, count).
+ *
+ * Indices are distributed dynamically between at most threadsNum threads,
+ * current thread is one of them. The first thrown exception is rethrown in the current thread,
+ * when all started threads are finished. Remaining indices are not processed in this case.
+ *
+ * @param count - number of indices to be processed.
+ * @param threadsNum - maximum number of threads, 0 or 1 means sequential processing.
+ * @param func - function to be called, it MUST be safe to call it concurrently for different indices.
+ *
+ * @note If library is built without VIRGIL_CRYPTO_FEATURE_MULTI_THREAD, processing is always sequential.
+ */
+inline void parallel_for(size_t count, size_t threadsNum, const std::function<void(size_t index)>& func) {
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+    const size_t workersNum = std::min(threadsNum, count);
+    if (workersNum > 1) {
+        std::atomic<size_t> nextIndex(0);
+        std::atomic<bool> isFailed(false);
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+
+        auto worker = [&]() {
+            try {
+                for (size_t index = nextIndex++; index < count && !isFailed; index = nextIndex++) {
+                    func(index);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                isFailed = true;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workersNum - 1);
+        try {
+            for (size_t i = 1; i < workersNum; ++i) {
+                threads.emplace_back(worker);
+            }
+        } catch (...) {
+            // Thread creation failed, so process the rest with threads that were already started.
+        }
+
+        worker();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        return;
+    }
+#else
+    (void) threadsNum;
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+    for (size_t index = 0; index < count; ++index) {
+        func(index);
+    }
+}
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_INTERNAL_PARALLEL_H */
@@ -48,8 +48,8 @@ namespace {
 class VirgilSymmetricCipherWrapper {
 public:
 
-    VirgilSymmetricCipherWrapper()
-            : cipherAlgorithm_(VirgilSymmetricCipher::Algorithm::AES_256_GCM) {}
+    explicit VirgilSymmetricCipherWrapper(VirgilSymmetricCipher::Algorithm cipherAlgorithm)
+            : cipherAlgorithm_(cipherAlgorithm) {}
 
     size_t getKeySize() const {
         VirgilSymmetricCipher cipher(cipherAlgorithm_);
@@ -100,5 +100,9 @@ private:
 }
 
 VirgilOperationCipher VirgilOperationCipher::getDefault() {
-    return VirgilOperationCipher(VirgilSymmetricCipherWrapper());
+    return VirgilOperationCipher(VirgilSymmetricCipherWrapper(VirgilSymmetricCipher::Algorithm::AES_256_GCM));
+}
+
+VirgilOperationCipher VirgilOperationCipher::getChaCha20Poly1305() {
+    return VirgilOperationCipher(VirgilSymmetricCipherWrapper(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305));
 }
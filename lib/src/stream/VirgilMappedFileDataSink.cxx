@@ -0,0 +1,187 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSink.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::stream::VirgilMappedFileDataSink;
+
+static const size_t kCapacityMin = 64 * 1024;
+
+#if !defined(_WIN32)
+/**
+ * @brief Allocate disk blocks for the first size bytes of the file, and extend file if needed.
+ *
+ * Sparse file extension (ftruncate) succeeds even if disk is full,
+ * and then write to the mapping fails with SIGBUS, so space is reserved up front.
+ *
+ * @return 0 on success, or error number.
+ */
+static int reserve_file_space(int fd, size_t size) {
+#if defined(__APPLE__)
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        return errno;
+    }
+    const off_t currentSize = fileStat.st_size;
+    if (static_cast<off_t>(size) > currentSize) {
+        fstore_t store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size) - currentSize, 0 };
+        if (::fcntl(fd, F_PREALLOCATE, &store) == -1) {
+            return errno;
+        }
+    }
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+#endif
+}
+#endif
+
+VirgilMappedFileDataSink::VirgilMappedFileDataSink(const std::string& path, size_t expectedSize)
+        : fd_(-1), data_(nullptr), size_(0), capacity_(0) {
+#if !defined(_WIN32)
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not open file: " + path);
+    }
+    struct stat fileStat;
+    if (::fstat(fd_, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        // Do not unlink, because path can refer to the device or pipe.
+        ::close(fd_);
+        fd_ = -1;
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not map file that is not a regular file: " + path);
+    }
+    try {
+        remap(std::max(expectedSize, kCapacityMin));
+    } catch (...) {
+        ::close(fd_);
+        ::unlink(path.c_str());
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not map file: " + path);
+    }
+#else
+    (void)path;
+    (void)expectedSize;
+    throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Memory mapped files are not supported.");
+#endif
+}
+
+VirgilMappedFileDataSink::~VirgilMappedFileDataSink() noexcept {
+    try {
+        close();
+    } catch (...) {}
+}
+
+bool VirgilMappedFileDataSink::isGood() {
+    return fd_ >= 0;
+}
+
+void VirgilMappedFileDataSink::write(const VirgilByteArray& data) {
+    if (!isGood()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Mapped file is closed.");
+    }
+    if (data.empty()) {
+        return;
+    }
+    if (size_ + data.size() > capacity_) {
+        remap(std::max(2 * capacity_, size_ + data.size()));
+    }
+    std::memcpy(data_ + size_, data.data(), data.size());
+    size_ += data.size();
+}
+
+void VirgilMappedFileDataSink::close() {
+#if !defined(_WIN32)
+    if (fd_ < 0) {
+        return;
+    }
+    if (data_ != nullptr) {
+        ::munmap(data_, capacity_);
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+    const int truncateResult = ::ftruncate(fd_, static_cast<off_t>(size_));
+    ::close(fd_);
+    fd_ = -1;
+    if (truncateResult != 0) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not truncate mapped file to the written size.");
+    }
+#endif
+}
+
+void VirgilMappedFileDataSink::remap(size_t capacity) {
+#if !defined(_WIN32)
+    // Reserve before unmapping, so written data stays mapped if there is no space left.
+    const int reserveResult = reserve_file_space(fd_, capacity);
+    if (reserveResult != 0) {
+        throw make_error(VirgilCryptoError::InvalidState,
+                std::string("Can not reserve space for mapped file: ") + std::strerror(reserveResult));
+    }
+    if (data_ != nullptr) {
+        ::munmap(data_, capacity_);
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+    void* mapping = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not map file.");
+    }
+    // Data is written from the beginning to the end.
+    (void)::madvise(mapping, capacity, MADV_SEQUENTIAL);
+    data_ = static_cast<unsigned char*>(mapping);
+    capacity_ = capacity;
+#else
+    (void)capacity;
+#endif
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSource.h>
+
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::stream::VirgilMappedFileDataSource;
+
+static const size_t kChunkSizeMin = 32;
+
+VirgilMappedFileDataSource::VirgilMappedFileDataSource(const std::string& path, size_t chunkSize)
+        : data_(nullptr), size_(0), offset_(0), chunkSize_(std::max(chunkSize, kChunkSizeMin)) {
+#if !defined(_WIN32)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not open file: " + path);
+    }
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not get size of file: " + path);
+    }
+    if (!S_ISREG(fileStat.st_mode)) {
+        // Size of pipes, sockets and devices is not defined by st_size, so they can not be mapped.
+        ::close(fd);
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not map file that is not a regular file: " + path);
+    }
+    size_ = static_cast<size_t>(fileStat.st_size);
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw make_error(VirgilCryptoError::InvalidArgument, "Can not map file: " + path);
+        }
+        // Data is mostly consumed from the beginning to the end, so let kernel read ahead aggressively.
+        (void)::madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<unsigned char*>(mapping);
+    }
+    // Mapping remains valid after the file descriptor is closed.
+    ::close(fd);
+#else
+    (void)path;
+    throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Memory mapped files are not supported.");
+#endif
+}
+
+VirgilMappedFileDataSource::~VirgilMappedFileDataSource() noexcept {
+#if !defined(_WIN32)
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+#endif
+}
+
+bool VirgilMappedFileDataSource::hasData() {
+    return offset_ < size_;
+}
+
+VirgilByteArray VirgilMappedFileDataSource::read() {
+    const size_t readSize = std::min(chunkSize_, size_ - offset_);
+    VirgilByteArray result(data_ + offset_, data_ + offset_ + readSize);
+    offset_ += readSize;
+    return result;
+}
+
+VirgilByteArray VirgilMappedFileDataSource::read(size_t offset, size_t length) {
+    if (offset >= size_) {
+        return VirgilByteArray();
+    }
+    const size_t readSize = std::min(length, size_ - offset);
+    return VirgilByteArray(data_ + offset, data_ + offset + readSize);
+}
+
+const unsigned char* VirgilMappedFileDataSource::data() const {
+    return data_;
+}
+
+size_t VirgilMappedFileDataSource::size() const {
+    return size_;
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
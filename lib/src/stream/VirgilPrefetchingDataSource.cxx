@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/stream/VirgilPrefetchingDataSource.h>
+
+#include <algorithm>
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+#include "utils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::stream::VirgilPrefetchingDataSource;
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+
+class VirgilPrefetchingDataSource::Impl {
+public:
+    Impl(VirgilDataSource& source, size_t queueSize)
+            : source(source), queueSize(std::max(queueSize, size_t(1))), isExhausted(false), isStopped(false),
+              thread([this]() { prefetch(); }) {
+    }
+
+    ~Impl() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isStopped = true;
+        }
+        notFull.notify_all();
+        thread.join();
+    }
+
+    bool hasData() {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return !queue.empty() || isExhausted; });
+        return !queue.empty() || failure;
+    }
+
+    VirgilByteArray read() {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return !queue.empty() || isExhausted; });
+        if (!queue.empty()) {
+            VirgilByteArray result = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+            return result;
+        }
+        if (failure) {
+            std::exception_ptr error;
+            error.swap(failure);
+            std::rethrow_exception(error);
+        }
+        return VirgilByteArray();
+    }
+
+private:
+    void prefetch() {
+        try {
+            while (source.hasData()) {
+                VirgilByteArray data = source.read();
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [this]() { return queue.size() < queueSize || isStopped; });
+                if (isStopped) {
+                    return;
+                }
+                queue.push_back(std::move(data));
+                lock.unlock();
+                notEmpty.notify_one();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failure = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isExhausted = true;
+        }
+        notEmpty.notify_all();
+    }
+
+private:
+    VirgilDataSource& source;
+    const size_t queueSize;
+    std::deque<VirgilByteArray> queue;
+    bool isExhausted;
+    bool isStopped;
+    std::exception_ptr failure;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::thread thread;
+};
+
+#else
+
+class VirgilPrefetchingDataSource::Impl {
+public:
+    Impl(VirgilDataSource& source, size_t) : source(source) {
+    }
+
+    bool hasData() {
+        return source.hasData();
+    }
+
+    VirgilByteArray read() {
+        return source.read();
+    }
+
+private:
+    VirgilDataSource& source;
+};
+
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+VirgilPrefetchingDataSource::VirgilPrefetchingDataSource(VirgilDataSource& source, size_t queueSize)
+        : impl_(std::make_unique<Impl>(source, queueSize)) {
+}
+
+VirgilPrefetchingDataSource::~VirgilPrefetchingDataSource() noexcept = default;
+
+bool VirgilPrefetchingDataSource::hasData() {
+    return impl_->hasData();
+}
+
+VirgilByteArray VirgilPrefetchingDataSource::read() {
+    return impl_->read();
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
@@ -0,0 +1,193 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/stream/VirgilWriteBehindDataSink.h>
+
+#include <algorithm>
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+#include "utils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSink;
+using virgil::crypto::stream::VirgilWriteBehindDataSink;
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+
+class VirgilWriteBehindDataSink::Impl {
+public:
+    Impl(VirgilDataSink& sink, size_t queueSize)
+            : sink(sink), queueSize(std::max(queueSize, size_t(1))), isWriting(false), isSinkGood(sink.isGood()),
+              isStopped(false), thread([this]() { writeBehind(); }) {
+    }
+
+    ~Impl() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isStopped = true;
+        }
+        notEmpty.notify_all();
+        thread.join();
+    }
+
+    bool isGood() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return isSinkGood && !failure;
+    }
+
+    void write(const VirgilByteArray& data) {
+        VirgilByteArray queued(data);
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return queue.size() < queueSize || failure; });
+        rethrowFailure();
+        queue.push_back(std::move(queued));
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return (queue.empty() && !isWriting) || failure; });
+        rethrowFailure();
+    }
+
+private:
+    void writeBehind() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            notEmpty.wait(lock, [this]() { return !queue.empty() || isStopped; });
+            if (queue.empty()) {
+                // Stopped and all data is written.
+                return;
+            }
+            VirgilByteArray data = std::move(queue.front());
+            queue.pop_front();
+            isWriting = true;
+            lock.unlock();
+            std::exception_ptr error;
+            bool isGood = false;
+            try {
+                sink.write(data);
+                isGood = sink.isGood();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            isWriting = false;
+            isSinkGood = isGood;
+            if (error) {
+                // Drop the rest, it can not be written anyway.
+                failure = error;
+                queue.clear();
+            }
+            notFull.notify_all();
+        }
+    }
+
+    void rethrowFailure() {
+        if (failure) {
+            std::exception_ptr error;
+            error.swap(failure);
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    VirgilDataSink& sink;
+    const size_t queueSize;
+    std::deque<VirgilByteArray> queue;
+    bool isWriting;
+    bool isSinkGood;
+    bool isStopped;
+    std::exception_ptr failure;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::thread thread;
+};
+
+#else
+
+class VirgilWriteBehindDataSink::Impl {
+public:
+    Impl(VirgilDataSink& sink, size_t) : sink(sink) {
+    }
+
+    bool isGood() {
+        return sink.isGood();
+    }
+
+    void write(const VirgilByteArray& data) {
+        sink.write(data);
+    }
+
+    void flush() {
+    }
+
+private:
+    VirgilDataSink& sink;
+};
+
+#endif /* VIRGIL_CRYPTO_FEATURE_MULTI_THREAD */
+
+VirgilWriteBehindDataSink::VirgilWriteBehindDataSink(VirgilDataSink& sink, size_t queueSize)
+        : impl_(std::make_unique<Impl>(sink, queueSize)) {
+}
+
+VirgilWriteBehindDataSink::~VirgilWriteBehindDataSink() noexcept = default;
+
+bool VirgilWriteBehindDataSink::isGood() {
+    return impl_->isGood();
+}
+
+void VirgilWriteBehindDataSink::write(const VirgilByteArray& data) {
+    impl_->write(data);
+}
+
+void VirgilWriteBehindDataSink::flush() {
+    impl_->flush();
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
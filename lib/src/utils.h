@@ -56,4 +56,18 @@ unique_ptr<T> make_unique(Args&& ... args) {
 #endif // !defined(_MSC_VER) || _MSC_VER < 1800
 #endif // __cpp_lib_make_unique
 
+#include <cstddef>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Fill memory with zeros, writes are not removed by the optimizer.
+ */
+inline void secure_zeroize(void* ptr, size_t size) noexcept {
+    volatile unsigned char* p = static_cast<unsigned char*>(ptr);
+    while (size--) { *p++ = 0; }
+}
+
+}}}
+
 #endif // VIRGIL_CRYPTO_INTERNAL_UTILS_H
@@ -2,6 +2,7 @@
 #define VIRGIL_MBEDTLS_CONFIG_DESKTOP_H
 
 #define MBEDTLS_PLATFORM_C
+#define MBEDTLS_PLATFORM_MEMORY
 #define MBEDTLS_HAVE_ASM
 #define MBEDTLS_PADLOCK_C
 #define MBEDTLS_HAVE_TIME
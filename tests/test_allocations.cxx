@@ -0,0 +1,265 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_allocations.cxx
+ * @brief Covers reuse of the underlying crypto contexts without heap allocations
+ *
+ * @note Allocations are counted with the calloc / free hook of the underlying crypto library,
+ *       so context storage and memory allocated by mbedtls itself are visible,
+ *       and the global allocator of the test runner is left intact.
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+
+#include <mbedtls/platform.h>
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::VirgilRandom;
+
+TEST_CASE("Context storage is created and destroyed concurrently", "[allocations]") {
+    constexpr size_t kThreadsNum = 2;
+    constexpr size_t kIterations = 1000;
+    const VirgilByteArray data = str2bytes("data to be hashed");
+    const VirgilByteArray expectedDigest = VirgilHash("SHA256").hash(data);
+
+    std::vector<size_t> mismatchesNum(kThreadsNum, 0);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < kThreadsNum; ++threadIndex) {
+        threads.emplace_back([&, threadIndex]() {
+            for (size_t i = 0; i < kIterations; ++i) {
+                // Context storage goes back to the cache at the end of every iteration.
+                VirgilHash hash("SHA256");
+                VirgilSymmetricCipher cipher(VirgilSymmetricCipher::Algorithm::AES_256_CBC);
+                hash.start();
+                hash.update(data);
+                if (hash.finish() != expectedDigest) {
+                    ++mismatchesNum[threadIndex];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto mismatches : mismatchesNum) {
+        REQUIRE(mismatches == 0);
+    }
+}
+
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+
+struct AllocationsCount {
+    size_t allocations;
+    size_t deallocations;
+};
+
+static AllocationsCount g_allocations_count;
+
+static void* counting_calloc(size_t num, size_t size) {
+    ++g_allocations_count.allocations;
+    return std::calloc(num, size);
+}
+
+static void counting_free(void* ptr) {
+    if (ptr != nullptr) {
+        ++g_allocations_count.deallocations;
+    }
+    std::free(ptr);
+}
+
+/**
+ * @brief Count allocations made by the underlying crypto library while given function is called.
+ * @note Default calloc / free are restored after, so all blocks remain compatible.
+ */
+template<typename Func>
+static AllocationsCount count_allocations(Func func) {
+    g_allocations_count = AllocationsCount{ 0, 0 };
+    mbedtls_platform_set_calloc_free(counting_calloc, counting_free);
+    try {
+        func();
+    } catch (...) {
+        mbedtls_platform_set_calloc_free(std::calloc, std::free);
+        throw;
+    }
+    mbedtls_platform_set_calloc_free(std::calloc, std::free);
+    return g_allocations_count;
+}
+
+TEST_CASE("Steady state symmetric encryption does not allocate", "[allocations]") {
+    VirgilRandom random(str2bytes("test_allocations"));
+    VirgilSymmetricCipher cipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+    const VirgilByteArray key = random.randomize(cipher.keyLength());
+    const VirgilByteArray iv = random.randomize(cipher.ivSize());
+    const VirgilByteArray plainData = random.randomize(1024);
+    VirgilByteArray encryptedData(plainData.size() + cipher.blockSize() + cipher.authTagLength());
+
+    cipher.setEncryptionKey(key);
+    auto encrypt = [&]() -> size_t {
+        cipher.setIV(iv);
+        cipher.reset();
+        size_t written = cipher.update(
+                plainData.data(), plainData.size(), encryptedData.data(), encryptedData.size());
+        written += cipher.finish(encryptedData.data() + written, encryptedData.size() - written);
+        return written;
+    };
+
+    // Warm up
+    size_t encryptedSize = encrypt();
+
+    SECTION("repeated encryption") {
+        const auto count = count_allocations([&]() {
+            for (size_t i = 0; i < 100; ++i) {
+                encryptedSize = encrypt();
+            }
+        });
+        REQUIRE(count.allocations == 0);
+
+        encryptedData.resize(encryptedSize);
+        VirgilSymmetricCipher decipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+        decipher.setDecryptionKey(key);
+        REQUIRE(decipher.crypt(encryptedData, iv) == plainData);
+    }
+
+    SECTION("repeated clear") {
+        // Algorithm context is recreated by mbedtls, but context storage is reused, so memory does not grow.
+        const auto count = count_allocations([&]() {
+            for (size_t i = 0; i < 100; ++i) {
+                cipher.clear();
+                cipher.setEncryptionKey(key);
+                encrypt();
+            }
+        });
+        REQUIRE(count.allocations == count.deallocations);
+    }
+}
+
+TEST_CASE("Steady state symmetric encryption through mbedtls does not allocate", "[allocations]") {
+    // AES-CBC has no accelerated implementation, so every call goes to the mbedtls cipher context.
+    VirgilRandom random(str2bytes("test_allocations"));
+    VirgilSymmetricCipher cipher(VirgilSymmetricCipher::Algorithm::AES_256_CBC);
+    const VirgilByteArray key = random.randomize(cipher.keyLength());
+    const VirgilByteArray iv = random.randomize(cipher.ivSize());
+    const VirgilByteArray plainData = random.randomize(1000);
+    VirgilByteArray encryptedData(plainData.size() + cipher.blockSize());
+
+    cipher.setEncryptionKey(key);
+    cipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
+    auto encrypt = [&]() -> size_t {
+        cipher.setIV(iv);
+        cipher.reset();
+        size_t written = cipher.update(
+                plainData.data(), plainData.size(), encryptedData.data(), encryptedData.size());
+        written += cipher.finish(encryptedData.data() + written, encryptedData.size() - written);
+        return written;
+    };
+
+    // Warm up
+    size_t encryptedSize = encrypt();
+
+    const auto count = count_allocations([&]() {
+        for (size_t i = 0; i < 100; ++i) {
+            encryptedSize = encrypt();
+        }
+    });
+    REQUIRE(count.allocations == 0);
+    REQUIRE(count.deallocations == 0);
+
+    encryptedData.resize(encryptedSize);
+    VirgilSymmetricCipher decipher(VirgilSymmetricCipher::Algorithm::AES_256_CBC);
+    decipher.setDecryptionKey(key);
+    decipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
+    REQUIRE(decipher.crypt(encryptedData, iv) == plainData);
+}
+
+TEST_CASE("Steady state hashing does not allocate", "[allocations]") {
+    const VirgilByteArray data = str2bytes("data to be hashed");
+    VirgilHash hash("SHA256");
+    const VirgilByteArray expectedDigest = hash.hash(data);
+
+    // Warm up
+    hash.start();
+    hash.update(data);
+    REQUIRE(hash.finish() == expectedDigest);
+
+    const auto count = count_allocations([&]() {
+        for (size_t i = 0; i < 100; ++i) {
+            hash.start();
+            hash.update(data);
+            (void) hash.finish();
+            (void) hash.hash(data);
+        }
+    });
+    REQUIRE(count.allocations == 0);
+    REQUIRE(count.deallocations == 0);
+}
+
+TEST_CASE("Recreated hash reuses context storage", "[allocations]") {
+    constexpr size_t kIterations = 100;
+    const VirgilByteArray data = str2bytes("data to be hashed");
+
+    auto recreateHash = [&]() {
+        for (size_t i = 0; i < kIterations; ++i) {
+            VirgilHash hash("SHA256");
+            hash.start();
+            hash.update(data);
+        }
+    };
+
+    // Warm up
+    REQUIRE_FALSE(VirgilHash("SHA256").hash(data).empty());
+
+    // Steady state allocations stop growing: every block is released, and next run allocates no more.
+    const auto firstCount = count_allocations(recreateHash);
+    const auto secondCount = count_allocations(recreateHash);
+    REQUIRE(firstCount.allocations == firstCount.deallocations);
+    REQUIRE(secondCount.allocations == secondCount.deallocations);
+    REQUIRE(secondCount.allocations <= firstCount.allocations);
+}
+
+#endif /* defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO) */
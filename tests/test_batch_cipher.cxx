@@ -0,0 +1,134 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_batch_cipher.cxx
+ * @brief Covers class VirgilBatchCipher
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/VirgilBatchCipher.h>
+#include <virgil/crypto/VirgilCipher.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+
+#include <vector>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilBatchCipher;
+using virgil::crypto::VirgilCipher;
+using virgil::crypto::VirgilKeyPair;
+
+static std::vector<VirgilByteArray> make_messages(size_t count) {
+    std::vector<VirgilByteArray> messages;
+    for (size_t i = 0; i < count; ++i) {
+        messages.push_back(str2bytes("message #" + std::to_string(i)));
+    }
+    messages.push_back(VirgilByteArray());
+    return messages;
+}
+
+TEST_CASE("VirgilBatchCipher: encrypt batch", "[batch-cipher]") {
+    const VirgilByteArray aliceId = str2bytes("alice");
+    const VirgilByteArray bobId = str2bytes("bob");
+    const VirgilByteArray password = str2bytes("password");
+    const VirgilKeyPair aliceKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    const VirgilKeyPair bobKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::EC_SECP256R1);
+    const std::vector<VirgilByteArray> messages = make_messages(20);
+
+    VirgilBatchCipher batchCipher;
+    batchCipher.addKeyRecipient(aliceId, aliceKeyPair.publicKey());
+    batchCipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    batchCipher.addPasswordRecipient(password);
+    batchCipher.customParams().setString(str2bytes("type"), str2bytes("notification"));
+
+    auto check = [&](const std::vector<VirgilByteArray>& encryptedMessages) {
+        REQUIRE(encryptedMessages.size() == messages.size());
+        for (size_t i = 0; i < messages.size(); ++i) {
+            VirgilCipher aliceCipher;
+            REQUIRE(aliceCipher.decryptWithKey(
+                    encryptedMessages[i], aliceId, aliceKeyPair.privateKey()) == messages[i]);
+            REQUIRE(aliceCipher.customParams().getString(str2bytes("type")) == str2bytes("notification"));
+
+            VirgilCipher bobCipher;
+            REQUIRE(bobCipher.decryptWithKey(encryptedMessages[i], bobId, bobKeyPair.privateKey()) == messages[i]);
+        }
+        VirgilCipher passwordCipher;
+        REQUIRE(passwordCipher.decryptWithPassword(encryptedMessages.front(), password) == messages.front());
+    };
+
+    SECTION("sequentially") {
+        check(batchCipher.encrypt(messages));
+    }
+
+    SECTION("in parallel") {
+        batchCipher.setBatchThreadsNum(4);
+        REQUIRE(batchCipher.getBatchThreadsNum() == 4);
+        check(batchCipher.encrypt(messages));
+    }
+
+    SECTION("with own content encryption key per message") {
+        const std::vector<VirgilByteArray> sameMessages(2, str2bytes("the same message"));
+        const std::vector<VirgilByteArray> encryptedMessages = batchCipher.encrypt(sameMessages);
+        REQUIRE(encryptedMessages[0] != encryptedMessages[1]);
+    }
+}
+
+TEST_CASE("VirgilBatchCipher: invalid usage", "[batch-cipher]") {
+    const VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+    VirgilBatchCipher batchCipher;
+
+    SECTION("encrypt without recipients") {
+        REQUIRE_THROWS(batchCipher.encrypt(make_messages(1)));
+    }
+
+    SECTION("add recipient twice") {
+        batchCipher.addKeyRecipient(str2bytes("alice"), keyPair.publicKey());
+        REQUIRE_THROWS(batchCipher.addKeyRecipient(str2bytes("alice"), keyPair.publicKey()));
+    }
+
+    SECTION("add invalid public key") {
+        REQUIRE_THROWS(batchCipher.addKeyRecipient(str2bytes("alice"), str2bytes("invalid public key")));
+    }
+
+    SECTION("encrypt empty batch") {
+        batchCipher.addKeyRecipient(str2bytes("alice"), keyPair.publicKey());
+        REQUIRE(batchCipher.encrypt(std::vector<VirgilByteArray>()).empty());
+    }
+}
@@ -43,11 +43,15 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <sstream>
+
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilChunkCipher.h>
 #include <virgil/crypto/VirgilKeyPair.h>
 #include <virgil/crypto/stream/VirgilBytesDataSource.h>
 #include <virgil/crypto/stream/VirgilBytesDataSink.h>
+#include <virgil/crypto/stream/VirgilStreamRandomAccessDataSource.h>
 #include <virgil/crypto/foundation/VirgilBase64.h>
 
 using virgil::crypto::str2bytes;
@@ -56,8 +60,10 @@ using virgil::crypto::bytes2str;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilChunkCipher;
 using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilRandomAccessDataSource;
 using virgil::crypto::stream::VirgilBytesDataSource;
 using virgil::crypto::stream::VirgilBytesDataSink;
+using virgil::crypto::stream::VirgilStreamRandomAccessDataSource;
 using virgil::crypto::foundation::VirgilBase64;
 
 TEST_CASE("VirgilChunkCipher: encrypt and decrypt with generated keys", "[chunk-cipher]") {
@@ -301,6 +307,193 @@ TEST_CASE("VirgilChunkCipher: data read from a source by one pass", "[chunk-ciph
     REQUIRE(bytes2str(decryptedData) == "538DF736-57A0-4B39-B695-73681E59EAAC");
 }
 
+TEST_CASE("VirgilChunkCipher: encrypt and decrypt in parallel", "[chunk-cipher]") {
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    const size_t kChunkSize = 100;
+    VirgilByteArray testData(64 * kChunkSize + 17);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i);
+    }
+
+    auto encrypt = [&](size_t threadsNum, size_t readSize) {
+        VirgilByteArray encryptedData;
+        VirgilBytesDataSource dataSource(testData, readSize);
+        VirgilBytesDataSink encryptedDataSink(encryptedData);
+        VirgilChunkCipher cipher;
+        cipher.setChunksThreadsNum(threadsNum);
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(dataSource, encryptedDataSink, true, kChunkSize);
+        return encryptedData;
+    };
+
+    auto decrypt = [&](const VirgilByteArray& encryptedData, size_t threadsNum, size_t readSize) {
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSource encryptedDataSource(encryptedData, readSize);
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        VirgilChunkCipher cipher;
+        cipher.setChunksThreadsNum(threadsNum);
+        cipher.decryptWithKey(encryptedDataSource, decryptedDataSink, recipientId, keyPair.privateKey());
+        return decryptedData;
+    };
+
+    SECTION("encrypt sequentially, decrypt in parallel") {
+        VirgilByteArray encryptedData = encrypt(1, 7);
+        REQUIRE(decrypt(encryptedData, 4, 4096) == testData);
+    }
+
+    SECTION("encrypt in parallel, decrypt sequentially") {
+        VirgilByteArray encryptedData = encrypt(4, 4096);
+        REQUIRE(decrypt(encryptedData, 1, 13) == testData);
+    }
+
+    SECTION("encrypt and decrypt in parallel with different read sizes") {
+        VirgilByteArray encryptedData = encrypt(8, 1);
+        REQUIRE(decrypt(encryptedData, 3, 1000) == testData);
+    }
+
+    SECTION("detect modified chunk") {
+        VirgilByteArray encryptedData = encrypt(4, 4096);
+        encryptedData[encryptedData.size() - 5 * kChunkSize] ^= 0x01;
+        REQUIRE_THROWS(decrypt(encryptedData, 4, 4096));
+    }
+}
+
+class CountingRandomAccessDataSource : public VirgilRandomAccessDataSource {
+public:
+    explicit CountingRandomAccessDataSource(const VirgilByteArray& data) : data_(data), readBytes_(0) {}
+
+    VirgilByteArray read(size_t offset, size_t length) override {
+        if (offset >= data_.size()) {
+            return VirgilByteArray();
+        }
+        const size_t end = offset + std::min(length, data_.size() - offset);
+        readBytes_ += end - offset;
+        return VirgilByteArray(data_.begin() + offset, data_.begin() + end);
+    }
+
+    size_t readBytes() const {
+        return readBytes_;
+    }
+
+private:
+    const VirgilByteArray& data_;
+    size_t readBytes_;
+};
+
+TEST_CASE("VirgilChunkCipher: encrypt in the format of earlier releases", "[chunk-cipher]") {
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    const size_t kChunkSize = 100;
+    VirgilByteArray testData(16 * kChunkSize + 17);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i);
+    }
+
+    VirgilByteArray encryptedData;
+    VirgilBytesDataSource dataSource(testData, testData.size());
+    VirgilBytesDataSink encryptedDataSink(encryptedData);
+    VirgilChunkCipher encCipher;
+    REQUIRE(encCipher.isIndexedChunkNonce());
+    encCipher.setIndexedChunkNonce(false);
+    REQUIRE_FALSE(encCipher.isIndexedChunkNonce());
+    encCipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    encCipher.encrypt(dataSource, encryptedDataSink, true, kChunkSize);
+
+    VirgilChunkCipher decCipher;
+
+    SECTION("is decrypted") {
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSource encryptedDataSource(encryptedData, encryptedData.size());
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        decCipher.decryptWithKey(encryptedDataSource, decryptedDataSink, recipientId, keyPair.privateKey());
+        REQUIRE(decryptedData == testData);
+        REQUIRE_THROWS(decCipher.customParams().getInteger(str2bytes("chunkNonce")));
+    }
+
+    SECTION("does not support range decryption") {
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE_THROWS(decCipher.decryptRangeWithKey(
+                source, decryptedDataSink, 0, 10, recipientId, keyPair.privateKey()));
+    }
+}
+
+TEST_CASE("VirgilChunkCipher: decrypt range", "[chunk-cipher]") {
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    const size_t kChunkSize = 100;
+    VirgilByteArray testData(64 * kChunkSize + 17);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i);
+    }
+
+    VirgilByteArray encryptedData;
+    VirgilBytesDataSource dataSource(testData, 4096);
+    VirgilBytesDataSink encryptedDataSink(encryptedData);
+    VirgilChunkCipher encCipher;
+    encCipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    encCipher.encrypt(dataSource, encryptedDataSink, true, kChunkSize);
+
+    auto decryptRange = [&](VirgilRandomAccessDataSource& source, size_t offset, size_t length) {
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        VirgilChunkCipher decCipher;
+        decCipher.decryptRangeWithKey(
+                source, decryptedDataSink, offset, length, recipientId, keyPair.privateKey());
+        return decryptedData;
+    };
+
+    auto expectedRange = [&](size_t offset, size_t length) {
+        const size_t begin = std::min(offset, testData.size());
+        const size_t end = std::min(offset + length, testData.size());
+        return VirgilByteArray(testData.begin() + begin, testData.begin() + end);
+    };
+
+    SECTION("within one chunk") {
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE(decryptRange(source, 1234, 10) == expectedRange(1234, 10));
+        const size_t contentInfoSize = VirgilChunkCipher::defineContentInfoSize(encryptedData);
+        REQUIRE(source.readBytes() < contentInfoSize + 16 + 2 * kChunkSize);
+    }
+
+    SECTION("across several chunks") {
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE(decryptRange(source, 250, 1000) == expectedRange(250, 1000));
+    }
+
+    SECTION("at the chunk boundaries") {
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE(decryptRange(source, 0, kChunkSize) == expectedRange(0, kChunkSize));
+        REQUIRE(decryptRange(source, kChunkSize, kChunkSize) == expectedRange(kChunkSize, kChunkSize));
+    }
+
+    SECTION("at the end of the data") {
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE(decryptRange(source, 6390, 1000) == expectedRange(6390, 1000));
+        REQUIRE(decryptRange(source, 100000, 10).empty());
+        REQUIRE(decryptRange(source, 0, 0).empty());
+    }
+
+    SECTION("from the seekable stream") {
+        std::stringstream stream(std::string(encryptedData.begin(), encryptedData.end()));
+        VirgilStreamRandomAccessDataSource source(stream);
+        REQUIRE(decryptRange(source, 6390, 1000) == expectedRange(6390, 1000));
+        REQUIRE(decryptRange(source, 10, 20) == expectedRange(10, 20));
+    }
+
+    SECTION("with modified chunk") {
+        encryptedData[encryptedData.size() - 5 * kChunkSize] ^= 0x01;
+        CountingRandomAccessDataSource source(encryptedData);
+        REQUIRE(decryptRange(source, 0, 10) == expectedRange(0, 10));
+        REQUIRE_THROWS(decryptRange(source, 0, testData.size()));
+    }
+}
+
 #else
 #if defined(_MSC_VER)
 #pragma message("Tests for class VirgilChunkCipher are ignored, because VIRGIL_CRYPTO_FEATURE_STREAM_IMPL build parameter is not defined")
@@ -46,6 +46,7 @@
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCipher.h>
 #include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
 
 using virgil::crypto::str2bytes;
 using virgil::crypto::bytes2hex;
@@ -54,6 +55,7 @@ using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilCipher;
 using virgil::crypto::VirgilKeyPair;
 using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 
 static void test_encrypt_decrypt(const VirgilKeyPair& keyPair, const VirgilByteArray& keyPassword) {
@@ -299,3 +301,102 @@ TEST_CASE("VirgilCipher: add 512 recipients", "[cipher]") {
     REQUIRE_NOTHROW(decryptedData = cipher.decryptWithKey(encryptedData, lastRecipientId, commonKeyPair.privateKey()));
     REQUIRE(testData == decryptedData);
 }
+
+TEST_CASE("VirgilCipher: encrypt for multiple recipients in parallel", "[cipher]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilKeyPair commonKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray alicePassword = str2bytes("alice secret");
+
+    VirgilCipher sequentialCipher;
+    VirgilCipher parallelCipher;
+    parallelCipher.setRecipientsThreadsNum(4);
+    REQUIRE(parallelCipher.getRecipientsThreadsNum() == 4);
+
+    for (auto i = 0; i < 32; ++i) {
+        VirgilByteArray recipientId = str2bytes("recipient-" + std::to_string(i));
+        sequentialCipher.addKeyRecipient(recipientId, commonKeyPair.publicKey());
+        parallelCipher.addKeyRecipient(recipientId, commonKeyPair.publicKey());
+    }
+    parallelCipher.addPasswordRecipient(alicePassword);
+    sequentialCipher.addPasswordRecipient(alicePassword);
+
+    VirgilByteArray sequentialEncryptedData = sequentialCipher.encrypt(testData, true);
+    VirgilByteArray parallelEncryptedData = parallelCipher.encrypt(testData, true);
+    REQUIRE(sequentialCipher.getContentInfo().size() == parallelCipher.getContentInfo().size());
+
+    for (auto i = 0; i < 32; ++i) {
+        VirgilByteArray recipientId = str2bytes("recipient-" + std::to_string(i));
+        VirgilCipher decoder;
+        REQUIRE(decoder.decryptWithKey(parallelEncryptedData, recipientId, commonKeyPair.privateKey()) == testData);
+    }
+
+    VirgilCipher decoder;
+    REQUIRE(decoder.decryptWithPassword(parallelEncryptedData, alicePassword) == testData);
+}
+
+TEST_CASE("VirgilCipher: encrypt into single buffer of predicted size", "[cipher]") {
+    VirgilByteArray testData(1024 * 1024 + 3, 0x5A);
+    VirgilByteArray bobId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray alicePassword = str2bytes("alice secret");
+
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    cipher.addPasswordRecipient(alicePassword);
+
+    SECTION("with embedded content info") {
+        const size_t encryptedSize = cipher.defineEncryptedSize(testData.size());
+        VirgilByteArray encryptedData(encryptedSize);
+        size_t writtenBytes = 0;
+        REQUIRE_NOTHROW(
+                writtenBytes = cipher.encrypt(testData.data(), testData.size(), encryptedData.data(), encryptedSize)
+        );
+        REQUIRE(writtenBytes == encryptedSize);
+
+        VirgilCipher decoder;
+        REQUIRE(decoder.decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+        REQUIRE(decoder.decryptWithPassword(encryptedData, alicePassword) == testData);
+    }
+
+    SECTION("with separated content info") {
+        const size_t encryptedSize = cipher.defineEncryptedSize(testData.size(), false);
+        VirgilByteArray encryptedData = cipher.encrypt(testData, false);
+        REQUIRE(encryptedData.size() == encryptedSize);
+
+        VirgilCipher decoder;
+        decoder.setContentInfo(cipher.getContentInfo());
+        REQUIRE(decoder.decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+    }
+
+    SECTION("with too small buffer") {
+        VirgilByteArray encryptedData(cipher.defineEncryptedSize(testData.size()) - 1);
+        REQUIRE_THROWS(
+                cipher.encrypt(testData.data(), testData.size(), encryptedData.data(), encryptedData.size())
+        );
+    }
+}
+
+TEST_CASE("VirgilCipher: encrypt and decrypt with ChaCha20-Poly1305", "[cipher]") {
+    VirgilByteArray testData(100 * 1024 + 7, 0x5A);
+    VirgilByteArray bobId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generateRecommended();
+
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    cipher.setContentEncryptionAlgorithm(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305);
+    REQUIRE(cipher.getContentEncryptionAlgorithm() == VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305);
+
+    VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+    REQUIRE(encryptedData.size() == cipher.defineEncryptedSize(testData.size()));
+
+    SECTION("algorithm is detected from the content info") {
+        VirgilCipher decoder;
+        REQUIRE(decoder.decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+    }
+
+    SECTION("corrupted data is rejected") {
+        encryptedData[encryptedData.size() / 2] ^= 0x01;
+        VirgilCipher decoder;
+        REQUIRE_THROWS(decoder.decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()));
+    }
+}
@@ -44,12 +44,16 @@
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCipherBase.h>
+#include <virgil/crypto/VirgilCipher.h>
 #include <virgil/crypto/VirgilCryptoException.h>
 #include <virgil/crypto/VirgilKeyPair.h>
 
+#include <algorithm>
+
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilCipherBase;
+using virgil::crypto::VirgilCipher;
 using virgil::crypto::VirgilCryptoException;
 using virgil::crypto::VirgilKeyPair;
 
@@ -292,6 +296,65 @@ TEST_CASE("VirgilCipherBase::setContentInfo()", "[cipher-base]") {
         REQUIRE_NOTHROW(cipherBase.setContentInfo(validContentInfo));
     }
 
+    SECTION("Write generated content info and read it back") {
+        VirgilCipher cipher;
+        for (auto i = 0; i < 16; ++i) {
+            cipher.addKeyRecipient(
+                    VirgilByteArrayUtils::stringToBytes("recipient-" + std::to_string(i)),
+                    VirgilByteArrayUtils::stringToBytes(kPublicKey));
+        }
+        cipher.addPasswordRecipient(VirgilByteArrayUtils::stringToBytes("password"));
+        (void) cipher.encrypt(VirgilByteArray());
+        const VirgilByteArray generatedContentInfo = cipher.getContentInfo();
+
+        cipherBase.setContentInfo(generatedContentInfo);
+        REQUIRE(cipherBase.keyRecipientExists(VirgilByteArrayUtils::stringToBytes("recipient-7")));
+        REQUIRE(cipherBase.getContentInfo() == generatedContentInfo);
+    }
+
+    SECTION("Write generated content info and read it back several times") {
+        VirgilCipher cipher;
+        for (auto i = 0; i < 16; ++i) {
+            cipher.addKeyRecipient(
+                    VirgilByteArrayUtils::stringToBytes("recipient-" + std::to_string(i)),
+                    VirgilByteArrayUtils::stringToBytes(kPublicKey));
+        }
+        (void) cipher.encrypt(VirgilByteArray());
+        const VirgilByteArray generatedContentInfo = cipher.getContentInfo();
+
+        cipherBase.setContentInfo(generatedContentInfo);
+        REQUIRE(cipherBase.getContentInfo() == generatedContentInfo);
+        REQUIRE(cipherBase.getContentInfo() == generatedContentInfo);
+        REQUIRE(cipherBase.keyRecipientExists(VirgilByteArrayUtils::stringToBytes("recipient-15")));
+    }
+
+    SECTION("Write generated content info with malformed recipient") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(
+                VirgilByteArrayUtils::stringToBytes("recipient-0"), VirgilByteArrayUtils::stringToBytes(kPublicKey));
+        (void) cipher.encrypt(VirgilByteArray());
+        VirgilByteArray generatedContentInfo = cipher.getContentInfo();
+
+        // KeyTransRecipientInfo: version 2, subjectKeyIdentifier "recipient-0"
+        VirgilByteArray recipientHeader { 0x02, 0x01, 0x02, 0xA0, 0x0D, 0x04, 0x0B };
+        const VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("recipient-0");
+        recipientHeader.insert(recipientHeader.end(), recipientId.cbegin(), recipientId.cend());
+        auto recipientHeaderPos = std::search(
+                generatedContentInfo.begin(), generatedContentInfo.end(),
+                recipientHeader.cbegin(), recipientHeader.cend());
+        REQUIRE(recipientHeaderPos != generatedContentInfo.end());
+        *(recipientHeaderPos + 2) = 0x03;
+
+        REQUIRE_THROWS_AS(cipherBase.setContentInfo(generatedContentInfo), VirgilCryptoException);
+    }
+
+    SECTION("Write valid content info and search recipients") {
+        cipherBase.setContentInfo(validContentInfo);
+        REQUIRE(cipherBase.keyRecipientExists(
+                VirgilByteArrayUtils::stringToBytes("7d4d9db9-4838-4b3e-994b-ddda6fc05760")));
+        REQUIRE_FALSE(cipherBase.keyRecipientExists(VirgilByteArrayUtils::stringToBytes("unknown-recipient-id")));
+    }
+
     SECTION("Write empty content info") {
         REQUIRE_THROWS_AS(cipherBase.setContentInfo(emptyContentInfo), VirgilCryptoException);
     }
@@ -62,6 +62,7 @@
 
 #include <virgil/crypto/VirgilCryptoException.h>
 #include <virgil/crypto/VirgilCustomParams.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
 #include <virgil/crypto/VirgilCipher.h>
 #include <virgil/crypto/VirgilStreamCipher.h>
 #include <virgil/crypto/VirgilChunkCipher.h>
@@ -132,4 +133,5 @@ TEST_CASE("Check contract: copy and move", "[copy/move]") {
 #endif
 
     SECTION_CONTRACT_COPY_AND_MOVE(virgil::crypto::VirgilKeyPair);
+    SECTION_CONTRACT_COPY_AND_MOVE(virgil::crypto::VirgilPrivateKeyHandle);
 }
@@ -0,0 +1,201 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_ecp_tables.cxx
+ * @brief Covers sharing of the precomputed EC generator tables between key contexts
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+
+#include <mbedtls/ecp.h>
+#include <mbedtls/pk.h>
+
+#include "mbedtls_context.h"
+#include "mbedtls_ecp_tables.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+using virgil::crypto::foundation::internal::mbedtls_context;
+using virgil::crypto::foundation::internal::ecp_group_attach_shared_table;
+using virgil::crypto::foundation::internal::ecp_group_detach_shared_table;
+using virgil::crypto::foundation::internal::pk_attach_shared_ecp_table;
+
+static mbedtls_ecp_point* attached_table(mbedtls_ecp_group_id id) {
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_group_init(&grp);
+    REQUIRE(mbedtls_ecp_group_load(&grp, id) == 0);
+    ecp_group_attach_shared_table(&grp);
+    mbedtls_ecp_point* table = grp.T;
+    ecp_group_detach_shared_table(&grp);
+    mbedtls_ecp_group_free(&grp);
+    return table;
+}
+
+TEST_CASE("ECP tables: attached table is detached before the context is freed", "[ecp-tables]") {
+    mbedtls_ecp_point* table = attached_table(MBEDTLS_ECP_DP_SECP256R1);
+    REQUIRE(table != nullptr);
+
+    SECTION("detach from the group") {
+        mbedtls_ecp_group grp;
+        mbedtls_ecp_group_init(&grp);
+        REQUIRE(mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1) == 0);
+        ecp_group_attach_shared_table(&grp);
+        REQUIRE(grp.T == table);
+        ecp_group_detach_shared_table(&grp);
+        REQUIRE(grp.T == nullptr);
+        REQUIRE(grp.T_size == 0);
+        mbedtls_ecp_group_free(&grp);
+    }
+
+    SECTION("detach by the pk context policy") {
+        for (size_t i = 0; i < 3; ++i) {
+            mbedtls_context<mbedtls_pk_context> pk_ctx;
+            pk_ctx.setup(MBEDTLS_PK_ECKEY);
+            REQUIRE(mbedtls_ecp_group_load(&mbedtls_pk_ec(*pk_ctx.get())->grp, MBEDTLS_ECP_DP_SECP256R1) == 0);
+            pk_attach_shared_ecp_table(pk_ctx.get());
+            REQUIRE(mbedtls_pk_ec(*pk_ctx.get())->grp.T == table);
+        }
+    }
+
+    SECTION("own table of the group is not detached") {
+        mbedtls_ecp_group grp;
+        mbedtls_ecp_point R;
+        mbedtls_mpi one;
+        mbedtls_ecp_group_init(&grp);
+        mbedtls_ecp_point_init(&R);
+        mbedtls_mpi_init(&one);
+        REQUIRE(mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1) == 0);
+        REQUIRE(mbedtls_mpi_lset(&one, 1) == 0);
+        REQUIRE(mbedtls_ecp_mul(&grp, &R, &one, &grp.G, nullptr, nullptr) == 0);
+        mbedtls_ecp_point* ownTable = grp.T;
+        REQUIRE(ownTable != nullptr);
+        REQUIRE(ownTable != table);
+        ecp_group_attach_shared_table(&grp);
+        REQUIRE(grp.T == ownTable);
+        ecp_group_detach_shared_table(&grp);
+        REQUIRE(grp.T == ownTable);
+        mbedtls_mpi_free(&one);
+        mbedtls_ecp_point_free(&R);
+        mbedtls_ecp_group_free(&grp);
+    }
+
+    // Table survives the freed contexts
+    REQUIRE(attached_table(MBEDTLS_ECP_DP_SECP256R1) == table);
+}
+
+TEST_CASE("ECP tables: keys sharing the table survive each other's destruction", "[ecp-tables]") {
+    VirgilHash hash(VirgilHash::Algorithm::SHA384);
+    const VirgilByteArray digest = hash.hash(str2bytes("data to be signed"));
+
+    std::unique_ptr<VirgilAsymmetricCipher> firstKey(new VirgilAsymmetricCipher());
+    VirgilAsymmetricCipher secondKey;
+    firstKey->genKeyPair(VirgilKeyPair::Type::EC_SECP256R1);
+    secondKey.genKeyPair(VirgilKeyPair::Type::EC_SECP256R1);
+
+    const VirgilByteArray firstSign = firstKey->sign(digest, hash.type());
+    REQUIRE(firstKey->verify(digest, firstSign, hash.type()));
+    firstKey.reset();
+
+    const VirgilByteArray secondSign = secondKey.sign(digest, hash.type());
+    REQUIRE(secondKey.verify(digest, secondSign, hash.type()));
+    REQUIRE_FALSE(secondKey.verify(digest, firstSign, hash.type()));
+
+    VirgilAsymmetricCipher thirdKey;
+    thirdKey.genKeyPair(VirgilKeyPair::Type::EC_SECP256R1);
+    REQUIRE(thirdKey.verify(digest, thirdKey.sign(digest, hash.type()), hash.type()));
+}
+
+TEST_CASE("ECP tables: concurrent first use of the curve", "[ecp-tables]") {
+    constexpr size_t kThreadsNum = 4;
+    // Curve is not used by other tests, so the table is built here
+    const auto curveId = MBEDTLS_ECP_DP_SECP224K1;
+
+    std::atomic<size_t> readyThreadsNum(0);
+    std::atomic<bool> isStarted(false);
+    std::vector<mbedtls_ecp_point*> tables(kThreadsNum, nullptr);
+    std::vector<char> isSignVerified(kThreadsNum, 0);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < kThreadsNum; ++threadIndex) {
+        threads.emplace_back([&, threadIndex]() {
+            ++readyThreadsNum;
+            while (!isStarted) {
+                std::this_thread::yield();
+            }
+            mbedtls_ecp_group grp;
+            mbedtls_ecp_group_init(&grp);
+            if (mbedtls_ecp_group_load(&grp, curveId) == 0) {
+                ecp_group_attach_shared_table(&grp);
+                tables[threadIndex] = grp.T;
+                ecp_group_detach_shared_table(&grp);
+            }
+            mbedtls_ecp_group_free(&grp);
+
+            VirgilHash hash(VirgilHash::Algorithm::SHA256);
+            const VirgilByteArray digest = hash.hash(str2bytes("data to be signed"));
+            VirgilAsymmetricCipher key;
+            key.genKeyPair(VirgilKeyPair::Type::EC_SECP224K1);
+            isSignVerified[threadIndex] = key.verify(digest, key.sign(digest, hash.type()), hash.type()) ? 1 : 0;
+        });
+    }
+    while (readyThreadsNum < kThreadsNum) {
+        std::this_thread::yield();
+    }
+    isStarted = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(tables[0] != nullptr);
+    for (size_t threadIndex = 0; threadIndex < kThreadsNum; ++threadIndex) {
+        REQUIRE(tables[threadIndex] == tables[0]);
+        REQUIRE(isSignVerified[threadIndex] == 1);
+    }
+    REQUIRE(attached_table(curveId) == tables[0]);
+}
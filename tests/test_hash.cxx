@@ -41,6 +41,9 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/foundation/VirgilHash.h>
 
@@ -141,6 +144,86 @@ TEST_CASE("SHA-512", "[hash]") {
     }
 }
 
+TEST_CASE("SHA-2 long message", "[hash]") {
+    const VirgilByteArray message(1000000, 'a');
+    SECTION("SHA-224: one million of 'a'") {
+        VirgilHash hash(VirgilHash::Algorithm::SHA224);
+        REQUIRE(hash.hash(message) == hex2bytes("20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67"));
+    }
+    SECTION("SHA-256: one million of 'a'") {
+        VirgilHash hash(VirgilHash::Algorithm::SHA256);
+        REQUIRE(hash.hash(message) ==
+                hex2bytes("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+    }
+    SECTION("SHA-384: one million of 'a'") {
+        VirgilHash hash(VirgilHash::Algorithm::SHA384);
+        REQUIRE(hash.hash(message) == hex2bytes(
+                "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b"
+                "07b8b3dc38ecc4ebae97ddd87f3d8985"));
+    }
+    SECTION("SHA-512: one million of 'a'") {
+        VirgilHash hash(VirgilHash::Algorithm::SHA512);
+        REQUIRE(hash.hash(message) == hex2bytes(
+                "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+                "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"));
+    }
+    SECTION("Chain hashing with uneven chunks equals to immediate hashing") {
+        const VirgilHash::Algorithm algorithms[] = {
+                VirgilHash::Algorithm::SHA224, VirgilHash::Algorithm::SHA256,
+                VirgilHash::Algorithm::SHA384, VirgilHash::Algorithm::SHA512
+        };
+        const VirgilByteArray data(message.begin(), message.begin() + 4099);
+        for (auto algorithm : algorithms) {
+            VirgilHash hash(algorithm);
+            for (size_t chunkSize : { 1, 55, 64, 111, 128, 1000 }) {
+                hash.start();
+                for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+                    const size_t size = std::min(chunkSize, data.size() - offset);
+                    hash.update(VirgilByteArray(data.begin() + offset, data.begin() + offset + size));
+                }
+                REQUIRE(hash.finish() == hash.hash(data));
+            }
+        }
+    }
+}
+
+TEST_CASE("Batch hashing", "[hash]") {
+    // Lengths around the padding and block boundaries of the SHA-2 family.
+    const size_t lengths[] = { 0, 1, 3, 55, 56, 63, 64, 65, 111, 112, 119, 127, 128, 129, 200, 1000 };
+    std::vector<VirgilByteArray> messages;
+    for (size_t round = 0; round < 3; ++round) {
+        for (size_t length : lengths) {
+            VirgilByteArray message(length + round);
+            for (size_t i = 0; i < message.size(); ++i) {
+                message[i] = static_cast<unsigned char>(i * 31 + messages.size());
+            }
+            messages.push_back(message);
+        }
+    }
+    const VirgilHash::Algorithm algorithms[] = {
+            VirgilHash::Algorithm::MD5, VirgilHash::Algorithm::SHA1, VirgilHash::Algorithm::SHA224,
+            VirgilHash::Algorithm::SHA256, VirgilHash::Algorithm::SHA384, VirgilHash::Algorithm::SHA512
+    };
+    for (auto algorithm : algorithms) {
+        VirgilHash hash(algorithm);
+        SECTION(hash.name() + ": batch equals to one by one hashing") {
+            std::vector<VirgilByteArray> digests = hash.hashBatch(messages);
+            REQUIRE(digests.size() == messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                REQUIRE(digests[i] == hash.hash(messages[i]));
+            }
+        }
+        SECTION(hash.name() + ": single message") {
+            std::vector<VirgilByteArray> digests = hash.hashBatch({ messages.back() });
+            REQUIRE(digests.size() == 1);
+            REQUIRE(digests.front() == hash.hash(messages.back()));
+        }
+        SECTION(hash.name() + ": empty batch") {
+            REQUIRE(hash.hashBatch({}).empty());
+        }
+    }
+}
+
 TEST_CASE("HMAC-MD5", "[HMAC hash]") {
     VirgilHash hash(VirgilHash::Algorithm::MD5);
 
@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_mapped_file.cxx
+ * @brief Covers classes VirgilMappedFileDataSource and VirgilMappedFileDataSink
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL && !defined(_WIN32)
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/VirgilChunkCipher.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSource.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSink.h>
+
+#include <algorithm>
+#include <cstdio>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilChunkCipher;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::stream::VirgilMappedFileDataSource;
+using virgil::crypto::stream::VirgilMappedFileDataSink;
+
+static VirgilByteArray make_test_data(size_t size) {
+    VirgilByteArray result(size);
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+    return result;
+}
+
+TEST_CASE("VirgilMappedFileDataSource: open non existing file", "[mapped-file]") {
+    REQUIRE_THROWS(VirgilMappedFileDataSource("invalid_path_to_file"));
+}
+
+TEST_CASE("VirgilMappedFileDataSource: open not a regular file", "[mapped-file]") {
+    REQUIRE_THROWS(VirgilMappedFileDataSource("/dev/null"));
+    REQUIRE_THROWS(VirgilMappedFileDataSource("."));
+}
+
+TEST_CASE("VirgilMappedFileDataSink: open not a regular file", "[mapped-file]") {
+    REQUIRE_THROWS(VirgilMappedFileDataSink("/dev/null"));
+}
+
+TEST_CASE("VirgilMappedFileDataSink: write and read back", "[mapped-file]") {
+    const std::string path = "test_mapped_file.bin";
+    const VirgilByteArray testData = make_test_data(300 * 1024 + 17);
+
+    {
+        // Initial capacity is less than data size, so mapping is extended several times.
+        VirgilMappedFileDataSink dataSink(path);
+        for (size_t offset = 0; offset < testData.size(); offset += 10000) {
+            const size_t end = std::min(offset + 10000, testData.size());
+            dataSink.write(VirgilByteArray(testData.begin() + offset, testData.begin() + end));
+        }
+        dataSink.close();
+        REQUIRE_FALSE(dataSink.isGood());
+    }
+
+    SECTION("sequentially") {
+        VirgilMappedFileDataSource dataSource(path, 4096);
+        REQUIRE(dataSource.size() == testData.size());
+        REQUIRE(VirgilByteArray(dataSource.data(), dataSource.data() + dataSource.size()) == testData);
+
+        VirgilByteArray readData;
+        while (dataSource.hasData()) {
+            const VirgilByteArray chunk = dataSource.read();
+            REQUIRE(chunk.size() <= 4096);
+            VirgilByteArrayUtils::append(readData, chunk);
+        }
+        REQUIRE(readData == testData);
+    }
+
+    SECTION("randomly") {
+        VirgilMappedFileDataSource dataSource(path);
+        REQUIRE(dataSource.read(1000, 10) == VirgilByteArray(testData.begin() + 1000, testData.begin() + 1010));
+        REQUIRE(dataSource.read(testData.size() - 5, 10) == VirgilByteArray(testData.end() - 5, testData.end()));
+        REQUIRE(dataSource.read(testData.size(), 10).empty());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("VirgilMappedFileDataSource: empty file", "[mapped-file]") {
+    const std::string path = "test_mapped_file_empty.bin";
+    {
+        VirgilMappedFileDataSink dataSink(path);
+    }
+    VirgilMappedFileDataSource dataSource(path);
+    REQUIRE_FALSE(dataSource.hasData());
+    REQUIRE(dataSource.size() == 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("VirgilChunkCipher: encrypt and decrypt mapped files", "[mapped-file]") {
+    const std::string plainPath = "test_mapped_file_plain.bin";
+    const std::string encryptedPath = "test_mapped_file_encrypted.bin";
+    const std::string decryptedPath = "test_mapped_file_decrypted.bin";
+    const VirgilByteArray testData = make_test_data(1024 * 1024 + 1);
+    const VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    const VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    {
+        VirgilMappedFileDataSink dataSink(plainPath);
+        dataSink.write(testData);
+    }
+    {
+        VirgilMappedFileDataSource dataSource(plainPath);
+        VirgilMappedFileDataSink dataSink(encryptedPath, dataSource.size());
+        VirgilChunkCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(dataSource, dataSink, true, 64 * 1024);
+    }
+    {
+        VirgilMappedFileDataSource dataSource(encryptedPath);
+        VirgilMappedFileDataSink dataSink(decryptedPath, dataSource.size());
+        VirgilChunkCipher cipher;
+        cipher.decryptWithKey(dataSource, dataSink, recipientId, keyPair.privateKey());
+    }
+
+    VirgilMappedFileDataSource decryptedSource(decryptedPath);
+    REQUIRE(VirgilByteArray(decryptedSource.data(), decryptedSource.data() + decryptedSource.size()) == testData);
+
+    std::remove(plainPath.c_str());
+    std::remove(encryptedPath.c_str());
+    std::remove(decryptedPath.c_str());
+}
+
+#endif // VIRGIL_CRYPTO_FEATURE_STREAM_IMPL && !defined(_WIN32)
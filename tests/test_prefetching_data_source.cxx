@@ -0,0 +1,201 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_prefetching_data_source.cxx
+ * @brief Covers classes VirgilPrefetchingDataSource and VirgilWriteBehindDataSink
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilStreamCipher.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#include <virgil/crypto/stream/VirgilBytesDataSink.h>
+#include <virgil/crypto/stream/VirgilPrefetchingDataSource.h>
+#include <virgil/crypto/stream/VirgilWriteBehindDataSink.h>
+
+#include <stdexcept>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilStreamCipher;
+using virgil::crypto::stream::VirgilBytesDataSource;
+using virgil::crypto::stream::VirgilBytesDataSink;
+using virgil::crypto::stream::VirgilPrefetchingDataSource;
+using virgil::crypto::stream::VirgilWriteBehindDataSink;
+
+class FailingDataSource : public VirgilDataSource {
+public:
+    bool hasData() override {
+        return true;
+    }
+
+    VirgilByteArray read() override {
+        throw std::runtime_error("read failed");
+    }
+};
+
+class FailingDataSink : public VirgilDataSink {
+public:
+    bool isGood() override {
+        return true;
+    }
+
+    void write(const VirgilByteArray&) override {
+        throw std::runtime_error("write failed");
+    }
+};
+
+static VirgilByteArray make_test_data(size_t size) {
+    VirgilByteArray result(size);
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+    return result;
+}
+
+TEST_CASE("VirgilPrefetchingDataSource: read all data", "[prefetching-data-source]") {
+    const VirgilByteArray testData = make_test_data(100 * 1000 + 7);
+    VirgilBytesDataSource bytesSource(testData, 1000);
+
+    VirgilByteArray readData;
+    {
+        VirgilPrefetchingDataSource dataSource(bytesSource, 3);
+        while (dataSource.hasData()) {
+            VirgilByteArrayUtils::append(readData, dataSource.read());
+        }
+    }
+    REQUIRE(readData == testData);
+}
+
+TEST_CASE("VirgilPrefetchingDataSource: stop before all data is read", "[prefetching-data-source]") {
+    const VirgilByteArray testData = make_test_data(100 * 1000);
+    VirgilBytesDataSource bytesSource(testData, 10);
+
+    VirgilPrefetchingDataSource dataSource(bytesSource, 2);
+    REQUIRE(dataSource.hasData());
+    REQUIRE(dataSource.read() == VirgilByteArray(testData.begin(), testData.begin() + 10));
+}
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+TEST_CASE("VirgilPrefetchingDataSource: rethrow source error", "[prefetching-data-source]") {
+    FailingDataSource failingSource;
+    VirgilPrefetchingDataSource dataSource(failingSource);
+    REQUIRE(dataSource.hasData());
+    REQUIRE_THROWS_AS(dataSource.read(), std::runtime_error);
+    REQUIRE_FALSE(dataSource.hasData());
+}
+#endif // VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+
+TEST_CASE("VirgilWriteBehindDataSink: write all data", "[prefetching-data-source]") {
+    const VirgilByteArray testData = make_test_data(100 * 1000 + 7);
+    VirgilBytesDataSource bytesSource(testData, 1000);
+
+    VirgilByteArray writtenData;
+    VirgilBytesDataSink bytesSink(writtenData);
+
+    SECTION("and flush") {
+        VirgilWriteBehindDataSink dataSink(bytesSink, 3);
+        while (bytesSource.hasData()) {
+            dataSink.write(bytesSource.read());
+        }
+        dataSink.flush();
+        REQUIRE(dataSink.isGood());
+        REQUIRE(writtenData == testData);
+    }
+
+    SECTION("and destroy") {
+        {
+            VirgilWriteBehindDataSink dataSink(bytesSink, 3);
+            while (bytesSource.hasData()) {
+                dataSink.write(bytesSource.read());
+            }
+        }
+        REQUIRE(writtenData == testData);
+    }
+}
+
+#if VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+TEST_CASE("VirgilWriteBehindDataSink: rethrow sink error", "[prefetching-data-source]") {
+    FailingDataSink failingSink;
+    VirgilWriteBehindDataSink dataSink(failingSink);
+    dataSink.write(str2bytes("data"));
+    REQUIRE_THROWS_AS(dataSink.flush(), std::runtime_error);
+    REQUIRE_FALSE(dataSink.isGood());
+}
+#endif // VIRGIL_CRYPTO_FEATURE_MULTI_THREAD
+
+TEST_CASE("VirgilStreamCipher: encrypt and decrypt with prefetching", "[prefetching-data-source]") {
+    const VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    const VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+    const VirgilByteArray testData = make_test_data(1024 * 1024 + 1);
+
+    VirgilByteArray encryptedData;
+    {
+        VirgilBytesDataSource bytesSource(testData, 4096);
+        VirgilBytesDataSink bytesSink(encryptedData);
+        VirgilPrefetchingDataSource dataSource(bytesSource);
+        VirgilWriteBehindDataSink dataSink(bytesSink);
+        VirgilStreamCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(dataSource, dataSink, true);
+        dataSink.flush();
+    }
+
+    VirgilByteArray decryptedData;
+    {
+        VirgilBytesDataSource bytesSource(encryptedData, 4096);
+        VirgilBytesDataSink bytesSink(decryptedData);
+        VirgilPrefetchingDataSource dataSource(bytesSource);
+        VirgilWriteBehindDataSink dataSink(bytesSink);
+        VirgilStreamCipher cipher;
+        cipher.decryptWithKey(dataSource, dataSink, recipientId, keyPair.privateKey());
+        dataSink.flush();
+    }
+
+    REQUIRE(decryptedData == testData);
+}
+
+#endif // VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
@@ -0,0 +1,314 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_private_key_handle.cxx
+ * @brief Covers class VirgilPrivateKeyHandle
+ */
+
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+#include <virgil/crypto/VirgilCipher.h>
+#include <virgil/crypto/VirgilSeqCipher.h>
+#include <virgil/crypto/VirgilSigner.h>
+#include <virgil/crypto/VirgilSeqSigner.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+#include <virgil/crypto/VirgilStreamCipher.h>
+#include <virgil/crypto/VirgilChunkCipher.h>
+#include <virgil/crypto/VirgilStreamSigner.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#include <virgil/crypto/stream/VirgilBytesDataSink.h>
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::bytes_append;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilCipher;
+using virgil::crypto::VirgilSeqCipher;
+using virgil::crypto::VirgilSigner;
+using virgil::crypto::VirgilSeqSigner;
+using virgil::crypto::foundation::VirgilHash;
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+using virgil::crypto::VirgilStreamCipher;
+using virgil::crypto::VirgilChunkCipher;
+using virgil::crypto::VirgilStreamSigner;
+using virgil::crypto::stream::VirgilBytesDataSource;
+using virgil::crypto::stream::VirgilBytesDataSink;
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+
+TEST_CASE("VirgilPrivateKeyHandle: create", "[private-key-handle]") {
+    VirgilByteArray password = str2bytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended(password);
+
+    SECTION("with valid password") {
+        REQUIRE_NOTHROW(VirgilPrivateKeyHandle(keyPair.privateKey(), password));
+    }
+
+    SECTION("with wrong password") {
+        REQUIRE_THROWS(VirgilPrivateKeyHandle(keyPair.privateKey(), str2bytes("wrong")));
+    }
+
+    SECTION("with invalid key") {
+        REQUIRE_THROWS(VirgilPrivateKeyHandle(str2bytes("not a key")));
+    }
+}
+
+/**
+ * @brief Cipher that counts content encryption key decryptions with the parsed private key.
+ */
+class counting_cipher : public VirgilCipher {
+public:
+    mutable size_t decryptionsNum = 0;
+
+private:
+    VirgilByteArray doDecryptWithKey(
+            const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
+            const VirgilPrivateKeyHandle& privateKey) const override {
+        (void) algorithm;
+        ++decryptionsNum;
+        return privateKey.decrypt(encryptedKey);
+    }
+};
+
+TEST_CASE("VirgilPrivateKeyHandle: decrypt with ciphers", "[private-key-handle]") {
+    VirgilByteArray password = str2bytes("password");
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended(password);
+    VirgilPrivateKeyHandle privateKeyHandle(keyPair.privateKey(), password);
+
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+
+    SECTION("VirgilCipher") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+
+        VirgilCipher decCipher;
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(decCipher.decryptWithKey(encryptedData, recipientId, privateKeyHandle) == testData);
+        }
+        REQUIRE_THROWS(decCipher.decryptWithKey(encryptedData, str2bytes("unknown"), privateKeyHandle));
+
+        // Raw private key given after the handle must replace it.
+        VirgilKeyPair otherKeyPair = VirgilKeyPair::generateRecommended();
+        VirgilCipher otherCipher;
+        otherCipher.addKeyRecipient(recipientId, otherKeyPair.publicKey());
+        VirgilByteArray otherEncryptedData = otherCipher.encrypt(testData, true);
+        REQUIRE(decCipher.decryptWithKey(otherEncryptedData, recipientId, otherKeyPair.privateKey()) == testData);
+    }
+
+    SECTION("VirgilCipher subclass") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+
+        counting_cipher decCipher;
+        REQUIRE(decCipher.decryptWithKey(encryptedData, recipientId, privateKeyHandle) == testData);
+        REQUIRE(decCipher.decryptionsNum == 1);
+    }
+
+    SECTION("VirgilSeqCipher") {
+        VirgilSeqCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        VirgilByteArray encryptedData = cipher.startEncryption();
+        bytes_append(encryptedData, cipher.process(testData));
+        bytes_append(encryptedData, cipher.finish());
+
+        VirgilSeqCipher decCipher;
+        decCipher.startDecryptionWithKey(recipientId, privateKeyHandle);
+        VirgilByteArray decryptedData = decCipher.process(encryptedData);
+        bytes_append(decryptedData, decCipher.finish());
+        REQUIRE(decryptedData == testData);
+    }
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+    SECTION("VirgilStreamCipher") {
+        VirgilBytesDataSource testDataSource(testData);
+        VirgilByteArray encryptedData;
+        VirgilBytesDataSink encryptedDataSink(encryptedData);
+        VirgilStreamCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData);
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        VirgilStreamCipher decCipher;
+        decCipher.decryptWithKey(encryptedDataSource, decryptedDataSink, recipientId, privateKeyHandle);
+        REQUIRE(decryptedData == testData);
+    }
+
+    SECTION("VirgilChunkCipher") {
+        VirgilBytesDataSource testDataSource(testData);
+        VirgilByteArray encryptedData;
+        VirgilBytesDataSink encryptedDataSink(encryptedData);
+        VirgilChunkCipher cipher;
+        cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        cipher.encrypt(testDataSource, encryptedDataSink, true, 3);
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData);
+        VirgilByteArray decryptedData;
+        VirgilBytesDataSink decryptedDataSink(decryptedData);
+        VirgilChunkCipher decCipher;
+        decCipher.decryptWithKey(encryptedDataSource, decryptedDataSink, recipientId, privateKeyHandle);
+        REQUIRE(decryptedData == testData);
+    }
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+}
+
+TEST_CASE("VirgilPrivateKeyHandle: share between threads", "[private-key-handle]") {
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::RSA_2048);
+    const VirgilPrivateKeyHandle privateKeyHandle(keyPair.privateKey());
+
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    const VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+
+    constexpr size_t kThreadsNum = 4;
+    std::vector<VirgilByteArray> decryptedData(kThreadsNum);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreadsNum; ++i) {
+        threads.emplace_back([&, i]() {
+            VirgilCipher decCipher;
+            decryptedData[i] = decCipher.decryptWithKey(encryptedData, recipientId, privateKeyHandle);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& data : decryptedData) {
+        REQUIRE(data == testData);
+    }
+}
+
+static void test_sign_with_handle(VirgilKeyPair::Type keyType) {
+    VirgilByteArray password = str2bytes("password");
+    VirgilByteArray testData = str2bytes("this string will be signed");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType, password);
+    const VirgilPrivateKeyHandle privateKeyHandle(keyPair.privateKey(), password);
+
+    SECTION("with VirgilPrivateKeyHandle") {
+        VirgilHash hash(VirgilHash::Algorithm::SHA256);
+        REQUIRE_FALSE(privateKeyHandle.sign(hash.hash(testData), hash.type()).empty());
+    }
+
+    SECTION("with VirgilSigner") {
+        const VirgilSigner signer;
+        for (int i = 0; i < 3; ++i) {
+            VirgilByteArray sign = signer.sign(testData, privateKeyHandle);
+            REQUIRE(VirgilSigner().verify(testData, sign, keyPair.publicKey()));
+        }
+    }
+
+    SECTION("with VirgilSeqSigner") {
+        VirgilSeqSigner signer;
+        signer.startSigning();
+        signer.update(testData);
+        VirgilByteArray sign = signer.sign(privateKeyHandle);
+        REQUIRE(VirgilSigner().verify(testData, sign, keyPair.publicKey()));
+    }
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+    SECTION("with VirgilStreamSigner") {
+        const VirgilStreamSigner signer;
+        VirgilBytesDataSource testDataSource(testData);
+        VirgilByteArray sign = signer.sign(testDataSource, privateKeyHandle);
+        REQUIRE(VirgilSigner().verify(testData, sign, keyPair.publicKey()));
+    }
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+}
+
+TEST_CASE("VirgilPrivateKeyHandle: sign with signers", "[private-key-handle]") {
+    SECTION("Ed25519 key") {
+        test_sign_with_handle(VirgilKeyPair::Type::FAST_EC_ED25519);
+    }
+
+    SECTION("256-bits NIST curve key") {
+        test_sign_with_handle(VirgilKeyPair::Type::EC_SECP256R1);
+    }
+
+    SECTION("RSA 2048 key") {
+        test_sign_with_handle(VirgilKeyPair::Type::RSA_2048);
+    }
+}
+
+TEST_CASE("VirgilPrivateKeyHandle: sign in many threads", "[private-key-handle]") {
+    VirgilByteArray testData = str2bytes("this string will be signed");
+
+    for (auto keyType : { VirgilKeyPair::Type::FAST_EC_ED25519, VirgilKeyPair::Type::EC_SECP384R1,
+                          VirgilKeyPair::Type::RSA_2048 }) {
+        VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
+        const VirgilPrivateKeyHandle privateKeyHandle(keyPair.privateKey());
+        const VirgilSigner signer;
+
+        constexpr size_t kThreadsNum = 4;
+        constexpr size_t kSignsNum = 8;
+        std::vector<std::vector<VirgilByteArray>> signs(kThreadsNum);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kThreadsNum; ++i) {
+            threads.emplace_back([&, i]() {
+                for (size_t j = 0; j < kSignsNum; ++j) {
+                    signs[i].push_back(signer.sign(testData, privateKeyHandle));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        VirgilSigner verifier;
+        for (const auto& threadSigns : signs) {
+            REQUIRE(threadSigns.size() == kSignsNum);
+            for (const auto& sign : threadSigns) {
+                REQUIRE(verifier.verify(testData, sign, keyPair.publicKey()));
+            }
+        }
+    }
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_public_key_cache.cxx
+ * @brief Covers class VirgilPublicKeyCache
+ */
+
+#include "catch.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPublicKeyCache.h>
+#include <virgil/crypto/VirgilSigner.h>
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+#include <virgil/crypto/VirgilStreamSigner.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPublicKeyCache;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilSigner;
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+using virgil::crypto::VirgilStreamSigner;
+using virgil::crypto::stream::VirgilBytesDataSource;
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+
+TEST_CASE("VirgilPublicKeyCache: create", "[public-key-cache]") {
+    SECTION("with default capacity") {
+        VirgilPublicKeyCache cache;
+        REQUIRE(cache.getCapacity() == VirgilPublicKeyCache::kDefaultCapacity);
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.getHits() == 0);
+        REQUIRE(cache.getMisses() == 0);
+    }
+
+    SECTION("with zero capacity") {
+        REQUIRE_THROWS(VirgilPublicKeyCache(0));
+    }
+}
+
+TEST_CASE("VirgilPublicKeyCache: get keys", "[public-key-cache]") {
+    VirgilKeyPair aliceKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::EC_SECP256R1);
+    VirgilKeyPair johnKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilPublicKeyCache cache(2);
+
+    SECTION("count hits and misses") {
+        REQUIRE(cache.get(aliceKeyPair.publicKey()).getKey() == aliceKeyPair.publicKey());
+        REQUIRE(cache.get(aliceKeyPair.publicKey()).getKey() == aliceKeyPair.publicKey());
+        REQUIRE(cache.get(bobKeyPair.publicKey()).getKey() == bobKeyPair.publicKey());
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.getHits() == 1);
+        REQUIRE(cache.getMisses() == 2);
+    }
+
+    SECTION("evict the least recently used key") {
+        (void) cache.get(aliceKeyPair.publicKey());
+        (void) cache.get(bobKeyPair.publicKey());
+        (void) cache.get(aliceKeyPair.publicKey());
+        (void) cache.get(johnKeyPair.publicKey());
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.getMisses() == 3);
+
+        (void) cache.get(aliceKeyPair.publicKey());
+        REQUIRE(cache.getMisses() == 3);
+        (void) cache.get(bobKeyPair.publicKey());
+        REQUIRE(cache.getMisses() == 4);
+    }
+
+    SECTION("and clear") {
+        (void) cache.get(aliceKeyPair.publicKey());
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        (void) cache.get(aliceKeyPair.publicKey());
+        REQUIRE(cache.getMisses() == 2);
+    }
+
+    SECTION("with invalid key") {
+        REQUIRE_THROWS(cache.get(str2bytes("not a key")));
+        REQUIRE(cache.size() == 0);
+    }
+}
+
+TEST_CASE("VirgilPublicKeyCache: verify with signers", "[public-key-cache]") {
+    VirgilByteArray testData = str2bytes("this string will be signed");
+    VirgilByteArray malformedData = str2bytes("this string will is malformed");
+    auto cache = std::make_shared<VirgilPublicKeyCache>();
+
+    for (auto keyType : { VirgilKeyPair::Type::FAST_EC_ED25519, VirgilKeyPair::Type::RSA_2048 }) {
+        VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
+
+        VirgilSigner signer;
+        signer.setPublicKeyCache(cache);
+        REQUIRE(signer.getPublicKeyCache() == cache);
+        VirgilByteArray sign = signer.sign(testData, keyPair.privateKey());
+        REQUIRE(signer.verify(testData, sign, keyPair.publicKey()));
+        REQUIRE_FALSE(signer.verify(malformedData, sign, keyPair.publicKey()));
+        REQUIRE(signer.verify(testData, sign, keyPair.publicKey()));
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+        VirgilStreamSigner streamSigner;
+        streamSigner.setPublicKeyCache(cache);
+        VirgilBytesDataSource signDataSource(testData);
+        VirgilByteArray streamSign = streamSigner.sign(signDataSource, keyPair.privateKey());
+        VirgilBytesDataSource verifyDataSource(testData);
+        REQUIRE(streamSigner.verify(verifyDataSource, streamSign, keyPair.publicKey()));
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+    }
+
+    REQUIRE(cache->size() == 2);
+    REQUIRE(cache->getMisses() == 2);
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+    REQUIRE(cache->getHits() == 6);
+#else
+    REQUIRE(cache->getHits() == 4);
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
+}
+
+TEST_CASE("VirgilPublicKeyCache: share between threads", "[public-key-cache]") {
+    constexpr size_t kThreadsNum = 4;
+    constexpr size_t kKeysNum = 3;
+    constexpr size_t kRoundsNum = 8;
+
+    VirgilByteArray testData = str2bytes("this string will be signed");
+    std::vector<VirgilKeyPair> keyPairs;
+    std::vector<VirgilByteArray> signs;
+    for (size_t i = 0; i < kKeysNum; ++i) {
+        keyPairs.push_back(VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519));
+        signs.push_back(VirgilSigner().sign(testData, keyPairs.back().privateKey()));
+    }
+
+    auto cache = std::make_shared<VirgilPublicKeyCache>(2);
+    std::vector<int> verified(kThreadsNum, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreadsNum; ++i) {
+        threads.emplace_back([&, i]() {
+            VirgilSigner signer;
+            signer.setPublicKeyCache(cache);
+            for (size_t round = 0; round < kRoundsNum; ++round) {
+                const size_t keyIndex = (i + round) % kKeysNum;
+                verified[i] += signer.verify(testData, signs[keyIndex], keyPairs[keyIndex].publicKey()) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto result : verified) {
+        REQUIRE(result == static_cast<int>(kRoundsNum));
+    }
+    REQUIRE(cache->size() <= 2);
+    REQUIRE(cache->getHits() + cache->getMisses() == kThreadsNum * kRoundsNum);
+}
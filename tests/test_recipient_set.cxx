@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_recipient_set.cxx
+ * @brief Covers classes VirgilRecipientSet and VirgilPublicKeyHandle
+ */
+
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+#include <virgil/crypto/VirgilRecipientSet.h>
+#include <virgil/crypto/VirgilCipher.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilRecipientSet;
+using virgil::crypto::VirgilCipher;
+
+TEST_CASE("VirgilPublicKeyHandle: create", "[recipient-set]") {
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    SECTION("with valid key") {
+        VirgilPublicKeyHandle publicKeyHandle(keyPair.publicKey());
+        REQUIRE(publicKeyHandle.getKey() == keyPair.publicKey());
+        REQUIRE_FALSE(publicKeyHandle.getAlgorithm().empty());
+    }
+
+    SECTION("with invalid key") {
+        REQUIRE_THROWS(VirgilPublicKeyHandle(str2bytes("not a key")));
+    }
+}
+
+TEST_CASE("VirgilRecipientSet: manage recipients", "[recipient-set]") {
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+    VirgilRecipientSet recipients;
+
+    recipients.addKeyRecipient(str2bytes("alice"), keyPair.publicKey());
+    recipients.addKeyRecipient(str2bytes("bob"), VirgilPublicKeyHandle(keyPair.publicKey()));
+    REQUIRE(recipients.size() == 2);
+    REQUIRE(recipients.keyRecipientExists(str2bytes("alice")));
+
+    REQUIRE_THROWS(recipients.addKeyRecipient(str2bytes("alice"), keyPair.publicKey()));
+    REQUIRE_THROWS(recipients.addKeyRecipient(str2bytes("john"), str2bytes("not a key")));
+    REQUIRE_THROWS(recipients.addKeyRecipient(VirgilByteArray(), keyPair.publicKey()));
+
+    recipients.removeKeyRecipient(str2bytes("alice"));
+    REQUIRE_FALSE(recipients.keyRecipientExists(str2bytes("alice")));
+    REQUIRE(recipients.size() == 1);
+}
+
+TEST_CASE("VirgilRecipientSet: encrypt with ciphers", "[recipient-set]") {
+    VirgilByteArray aliceId = str2bytes("alice");
+    VirgilByteArray bobId = str2bytes("bob");
+    VirgilKeyPair aliceKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::RSA_2048);
+
+    VirgilRecipientSet recipients;
+    recipients.addKeyRecipient(aliceId, aliceKeyPair.publicKey());
+    recipients.addKeyRecipient(bobId, bobKeyPair.publicKey());
+
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+
+    SECTION("sequentially") {
+        for (int i = 0; i < 3; ++i) {
+            VirgilCipher cipher;
+            cipher.addKeyRecipients(recipients);
+            REQUIRE(cipher.keyRecipientExists(aliceId));
+            VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+
+            VirgilCipher aliceCipher;
+            REQUIRE(aliceCipher.decryptWithKey(encryptedData, aliceId, aliceKeyPair.privateKey()) == testData);
+            VirgilCipher bobCipher;
+            REQUIRE(bobCipher.decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+        }
+    }
+
+    SECTION("with recipient that already exists") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+        REQUIRE_THROWS(cipher.addKeyRecipients(recipients));
+        REQUIRE_FALSE(cipher.keyRecipientExists(aliceId));
+    }
+
+    SECTION("with removed recipient") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipients(recipients);
+        cipher.removeKeyRecipient(bobId);
+        REQUIRE_FALSE(cipher.keyRecipientExists(bobId));
+        cipher.addKeyRecipient(bobId, aliceKeyPair.publicKey());
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+
+        VirgilCipher bobCipher;
+        REQUIRE(bobCipher.decryptWithKey(encryptedData, bobId, aliceKeyPair.privateKey()) == testData);
+    }
+
+    SECTION("shared between threads") {
+        constexpr size_t kThreadsNum = 4;
+        std::vector<VirgilByteArray> encryptedData(kThreadsNum);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kThreadsNum; ++i) {
+            threads.emplace_back([&, i]() {
+                VirgilCipher cipher;
+                cipher.addKeyRecipients(recipients);
+                encryptedData[i] = cipher.encrypt(testData, true);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (const auto& data : encryptedData) {
+            VirgilCipher aliceCipher;
+            REQUIRE(aliceCipher.decryptWithKey(data, aliceId, aliceKeyPair.privateKey()) == testData);
+            VirgilCipher bobCipher;
+            REQUIRE(bobCipher.decryptWithKey(data, bobId, bobKeyPair.privateKey()) == testData);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_secure_allocator.cxx
+ * @brief Covers classes VirgilSecureArena and VirgilSecureAllocator
+ */
+
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilSecureAllocator.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilSecureArena;
+using virgil::crypto::VirgilSecureAllocator;
+using virgil::crypto::VirgilSecureByteArray;
+
+static bool is_zero(const void* ptr, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(ptr);
+    for (size_t i = 0; i < size; ++i) {
+        if (p[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Secure arena: allocate and release blocks", "[secure-allocator]") {
+    VirgilSecureArena arena;
+
+    SECTION("released block is zeroized and recycled without system allocations") {
+        auto block = static_cast<unsigned char*>(arena.allocate(32));
+        REQUIRE(block != nullptr);
+        REQUIRE(is_zero(block, 32));
+        std::fill(block, block + 32, 0xAB);
+        const auto systemAllocations = arena.stats().systemAllocations;
+
+        REQUIRE(arena.deallocate(block));
+        REQUIRE(is_zero(block, 32));
+
+        auto recycled = arena.allocate(32);
+        REQUIRE(recycled == block);
+        REQUIRE(arena.stats().systemAllocations == systemAllocations);
+        REQUIRE(arena.deallocate(recycled));
+    }
+
+    SECTION("blocks of the same size class share one region") {
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 100; ++i) {
+            blocks.push_back(arena.allocate(48));
+        }
+        REQUIRE(arena.stats().systemAllocations == 1);
+        REQUIRE(arena.stats().usedBlocks == 100);
+        REQUIRE(arena.stats().usedBytes == 100 * 64);
+        for (auto block : blocks) {
+            REQUIRE(arena.deallocate(block));
+        }
+        REQUIRE(arena.stats().usedBlocks == 0);
+        REQUIRE(arena.stats().usedBytes == 0);
+        REQUIRE(arena.stats().peakUsedBytes == 100 * 64);
+        REQUIRE(arena.stats().allocations == 100);
+    }
+
+    SECTION("large block is zeroized and recycled without system allocations") {
+        const size_t size = 100 * 1024;
+        auto block = static_cast<unsigned char*>(arena.allocate(size));
+        REQUIRE(is_zero(block, size));
+        REQUIRE(arena.stats().systemAllocations == 1);
+        REQUIRE(arena.stats().reservedBytes >= size);
+        REQUIRE(arena.stats().lockedBytes + (arena.stats().lockFailures > 0 ? size : 0) >= size);
+        std::fill(block, block + size, 0xAB);
+        REQUIRE_FALSE(arena.deallocate(block + 16));
+        REQUIRE(arena.deallocate(block));
+        REQUIRE(arena.stats().usedBytes == 0);
+
+        auto recycled = static_cast<unsigned char*>(arena.allocate(size - 1024));
+        REQUIRE(recycled == block);
+        REQUIRE(is_zero(recycled, size));
+        REQUIRE(arena.stats().systemAllocations == 1);
+        REQUIRE(arena.deallocate(recycled));
+    }
+
+    SECTION("capacity is limited") {
+        VirgilSecureArena smallArena(64 * 1024, 128 * 1024);
+        void* block = smallArena.allocate(128 * 1024);
+        REQUIRE_THROWS_AS(smallArena.allocate(16), std::bad_alloc);
+        REQUIRE(smallArena.deallocate(block));
+    }
+
+    SECTION("foreign pointer is not released") {
+        VirgilSecureArena otherArena;
+        auto block = otherArena.allocate(16);
+        int value = 0;
+        REQUIRE_FALSE(arena.deallocate(block));
+        REQUIRE_FALSE(arena.deallocate(&value));
+        REQUIRE(arena.deallocate(nullptr));
+        REQUIRE(otherArena.deallocate(block));
+    }
+}
+
+TEST_CASE("Secure arena: concurrent allocations", "[secure-allocator]") {
+    VirgilSecureArena arena;
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < 4; ++threadIndex) {
+        threads.emplace_back([&arena]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                const size_t size = 16 + (i % 128) * 8;
+                auto block = static_cast<unsigned char*>(arena.allocate(size));
+                std::fill(block, block + size, 0xCD);
+                arena.deallocate(block);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(arena.stats().usedBlocks == 0);
+    REQUIRE(arena.stats().allocations == 4000);
+}
+
+TEST_CASE("Secure allocator: byte array", "[secure-allocator]") {
+    VirgilSecureArena arena;
+    const VirgilByteArray key = str2bytes("content encryption key");
+
+    VirgilSecureByteArray secureKey(key.begin(), key.end(), VirgilSecureAllocator<unsigned char>(arena));
+    REQUIRE(VirgilByteArray(secureKey.begin(), secureKey.end()) == key);
+    REQUIRE(arena.stats().usedBlocks == 1);
+
+    secureKey.clear();
+    secureKey.shrink_to_fit();
+    REQUIRE(arena.stats().usedBlocks == 0);
+
+    VirgilSecureByteArray defaultKey(key.begin(), key.end());
+    REQUIRE(defaultKey.get_allocator().arena() == &VirgilSecureArena::defaultArena());
+}
@@ -42,6 +42,8 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilSeqCipher.h>
 #include <virgil/crypto/VirgilKeyPair.h>
@@ -118,3 +120,66 @@ TEST_CASE("VirgilSeqCipher: encrypt and decrypt with generated keys", "[seq-ciph
         REQUIRE(testData == decryptedData);
     }
 }
+
+TEST_CASE("VirgilSeqCipher: encrypt and decrypt with caller-provided buffers", "[seq-cipher]") {
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generateRecommended();
+
+    const size_t kChunkSize = 100;
+    const size_t kReserveSize = 32;
+    VirgilByteArray testData(10 * kChunkSize + 7, 0xAB);
+    VirgilByteArray buffer(kChunkSize + kReserveSize);
+
+    VirgilSeqCipher encCipher;
+    encCipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    VirgilByteArray contentInfo = encCipher.startEncryption();
+
+    VirgilByteArray encryptedData;
+    for (size_t offset = 0; offset < testData.size(); offset += kChunkSize) {
+        const size_t chunkSize = std::min(kChunkSize, testData.size() - offset);
+        size_t written = 0;
+        REQUIRE_NOTHROW(written = encCipher.process(testData.data() + offset, chunkSize, buffer.data(), buffer.size()));
+        encryptedData.insert(encryptedData.end(), buffer.begin(), buffer.begin() + written);
+    }
+    size_t written = 0;
+    REQUIRE_NOTHROW(written = encCipher.finish(buffer.data(), buffer.size()));
+    encryptedData.insert(encryptedData.end(), buffer.begin(), buffer.begin() + written);
+
+    SECTION("decrypted with caller-provided buffers") {
+        VirgilSeqCipher decCipher;
+        decCipher.setContentInfo(contentInfo);
+        decCipher.startDecryptionWithKey(recipientId, keyPair.privateKey());
+
+        VirgilByteArray decryptedData;
+        for (size_t offset = 0; offset < encryptedData.size(); offset += kChunkSize) {
+            const size_t chunkSize = std::min(kChunkSize, encryptedData.size() - offset);
+            REQUIRE_NOTHROW(
+                written = decCipher.process(encryptedData.data() + offset, chunkSize, buffer.data(), buffer.size())
+            );
+            decryptedData.insert(decryptedData.end(), buffer.begin(), buffer.begin() + written);
+        }
+        REQUIRE_NOTHROW(written = decCipher.finish(buffer.data(), buffer.size()));
+        decryptedData.insert(decryptedData.end(), buffer.begin(), buffer.begin() + written);
+
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("decrypted with returned byte arrays") {
+        VirgilSeqCipher decCipher;
+        decCipher.setContentInfo(contentInfo);
+        decCipher.startDecryptionWithKey(recipientId, keyPair.privateKey());
+
+        VirgilByteArray decryptedData = decCipher.process(encryptedData);
+        bytes_append(decryptedData, decCipher.finish());
+
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("and too small output buffer") {
+        VirgilSeqCipher decCipher;
+        decCipher.setContentInfo(contentInfo);
+        decCipher.startDecryptionWithKey(recipientId, keyPair.privateKey());
+
+        REQUIRE_THROWS(decCipher.process(encryptedData.data(), kChunkSize, buffer.data(), kChunkSize));
+    }
+}
@@ -44,13 +44,30 @@
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilSigner.h>
 #include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
 #include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+#include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
+
+#include "VirgilEd25519BatchVerifier.h"
+
+#include <string>
+#include <thread>
+#include <vector>
 
 using virgil::crypto::str2bytes;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilSigner;
 using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
 using virgil::crypto::VirgilCryptoException;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
+using virgil::crypto::internal::VirgilEd25519BatchVerifier;
 
 static void test_sign_verify(const VirgilKeyPair& keyPair, const VirgilByteArray& keyPassword = VirgilByteArray()) {
     VirgilByteArray testData = str2bytes("this string will be signed");
@@ -109,3 +126,165 @@ TEST_CASE("VirgilSigner: sign with wrong key password", "[signer]") {
     VirgilSigner signer;
     REQUIRE_THROWS_AS(signer.sign(testData, keyPair.privateKey(), wrongKeyPassword), VirgilCryptoException);
 }
+
+TEST_CASE("VirgilSigner: batch verification", "[signer]") {
+    std::vector<VirgilKeyPair> keyPairs = {
+            VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519),
+            VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519),
+            VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519),
+            VirgilKeyPair::generate(VirgilKeyPair::Type::EC_SECP256R1)
+    };
+
+    std::vector<VirgilSigner::BatchItem> items;
+    for (size_t i = 0; i < 37; ++i) {
+        const auto& keyPair = keyPairs[i % keyPairs.size()];
+        VirgilSigner signer(i % 2 == 0 ? VirgilHash::Algorithm::SHA384 : VirgilHash::Algorithm::SHA256);
+        VirgilByteArray data = str2bytes("data to be signed #" + std::to_string(i));
+        VirgilByteArray sign = signer.sign(data, keyPair.privateKey());
+        items.push_back({ data, sign, keyPair.publicKey() });
+    }
+
+    VirgilSigner signer;
+
+    SECTION("with no items") {
+        REQUIRE(signer.verifyBatch({}).empty());
+    }
+
+    SECTION("with valid signs") {
+        REQUIRE(signer.verifyBatch(items).empty());
+        for (const auto& item : items) {
+            REQUIRE(signer.verify(item.data, item.sign, item.publicKey));
+        }
+    }
+
+    SECTION("with malformed data") {
+        items[4].data = str2bytes("this string is malformed");
+        items[17].data = str2bytes("this string is malformed");
+        items[30].data = str2bytes("this string is malformed");
+        REQUIRE(signer.verifyBatch(items) == std::vector<size_t>({ 4, 17, 30 }));
+    }
+
+    SECTION("with sign of another key") {
+        items[5].publicKey = items[6].publicKey;
+        items[7].publicKey = items[4].publicKey;
+        REQUIRE(signer.verifyBatch(items) == std::vector<size_t>({ 5, 7 }));
+    }
+
+    SECTION("with malformed sign and public key") {
+        items[1].sign = str2bytes("I am malformed sign");
+        items[2].publicKey = str2bytes("I am malformed public key");
+        REQUIRE(signer.verifyBatch(items) == std::vector<size_t>({ 1, 2 }));
+    }
+
+    SECTION("with the single malformed item") {
+        items.resize(1);
+        items[0].data = str2bytes("this string is malformed");
+        REQUIRE(signer.verifyBatch(items) == std::vector<size_t>({ 0 }));
+    }
+}
+
+TEST_CASE("VirgilSigner: Ed25519 signs are accepted by the batch verifier", "[signer]") {
+    // Raw signs and keys are extracted the same way as VirgilSigner::verifyBatch() does,
+    // so a format mismatch that silently falls back to the individual verification is detected.
+    std::vector<VirgilKeyPair> keyPairs = {
+            VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519),
+            VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519)
+    };
+
+    VirgilEd25519BatchVerifier batch;
+    for (size_t i = 0; i < 9; ++i) {
+        const auto& keyPair = keyPairs[i % keyPairs.size()];
+        const auto hashAlgorithm = i % 2 == 0 ? VirgilHash::Algorithm::SHA384 : VirgilHash::Algorithm::SHA512;
+        VirgilSigner signer(hashAlgorithm);
+        VirgilByteArray data = str2bytes("data to be signed #" + std::to_string(i));
+        VirgilByteArray sign = signer.sign(data, keyPair.privateKey());
+
+        VirgilAsn1Reader asn1Reader(sign);
+        (void) asn1Reader.readSequence();
+        (void) asn1Reader.readData(); // Hash algorithm
+        const VirgilByteArray rawSign = asn1Reader.readOctetString();
+        REQUIRE(rawSign.size() == VirgilEd25519BatchVerifier::kSignatureSize);
+
+        VirgilAsymmetricCipher publicContext;
+        publicContext.setPublicKey(keyPair.publicKey());
+        const VirgilByteArray rawPublicKey = publicContext.getPublicKeyBits();
+        REQUIRE(rawPublicKey.size() == VirgilEd25519BatchVerifier::kPublicKeySize);
+
+        const VirgilByteArray digest = VirgilHash(hashAlgorithm).hash(data);
+        REQUIRE(batch.add(rawPublicKey, rawSign, digest));
+        if (i == 7) {
+            // Valid sign of the other message
+            REQUIRE(batch.add(rawPublicKey, rawSign, VirgilHash(hashAlgorithm).hash(str2bytes("other data"))));
+        }
+    }
+
+    REQUIRE(batch.size() == 10);
+    REQUIRE(batch.verify(0, 8));
+    REQUIRE_FALSE(batch.verify(0, 10));
+    REQUIRE_FALSE(batch.verify(8, 1));
+    REQUIRE(batch.verify(9, 1));
+}
+
+static void test_share_between_threads(VirgilKeyPair::Type keyType) {
+    constexpr size_t kThreadsNum = 4;
+    constexpr size_t kRoundsNum = 8;
+
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
+    const VirgilPrivateKeyHandle privateKey(keyPair.privateKey());
+    const VirgilPublicKeyHandle publicKey(keyPair.publicKey());
+
+    VirgilSigner signer(VirgilHash::Algorithm::SHA256);
+    signer.setTreeHashLeafSize(16);
+    const VirgilSigner& sharedSigner = signer;
+
+    std::vector<size_t> verified(kThreadsNum, 0);
+    std::vector<size_t> rejected(kThreadsNum, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreadsNum; ++i) {
+        threads.emplace_back([&, i]() {
+            for (size_t round = 0; round < kRoundsNum; ++round) {
+                VirgilByteArray data = str2bytes("data to be signed by thread #" + std::to_string(i));
+                VirgilByteArray sign = sharedSigner.sign(data, privateKey);
+                verified[i] += sharedSigner.verify(data, sign, publicKey) ? 1 : 0;
+                data.back() ^= 0x01;
+                rejected[i] += sharedSigner.verify(data, sign, publicKey) ? 0 : 1;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < kThreadsNum; ++i) {
+        REQUIRE(verified[i] == kRoundsNum);
+        REQUIRE(rejected[i] == kRoundsNum);
+    }
+}
+
+TEST_CASE("VirgilSigner: sign and verify with key handles", "[signer]") {
+    VirgilByteArray testData = str2bytes("this string will be signed");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    const VirgilPublicKeyHandle publicKey(keyPair.publicKey());
+
+    SECTION("verify sign made with raw key") {
+        VirgilSigner signer(VirgilHash::Algorithm::SHA512);
+        VirgilByteArray sign = signer.sign(testData, keyPair.privateKey());
+        const VirgilSigner verifier;
+        REQUIRE(verifier.verify(testData, sign, publicKey));
+        REQUIRE(verifier.getHashAlgorithm() == VirgilHash::Algorithm::SHA384);
+        REQUIRE_FALSE(verifier.verify(str2bytes("malformed data"), sign, publicKey));
+        REQUIRE_THROWS_AS(verifier.verify(testData, str2bytes("malformed sign"), publicKey), VirgilCryptoException);
+    }
+
+    SECTION("share between threads with Ed25519 key") {
+        test_share_between_threads(VirgilKeyPair::Type::FAST_EC_ED25519);
+    }
+
+    SECTION("share between threads with 256-bits NIST curve key") {
+        test_share_between_threads(VirgilKeyPair::Type::EC_SECP256R1);
+    }
+
+    SECTION("share between threads with RSA 2048 key") {
+        test_share_between_threads(VirgilKeyPair::Type::RSA_2048);
+    }
+}
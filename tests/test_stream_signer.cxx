@@ -0,0 +1,208 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_stream_signer.cxx
+ * @brief Covers class VirgilStreamSigner
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+#include <virgil/crypto/VirgilSigner.h>
+#include <virgil/crypto/VirgilStreamSigner.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+
+#include <algorithm>
+#include <limits>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoException;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilSigner;
+using virgil::crypto::VirgilStreamSigner;
+using virgil::crypto::stream::VirgilBytesDataSource;
+
+static VirgilByteArray make_test_data(size_t size) {
+    VirgilByteArray data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+    return data;
+}
+
+static VirgilByteArray stream_sign(
+        VirgilStreamSigner& signer, const VirgilByteArray& data, const VirgilKeyPair& keyPair, size_t readSize) {
+    VirgilBytesDataSource source(data, readSize);
+    return signer.sign(source, keyPair.privateKey());
+}
+
+static bool stream_verify(
+        VirgilStreamSigner& signer, const VirgilByteArray& data, const VirgilByteArray& sign,
+        const VirgilKeyPair& keyPair, size_t readSize) {
+    VirgilBytesDataSource source(data, readSize);
+    return signer.verify(source, sign, keyPair.publicKey());
+}
+
+TEST_CASE("VirgilStreamSigner: sign and verify", "[stream-signer]") {
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+    VirgilByteArray testData = make_test_data(10000);
+
+    VirgilStreamSigner signer;
+    VirgilByteArray sign = stream_sign(signer, testData, keyPair, 333);
+
+    SECTION("verify with the original data") {
+        REQUIRE(stream_verify(signer, testData, sign, keyPair, 1000));
+    }
+
+    SECTION("verify with the in-memory signer") {
+        REQUIRE(VirgilSigner().verify(testData, sign, keyPair.publicKey()));
+    }
+
+    SECTION("verify with the preloaded public key") {
+        const VirgilStreamSigner verifier;
+        VirgilBytesDataSource source(testData, 1000);
+        REQUIRE(verifier.verify(source, sign, VirgilPublicKeyHandle(keyPair.publicKey())));
+    }
+
+    SECTION("verify with malformed data") {
+        testData[5000] ^= 0x01;
+        REQUIRE_FALSE(stream_verify(signer, testData, sign, keyPair, 1000));
+    }
+}
+
+TEST_CASE("VirgilStreamSigner: tree hashing", "[stream-signer]") {
+    constexpr size_t kLeafSize = 1024;
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+
+    SECTION("is disabled by default") {
+        REQUIRE(VirgilStreamSigner().getTreeHashLeafSize() == 0);
+    }
+
+    SECTION("rejects leaf size out of the range") {
+        VirgilStreamSigner signer;
+        REQUIRE_THROWS_AS(signer.setTreeHashLeafSize(1), VirgilCryptoException);
+        REQUIRE_THROWS_AS(signer.setTreeHashLeafSize(1023), VirgilCryptoException);
+        REQUIRE_THROWS_AS(signer.setTreeHashLeafSize(16 * 1024 * 1024 + 1), VirgilCryptoException);
+        REQUIRE_THROWS_AS(
+                signer.setTreeHashLeafSize(static_cast<size_t>(std::numeric_limits<int>::max()) + 1),
+                VirgilCryptoException);
+        REQUIRE_NOTHROW(signer.setTreeHashLeafSize(16 * 1024 * 1024));
+        REQUIRE_NOTHROW(signer.setTreeHashLeafSize(0));
+    }
+
+    SECTION("rejects signature with leaf size out of the range") {
+        VirgilByteArray testData = make_test_data(3 * kLeafSize);
+        VirgilStreamSigner signer;
+        signer.setTreeHashLeafSize(kLeafSize);
+        VirgilByteArray sign = stream_sign(signer, testData, keyPair, 1000);
+
+        // Replace INTEGER 1024 with INTEGER 1023 within VirgilTreeHashParams
+        const VirgilByteArray leafSizeAsn1 = { 0x02, 0x02, 0x04, 0x00 };
+        auto leafSizeIt = std::search(sign.begin(), sign.end(), leafSizeAsn1.begin(), leafSizeAsn1.end());
+        REQUIRE(leafSizeIt != sign.end());
+        *(leafSizeIt + 2) = 0x03;
+        *(leafSizeIt + 3) = 0xFF;
+
+        VirgilStreamSigner verifier;
+        REQUIRE_THROWS_AS(stream_verify(verifier, testData, sign, keyPair, 1000), VirgilCryptoException);
+        REQUIRE_THROWS_AS(VirgilSigner().verify(testData, sign, keyPair.publicKey()), VirgilCryptoException);
+    }
+
+    SECTION("sign and verify data of different sizes") {
+        for (size_t dataSize : { 0, 1, 1023, 1024, 1025, 2048, 5 * 1024 + 17, 33 * 1024 }) {
+            for (size_t threadsNum : { 1, 4 }) {
+                VirgilByteArray testData = make_test_data(dataSize);
+                VirgilStreamSigner signer;
+                signer.setTreeHashLeafSize(kLeafSize);
+                signer.setTreeHashThreadsNum(threadsNum);
+                VirgilByteArray sign = stream_sign(signer, testData, keyPair, 700);
+
+                // Verifier selects tree hashing from the signature
+                VirgilStreamSigner verifier;
+                verifier.setTreeHashThreadsNum(3);
+                REQUIRE(stream_verify(verifier, testData, sign, keyPair, 4096));
+                REQUIRE(verifier.getTreeHashLeafSize() == 0);
+                REQUIRE(VirgilSigner().verify(testData, sign, keyPair.publicKey()));
+
+                if (!testData.empty()) {
+                    testData.back() ^= 0x01;
+                    REQUIRE_FALSE(stream_verify(verifier, testData, sign, keyPair, 4096));
+                }
+            }
+        }
+    }
+
+    SECTION("signature does not depend on the number of threads and source read size") {
+        VirgilByteArray testData = make_test_data(20 * kLeafSize + 5);
+        VirgilStreamSigner signer;
+        signer.setTreeHashLeafSize(kLeafSize);
+        signer.setTreeHashThreadsNum(1);
+        VirgilByteArray sequentialSign = stream_sign(signer, testData, keyPair, 100);
+        signer.setTreeHashThreadsNum(8);
+        VirgilByteArray parallelSign = stream_sign(signer, testData, keyPair, 5000);
+        REQUIRE(sequentialSign == parallelSign);
+    }
+
+    SECTION("verification does not change configured leaf size") {
+        VirgilByteArray testData = make_test_data(3 * kLeafSize);
+        VirgilStreamSigner signer;
+        VirgilByteArray sequentialSign = stream_sign(signer, testData, keyPair, 1000);
+        signer.setTreeHashLeafSize(2 * kLeafSize);
+        REQUIRE(stream_verify(signer, testData, sequentialSign, keyPair, 1000));
+        REQUIRE(signer.getTreeHashLeafSize() == 2 * kLeafSize);
+        VirgilByteArray treeSign = stream_sign(signer, testData, keyPair, 1000);
+        REQUIRE(treeSign != sequentialSign);
+        REQUIRE(stream_verify(signer, testData, treeSign, keyPair, 1000));
+    }
+
+    SECTION("tree signature does not match the sequential digest") {
+        VirgilByteArray testData = make_test_data(3 * kLeafSize);
+        VirgilStreamSigner signer;
+        signer.setTreeHashLeafSize(kLeafSize);
+        VirgilByteArray treeSign = stream_sign(signer, testData, keyPair, 1000);
+        signer.setTreeHashLeafSize(0);
+        VirgilByteArray sequentialSign = stream_sign(signer, testData, keyPair, 1000);
+        REQUIRE(treeSign != sequentialSign);
+        REQUIRE(stream_verify(signer, testData, sequentialSign, keyPair, 1000));
+        REQUIRE(signer.getTreeHashLeafSize() == 0);
+    }
+}
@@ -45,6 +45,10 @@
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
 #include <virgil/crypto/foundation/VirgilRandom.h>
 
+#include "VirgilChaCha20Poly1305.h"
+
+#include <algorithm>
+
 using virgil::crypto::str2bytes;
 using virgil::crypto::hex2bytes;
 using virgil::crypto::bytes2str;
@@ -52,6 +56,7 @@ using virgil::crypto::bytes2hex;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 using virgil::crypto::foundation::VirgilRandom;
+using virgil::crypto::foundation::internal::VirgilChaCha20Poly1305;
 
 static void test_symmetric_cipher(VirgilSymmetricCipher::Algorithm algorithm) {
     VirgilByteArray plainData = str2bytes("data to be encrypted with symmetric cipher");
@@ -93,6 +98,7 @@ static void test_symmetric_cipher(VirgilSymmetricCipher::Algorithm algorithm) {
             cipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
         }
         VirgilByteArray encryptedData = cipher.crypt(plainData, iv);
+        REQUIRE(encryptedData.size() == cipher.defineEncryptedSize(plainData.size()));
         // Decrypt
         cipher.clear();
         cipher.setDecryptionKey(key);
@@ -119,5 +125,222 @@ TEST_CASE("Symmetric Cipher", "[symmetric-cipher]") {
     SECTION("AES-256-GCM") {
         test_symmetric_cipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM);
     }
+    SECTION("CHACHA20-POLY1305") {
+        test_symmetric_cipher(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305);
+    }
+
+}
+
+/**
+ * @brief Check AEAD cipher against the known test vector, and check that corrupted tag is rejected.
+ */
+static void test_aead_vector(
+        VirgilSymmetricCipher::Algorithm algorithm, const char* key, const char* iv, const char* plainText,
+        const char* authData, const char* cipherText, const char* tag) {
+    const VirgilByteArray expectedEncryptedData = hex2bytes(std::string(cipherText) + tag);
+
+    VirgilSymmetricCipher cipher(algorithm);
+    cipher.setEncryptionKey(hex2bytes(key));
+    cipher.setAuthData(hex2bytes(authData));
+    REQUIRE(bytes2hex(cipher.crypt(hex2bytes(plainText), hex2bytes(iv))) == bytes2hex(expectedEncryptedData));
+
+    VirgilSymmetricCipher decipher(algorithm);
+    decipher.setDecryptionKey(hex2bytes(key));
+    decipher.setAuthData(hex2bytes(authData));
+    REQUIRE(bytes2hex(decipher.crypt(expectedEncryptedData, hex2bytes(iv))) == plainText);
+
+    VirgilByteArray corruptedEncryptedData = expectedEncryptedData;
+    corruptedEncryptedData.back() ^= 0x01;
+    REQUIRE_THROWS(decipher.crypt(corruptedEncryptedData, hex2bytes(iv)));
+}
+
+TEST_CASE("Symmetric Cipher: GCM test vectors", "[symmetric-cipher]") {
+    const char* plainText =
+            "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+    const char* authData = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+
+    SECTION("AES-128-GCM with 96-bit IV") {
+        test_aead_vector(VirgilSymmetricCipher::Algorithm::AES_128_GCM,
+                "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", plainText, authData,
+                "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+                "5bc94fbc3221a5db94fae95ae7121a47");
+    }
+    SECTION("AES-128-GCM with empty plain text") {
+        test_aead_vector(VirgilSymmetricCipher::Algorithm::AES_128_GCM,
+                "00000000000000000000000000000000", "000000000000000000000000", "", "",
+                "", "58e2fccefa7e3061367f1d57a4e7455a");
+    }
+    SECTION("AES-256-GCM with 96-bit IV") {
+        test_aead_vector(VirgilSymmetricCipher::Algorithm::AES_256_GCM,
+                "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+                plainText, authData,
+                "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+                "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+                "76fc6ece0f4e1768cddf8853bb2d551b");
+    }
+    SECTION("AES-256-GCM with 64-bit IV") {
+        test_aead_vector(VirgilSymmetricCipher::Algorithm::AES_256_GCM,
+                "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", "cafebabefacedbad",
+                plainText, authData,
+                "c3762df1ca787d32ae47c13bf19844cbaf1ae14d0b976afac52ff7d79bba9de0"
+                "feb582d33934a4f0954cc2363bc73f7862ac430e64abe499f47c9b1f",
+                "3a337dbf46a792c45e454913fe2ea8f2");
+    }
+}
+
+TEST_CASE("Symmetric Cipher: ChaCha20-Poly1305 test vectors", "[symmetric-cipher]") {
+    SECTION("RFC 8439, section 2.8.2") {
+        test_aead_vector(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305,
+                "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", "070000004041424344454647",
+                "4c616469657320616e642047656e746c656d656e206f662074686520636c6173"
+                "73206f66202739393a204966204920636f756c64206f6666657220796f75206f"
+                "6e6c79206f6e652074697020666f7220746865206675747572652c2073756e73"
+                "637265656e20776f756c642062652069742e",
+                "50515253c0c1c2c3c4c5c6c7",
+                "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+                "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+                "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+                "3ff4def08e4b7a9de576d26586cec64b6116",
+                "1ae10b594f09e26a7e902ecbd0600691");
+    }
+}
+
+TEST_CASE("Symmetric Cipher: AEAD rejects truncated cipher text", "[symmetric-cipher]") {
+    VirgilRandom random(str2bytes("test_symmetric_cipher"));
+    const VirgilByteArray plainData = random.randomize(100);
+
+    for (auto algorithm : { VirgilSymmetricCipher::Algorithm::AES_128_GCM,
+                            VirgilSymmetricCipher::Algorithm::AES_256_GCM,
+                            VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305 }) {
+        VirgilSymmetricCipher cipher(algorithm);
+        const VirgilByteArray key = random.randomize(cipher.keyLength());
+        const VirgilByteArray iv = random.randomize(cipher.ivSize());
+        cipher.setEncryptionKey(key);
+        const VirgilByteArray encryptedData = cipher.crypt(plainData, iv);
 
+        VirgilSymmetricCipher decipher(algorithm);
+        decipher.setDecryptionKey(key);
+        REQUIRE(decipher.crypt(encryptedData, iv) == plainData);
+        for (size_t truncatedSize : { size_t(0), size_t(1), decipher.authTagLength() - 1,
+                                      encryptedData.size() - 1 }) {
+            const VirgilByteArray truncatedData(encryptedData.begin(), encryptedData.begin() + truncatedSize);
+            REQUIRE_THROWS(decipher.crypt(truncatedData, iv));
+        }
+    }
+}
+
+static VirgilByteArray chacha_poly_crypt(
+        size_t kernelIndex, bool isEncryption, const VirgilByteArray& key, const VirgilByteArray& nonce,
+        const VirgilByteArray& authData, const VirgilByteArray& input, size_t partSize) {
+    VirgilChaCha20Poly1305 chachaPoly;
+    REQUIRE(chachaPoly.setKernel(kernelIndex));
+    REQUIRE(chachaPoly.setKey(key.data(), key.size()));
+    REQUIRE(chachaPoly.start(nonce.data(), nonce.size(), authData.data(), authData.size(), isEncryption));
+    VirgilByteArray output(input.size() + VirgilChaCha20Poly1305::kTagSize);
+    for (size_t offset = 0; offset < input.size(); offset += partSize) {
+        const size_t len = std::min(partSize, input.size() - offset);
+        REQUIRE(chachaPoly.update(input.data() + offset, len, output.data() + offset));
+    }
+    REQUIRE(chachaPoly.finish(output.data() + input.size(), VirgilChaCha20Poly1305::kTagSize));
+    return output;
+}
+
+TEST_CASE("Symmetric Cipher: ChaCha20-Poly1305 kernels", "[symmetric-cipher]") {
+    // RFC 8439, section 2.8.2
+    const VirgilByteArray key = hex2bytes("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f");
+    const VirgilByteArray nonce = hex2bytes("070000004041424344454647");
+    const VirgilByteArray authData = hex2bytes("50515253c0c1c2c3c4c5c6c7");
+    const VirgilByteArray plainText = hex2bytes(
+            "4c616469657320616e642047656e746c656d656e206f662074686520636c6173"
+            "73206f66202739393a204966204920636f756c64206f6666657220796f75206f"
+            "6e6c79206f6e652074697020666f7220746865206675747572652c2073756e73"
+            "637265656e20776f756c642062652069742e");
+    const VirgilByteArray cipherText = hex2bytes(
+            "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+            "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+            "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+            "3ff4def08e4b7a9de576d26586cec64b6116");
+    const std::string expectedTag = "1ae10b594f09e26a7e902ecbd0600691";
+
+    VirgilRandom random(str2bytes("test_symmetric_cipher"));
+    const VirgilByteArray longPlainText = random.randomize(4096 + 17);
+    const size_t portableKernelIndex = VirgilChaCha20Poly1305::kernelCount() - 1;
+    REQUIRE(std::string(VirgilChaCha20Poly1305::kernelName(portableKernelIndex)) == "portable");
+    const VirgilByteArray expectedLongCipherText =
+            chacha_poly_crypt(portableKernelIndex, true, key, nonce, authData, longPlainText, longPlainText.size());
+
+    for (size_t kernelIndex = 0; kernelIndex < VirgilChaCha20Poly1305::kernelCount(); ++kernelIndex) {
+        INFO("Kernel: " << VirgilChaCha20Poly1305::kernelName(kernelIndex));
+        for (size_t partSize : { size_t(1), size_t(63), size_t(64), size_t(1000) }) {
+            INFO("Part size: " << partSize);
+            REQUIRE(bytes2hex(chacha_poly_crypt(kernelIndex, true, key, nonce, authData, plainText, partSize)) ==
+                    bytes2hex(cipherText) + expectedTag);
+            const VirgilByteArray decrypted =
+                    chacha_poly_crypt(kernelIndex, false, key, nonce, authData, cipherText, partSize);
+            REQUIRE(bytes2hex(decrypted) == bytes2hex(plainText) + expectedTag);
+            REQUIRE(chacha_poly_crypt(kernelIndex, true, key, nonce, authData, longPlainText, partSize) ==
+                    expectedLongCipherText);
+        }
+    }
+    REQUIRE_FALSE(VirgilChaCha20Poly1305().setKernel(VirgilChaCha20Poly1305::kernelCount()));
+}
+
+TEST_CASE("Symmetric Cipher: ChaCha20-Poly1305 info", "[symmetric-cipher]") {
+    VirgilSymmetricCipher cipher(VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305);
+    REQUIRE(cipher.isInited());
+    REQUIRE(cipher.name() == "CHACHA20-POLY1305");
+    REQUIRE(cipher.keyLength() == 32);
+    REQUIRE(cipher.ivSize() == 12);
+    REQUIRE(cipher.authTagLength() == 16);
+    REQUIRE(cipher.isAuthMode());
+    REQUIRE_FALSE(cipher.isSupportPadding());
+    REQUIRE(cipher.defineEncryptedSize(100) == 116);
+    REQUIRE_THROWS(cipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7));
+    REQUIRE_THROWS(cipher.setIV(VirgilByteArray(16)));
+    REQUIRE_THROWS(cipher.setEncryptionKey(VirgilByteArray(16)));
+
+    SECTION("is restored from ASN.1") {
+        cipher.setIV(VirgilByteArray(12, 0xAB));
+        VirgilSymmetricCipher restoredCipher;
+        restoredCipher.fromAsn1(cipher.toAsn1());
+        REQUIRE(restoredCipher.name() == cipher.name());
+        REQUIRE(restoredCipher.iv() == cipher.iv());
+    }
+
+    SECTION("is created by name") {
+        REQUIRE(VirgilSymmetricCipher("CHACHA20-POLY1305").name() == cipher.name());
+    }
+}
+
+TEST_CASE("Symmetric Cipher: AEAD with data split to the parts", "[symmetric-cipher]") {
+    VirgilRandom random(str2bytes("test_symmetric_cipher"));
+    const VirgilByteArray plainData = random.randomize(1000);
+
+    for (auto algorithm : { VirgilSymmetricCipher::Algorithm::AES_128_GCM,
+                            VirgilSymmetricCipher::Algorithm::AES_256_GCM,
+                            VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305 }) {
+        VirgilSymmetricCipher cipher(algorithm);
+        const VirgilByteArray key = random.randomize(cipher.keyLength());
+        const VirgilByteArray iv = random.randomize(cipher.ivSize());
+
+        // Encrypt by the parts, that are multiple of the block size
+        cipher.setEncryptionKey(key);
+        cipher.setIV(iv);
+        cipher.reset();
+        VirgilByteArray encryptedData;
+        for (size_t offset = 0; offset < plainData.size(); offset += 144) {
+            const size_t partSize = std::min<size_t>(144, plainData.size() - offset);
+            virgil::crypto::bytes_append(encryptedData, cipher.update(
+                    VirgilByteArray(plainData.begin() + offset, plainData.begin() + offset + partSize)));
+        }
+        virgil::crypto::bytes_append(encryptedData, cipher.finish());
+
+        // Decrypt at once
+        VirgilSymmetricCipher decipher(algorithm);
+        decipher.setDecryptionKey(key);
+        REQUIRE(decipher.crypt(encryptedData, iv) == plainData);
+        REQUIRE(cipher.crypt(plainData, iv) == encryptedData);
+    }
 }
@@ -41,6 +41,7 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 #include <virgil/crypto/VirgilByteArray.h>
@@ -72,4 +73,18 @@ TEST_CASE("Get TAG", "[tag-filter]") {
         REQUIRE(kTagLen == tagFilter.tag().size());
         REQUIRE(VirgilByteArrayUtils::bytesToHex(tagFilter.tag()) == "2ccda65f87808b4dcdfebd970b881e95");
     }
+    SECTION("Case 3: caller-provided output") {
+        VirgilByteArray data = VirgilByteArrayUtils::hexToBytes(
+                "11111111111111301204102ccda65f87808b4dcdfebd970b881e95");
+        VirgilByteArray out(data.size());
+        size_t outLen = 0;
+        tagFilter.reset(kTagLen);
+        for (size_t pos = 0; pos < data.size(); pos += 5) {
+            const size_t len = std::min(size_t(5), data.size() - pos);
+            outLen += tagFilter.process(data.data() + pos, len, out.data() + outLen);
+        }
+        out.resize(outLen);
+        REQUIRE(VirgilByteArrayUtils::bytesToHex(out) == "1111111111111130120410");
+        REQUIRE(VirgilByteArrayUtils::bytesToHex(tagFilter.tag()) == "2ccda65f87808b4dcdfebd970b881e95");
+    }
 }
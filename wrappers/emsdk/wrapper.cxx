@@ -164,6 +164,7 @@ EMSCRIPTEN_BINDINGS(virgil_crypto) {
         .class_function("hasFeatureStreamImpl", &VirgilConfig::hasFeatureStreamImpl)
         .class_function("hasFeaturePythiaImpl", &VirgilConfig::hasFeaturePythiaImpl)
         .class_function("hasFeaturePythiaMultiThread", &VirgilConfig::hasFeaturePythiaMultiThread)
+        .class_function("hasFeatureMultiThread", &VirgilConfig::hasFeatureMultiThread)
     ;
 
     register_vector<unsigned char>("VirgilByteArray")
@@ -218,7 +219,8 @@ EMSCRIPTEN_BINDINGS(virgil_crypto) {
     ;
 
     class_<VirgilCipherBase>("VirgilCipherBase")
-        .function("addKeyRecipient", &VirgilCipherBase::addKeyRecipient)
+        .function("addKeyRecipient", select_overload<void(const VirgilByteArray&, const VirgilByteArray&)>(
+                &VirgilCipherBase::addKeyRecipient))
         .function("removeKeyRecipient", &VirgilCipherBase::removeKeyRecipient)
         .function("keyRecipientExists", &VirgilCipherBase::keyRecipientExists)
         .function("addPasswordRecipient", &VirgilCipherBase::addPasswordRecipient)
@@ -233,8 +235,10 @@ EMSCRIPTEN_BINDINGS(virgil_crypto) {
 
     class_<VirgilCipher, base<VirgilCipherBase>>("VirgilCipher")
         .constructor<>()
-        .function("encrypt", &VirgilCipher::encrypt)
-        .function("decryptWithKey", &VirgilCipher::decryptWithKey)
+        .function("encrypt", select_overload<VirgilByteArray(const VirgilByteArray&, bool)>(&VirgilCipher::encrypt))
+        .function("defineEncryptedSize", &VirgilCipher::defineEncryptedSize)
+        .function("decryptWithKey", select_overload<VirgilByteArray(const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)>(
+                &VirgilCipher::decryptWithKey))
         .function("decryptWithPassword", &VirgilCipher::decryptWithPassword)
     ;
 
@@ -324,24 +328,27 @@ EMSCRIPTEN_BINDINGS(virgil_crypto) {
     class_<VirgilStreamCipher, base<VirgilCipherBase>>("VirgilStreamCipher")
         .constructor<>()
         .function("encrypt", &VirgilStreamCipher::encrypt)
-        .function("decryptWithKey", &VirgilStreamCipher::decryptWithKey)
+        .function("decryptWithKey", select_overload<void(VirgilDataSource&, VirgilDataSink&, const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)>(
+                &VirgilStreamCipher::decryptWithKey))
         .function("decryptWithPassword", &VirgilStreamCipher::decryptWithPassword)
     ;
 
     class_<VirgilChunkCipher, base<VirgilCipherBase>>("VirgilChunkCipher")
         .constructor<>()
         .function("encrypt", &VirgilChunkCipher::encrypt)
-        .function("decryptWithKey", &VirgilChunkCipher::decryptWithKey)
+        .function("decryptWithKey", select_overload<void(VirgilDataSource&, VirgilDataSink&, const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)>(
+                &VirgilChunkCipher::decryptWithKey))
         .function("decryptWithPassword", &VirgilChunkCipher::decryptWithPassword)
     ;
 
     class_<VirgilSeqCipher, base<VirgilCipherBase>>("VirgilSeqCipher")
         .constructor<>()
         .function("startEncryption", &VirgilSeqCipher::startEncryption)
-        .function("startDecryptionWithKey", &VirgilSeqCipher::startDecryptionWithKey)
+        .function("startDecryptionWithKey", select_overload<void(const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)>(
+                &VirgilSeqCipher::startDecryptionWithKey))
         .function("startDecryptionWithPassword", &VirgilSeqCipher::startDecryptionWithPassword)
-        .function("process", &VirgilSeqCipher::process)
-        .function("finish", &VirgilSeqCipher::finish)
+        .function("process", select_overload<VirgilByteArray(const VirgilByteArray&)>(&VirgilSeqCipher::process))
+        .function("finish", select_overload<VirgilByteArray()>(&VirgilSeqCipher::finish))
     ;
 }
 
@@ -438,8 +445,8 @@ EMSCRIPTEN_BINDINGS(virgil_crypto_foundation) {
         .function("setPadding", &VirgilSymmetricCipher::setPadding)
         .function("reset", &VirgilSymmetricCipher::reset)
         .function("clear", &VirgilSymmetricCipher::clear)
-        .function("update", &VirgilSymmetricCipher::update)
-        .function("finish", &VirgilSymmetricCipher::finish)
+        .function("update", select_overload<VirgilByteArray(const VirgilByteArray&)>(&VirgilSymmetricCipher::update))
+        .function("finish", select_overload<VirgilByteArray()>(&VirgilSymmetricCipher::finish))
     ;
 
 
@@ -456,6 +463,7 @@ EMSCRIPTEN_BINDINGS(virgil_crypto_foundation) {
         .value("AES_128_GCM", VirgilSymmetricCipher::Algorithm::AES_128_GCM)
         .value("AES_256_CBC", VirgilSymmetricCipher::Algorithm::AES_256_CBC)
         .value("AES_256_GCM", VirgilSymmetricCipher::Algorithm::AES_256_GCM)
+        .value("CHACHA20_POLY1305", VirgilSymmetricCipher::Algorithm::CHACHA20_POLY1305)
     ;
 
     class_<VirgilAsymmetricCipher>("VirgilAsymmetricCipher")
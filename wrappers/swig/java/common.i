@@ -36,6 +36,7 @@
 
 %javaexception("java.io.IOException") virgil::crypto::VirgilDataSource::hasData {}
 %javaexception("java.io.IOException") virgil::crypto::VirgilDataSource::read {}
+%javaexception("java.io.IOException") virgil::crypto::VirgilRandomAccessDataSource::read {}
 %javaexception("java.io.IOException") virgil::crypto::VirgilDataSink::write {}
 %javaexception("java.io.IOException") virgil::crypto::VirgilDataSink::isGood {}
 
@@ -60,6 +61,13 @@ import com.virgilsecurity.crypto.JniLoader;
   }
 %}
 
+%typemap(javacode) virgil::crypto::VirgilRandomAccessDataSource %{
+  @Override
+  public void close() throws java.io.IOException {
+    delete();
+  }
+%}
+
 %typemap(javacode) virgil::crypto::VirgilDataSink %{
   @Override
   public void close() throws java.io.IOException {